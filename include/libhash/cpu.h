@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       cpu.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-23
+//
+// Description
+// Runtime detection of the CPU features used to select the hashing kernels.
+//=============================================================================
+
+#ifndef __LH_CPU_H00__
+#    define __LH_CPU_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include <stddef.h>
+#    include "defs.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+/** SSSE3 (<tt>pshufb</tt>). */
+#    define HASH_CPU_SSSE3      0x0001
+
+/** SSE4.1. */
+#    define HASH_CPU_SSE41      0x0002
+
+/** SSE4.2 (<tt>crc32</tt> instruction). */
+#    define HASH_CPU_SSE42      0x0004
+
+/** Carry-less multiplication (PCLMULQDQ). */
+#    define HASH_CPU_PCLMUL     0x0008
+
+/** AVX, enabled by the operating system. */
+#    define HASH_CPU_AVX        0x0010
+
+/** AVX2. */
+#    define HASH_CPU_AVX2       0x0020
+
+/** BMI2 (<tt>rorx</tt>, <tt>shlx</tt>, ...). */
+#    define HASH_CPU_BMI2       0x0040
+
+/** SHA extensions (SHA-NI). */
+#    define HASH_CPU_SHA        0x0080
+
+/** AVX-512 F, BW and VL, enabled by the operating system. */
+#    define HASH_CPU_AVX512     0x0100
+
+/** VPCLMULQDQ on 512-bits registers (requires HASH_CPU_AVX512). */
+#    define HASH_CPU_VPCLMUL    0x0200
+
+/**
+ * AVX-512 without a significant clock drop (requires HASH_CPU_AVX512): the CPUs with
+ * VPCLMULQDQ (Ice Lake and later, Zen 4), unlike the first AVX-512 CPUs (Skylake-SP).
+ */
+#    define HASH_CPU_AVX512_FAST 0x0400
+
+/** Features of the <tt>sse4</tt> tier. */
+#    define HASH_CPU_TIER_SSE4   ( HASH_CPU_SSSE3 | HASH_CPU_SSE41 | HASH_CPU_SSE42 | HASH_CPU_PCLMUL | HASH_CPU_SHA )
+
+/** Features of the <tt>avx2</tt> tier. */
+#    define HASH_CPU_TIER_AVX2   ( HASH_CPU_TIER_SSE4 | HASH_CPU_AVX | HASH_CPU_AVX2 | HASH_CPU_BMI2 )
+
+/** Features of the <tt>avx512</tt> tier. */
+#    define HASH_CPU_TIER_AVX512 ( HASH_CPU_TIER_AVX2 | HASH_CPU_AVX512 | HASH_CPU_VPCLMUL | HASH_CPU_AVX512_FAST )
+
+/** Name of the environment variable restricting the CPU features. */
+#    define HASH_CPU_ENV        "LIBHASH_CPU"
+
+/** Name of the environment variable enabling the calibration of the kernels. */
+#    define HASH_CALIBRATE_ENV  "LIBHASH_CALIBRATE"
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+namespace libhash {
+
+/**
+ * @brief CPU features available to the hashing kernels.
+ *
+ * The features are probed once with <tt>cpuid</tt>, the first time they are requested.
+ * Each algorithm binds its kernels to function pointers when the library is loaded, so
+ * the selection costs nothing per call. The active kernel of a hashing object is given by
+ * HashingBase::getKernel().
+ *
+ * The environment variable <tt>LIBHASH_CPU</tt> restricts the features used by the
+ * library. It is a comma separated list of:
+ * - a tier: <tt>generic</tt> (no SIMD), <tt>sse4</tt>, <tt>avx2</tt> or <tt>avx512</tt>;
+ * - a feature prefixed with <tt>-</tt> to disable it: <tt>-ssse3</tt>, <tt>-sse4.1</tt>,
+ *   <tt>-sse4.2</tt>, <tt>-pclmul</tt>, <tt>-avx</tt>, <tt>-avx2</tt>, <tt>-bmi2</tt>,
+ *   <tt>-sha</tt>, <tt>-avx512</tt>, <tt>-vpclmul</tt> or <tt>-avx512fast</tt>.
+ *   <tt>-avx</tt> and <tt>-avx2</tt> also disable AVX-512, which is only used on top of
+ *   them. <tt>-avx512fast</tt> keeps the AVX-512 CRC folding but moves the multi-buffer
+ *   batches back to the AVX2 lanes, as on the CPUs whose clock drops with AVX-512.
+ *
+ * For example, <tt>LIBHASH_CPU=avx2</tt> avoids the AVX-512 kernels and the frequency drop
+ * they cause on some CPUs. The override never enables a feature the CPU does not have.
+ *
+ * The CPU features do not tell which kernel is the fastest for a given buffer size. When
+ * the environment variable <tt>LIBHASH_CALIBRATE</tt> is set, the algorithms measure their
+ * kernels on a few buffer sizes the first time they get a buffer large enough for them,
+ * and use each one from the size where it wins: the CRC folding kernels by buffer size and
+ * the multi-buffer kernels of the batch APIs by mean message size. The single stream
+ * kernels (e.g. SHA-NI or AVX2 for SHA-256) are not measured: they follow the CPU features.
+ * The calibration only chooses among the kernels <tt>LIBHASH_CPU</tt> allows, so the
+ * AVX-512 multi-buffer kernels still require <tt>avx512fast</tt>. With
+ * <tt>LIBHASH_CALIBRATE=1</tt>, every process calibrates. Any other value is the path of a
+ * cache file: the decisions are read from it, or measured and stored in it if it is
+ * missing or was made with other CPU features.
+ *
+ * @author Yanick Poirier (2019/11/23)
+ */
+class LIBHASH_API CPU {
+public:
+    static uint32_t getDetected( );
+    static uint32_t getFeatures( );
+    static uint32_t restrict( uint32_t, const char * );
+
+    /**
+     * @brief Checks if all the specified features can be used.
+     *
+     * @param features  HASH_CPU_* flags.
+     *
+     * @return <tt>true</tt> if all features are available and not disabled.
+     */
+    static inline bool has( uint32_t features ) {
+        return ( getFeatures( ) & features ) == features;
+    }
+
+private:
+    CPU( );
+
+} ; // class CPU
+
+};  // namespace libhash
+
+#    endif  // __cplusplus
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+uint32_t LIBHASH_API hash_cpu_get_detected( );
+uint32_t LIBHASH_API hash_cpu_get_features( );
+
+#    ifdef __cplusplus
+}   // extern "C"
+#    endif
+
+#endif   // __LH_CPU_H00__
+
+// EOF: cpu.h
@@ -0,0 +1,443 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-09
+//
+// Description
+// Generic CRC engine parameterized at compile time.
+//=============================================================================
+
+#ifndef __LH_CRC_H00__
+#    define __LH_CRC_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include <stddef.h>
+#    include "defs.h"
+#    include "hashbase.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+namespace libhash {
+
+/**
+ * @brief Maps a CRC width to its base class and register type.
+ *
+ * Each width supported by the Crc template provides a specialization with:
+ * - <tt>Base</tt>: the CRCBaseT instantiation of the width (e.g. CRC32Base) providing
+ *   the Rocksoft model state, combine() and updateParallel();
+ * - <tt>Register</tt>: the unsigned integer type holding the CRC register.
+ *
+ * The specializations are declared in the header of each width (crc8.h to crc64.h).
+ */
+template<int Width>
+struct CRCTraits;
+
+/**
+ * @brief Hardware accelerated kernels of a CRC width.
+ *
+ * The widths with kernels (16, 32 and 64 bits) specialize it in their header, before
+ * instantiating CRCBaseT. The others leave the whole buffer to the lookup tables.
+ *
+ * @tparam Register     Unsigned type of the CRC register.
+ * @tparam Width        Number of bits of the CRC.
+ */
+template<typename Register, int Width>
+struct CRCAccelerator {
+    /**
+     * @brief Processes the bulk of a buffer with a hardware accelerated kernel.
+     *
+     * @param polynomial    CRC polynomial in normal form.
+     * @param reflected     Input reflected flag.
+     * @param state         Current CRC register. Updated with the processed bytes.
+     * @param buffer        Data to process.
+     * @param size          Number of bytes in <tt>buffer</tt>
+     *
+     * @return the number of bytes processed; the remaining bytes are processed with the
+     *         lookup tables.
+     */
+    static inline size_t accelerate( Register polynomial, bool reflected, Register &state, const uint8_t *buffer, size_t size ) {
+        (void) polynomial;
+        (void) reflected;
+        (void) state;
+        (void) buffer;
+        (void) size;
+
+        return 0;
+    }
+
+    /**
+     * @brief Retrieves the name of the kernel used by accelerate() on large buffers.
+     *
+     * @param polynomial    CRC polynomial in normal form.
+     * @param reflected     Input reflected flag.
+     *
+     * @return the kernel name or <tt>NULL</tt> if the polynomial is not accelerated.
+     */
+    static inline const char *getName( Register polynomial, bool reflected ) {
+        (void) polynomial;
+        (void) reflected;
+
+        return NULL;
+    }
+} ;
+
+/**
+ * @brief Base class of the CRCs of a given width.
+ *
+ * It holds the Rocksoft model state and everything that does not depend on the lookup
+ * tables: init, finalize, combine, updateParallel and updateFile. Register arithmetic is
+ * done on <tt>Width</tt> bits, so a 24-bits CRC uses a <tt>uint32_t</tt> register whose
+ * top 8 bits are always 0.
+ *
+ * Each supported width instantiates it once in the library (e.g. CRC32Base is
+ * <tt>CRCBaseT<uint32_t, 32></tt>) and maps itself to it with a CRCTraits
+ * specialization. The widths with hardware accelerated kernels specialize
+ * CRCAccelerator.
+ *
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the CRC is computed in the reflected domain (right-shifting register) so
+ * no data byte needs to be reflected.
+ *
+ * @tparam Register     Unsigned type of the CRC register.
+ * @tparam Width        Number of bits of the CRC.
+ *
+ * @see Crc
+ */
+template<typename Register, int Width>
+class CRCBaseT : public CRCBase {
+public:
+    CRCBaseT( Register, Register, Register, bool, bool );
+    virtual ~CRCBaseT( );
+
+    virtual void init( );
+    virtual void update( const void *, size_t );
+    virtual void finalize( );
+    virtual const char *getKernel( );
+
+    void updateParallel( const void *, size_t, unsigned = 0 );
+    bool updateFile( int );
+    Register combine( Register, Register, size_t );
+
+    /**
+     * @copydoc CRCAccelerator::accelerate()
+     */
+    static inline size_t accelerate( Register polynomial, bool reflected, Register &state, const uint8_t *buffer, size_t size ) {
+        return CRCAccelerator<Register, Width>::accelerate( polynomial, reflected, state, buffer, size );
+    }
+
+    /**
+     * @copydoc CRCAccelerator::getName()
+     */
+    static inline const char *getAccelerator( Register polynomial, bool reflected ) {
+        return CRCAccelerator<Register, Width>::getName( polynomial, reflected );
+    }
+
+    /**
+     * Retrieves the value that will be XOR'ed with the final CRC.
+     *
+     * @return value to be XOR'ed
+     */
+    inline Register getXorValue( ) {
+        return mXorValue;
+    }
+
+    /**
+     * Retrieves the polynomial used by this CRC.
+     *
+     * @return CRC's polynomial
+     */
+    inline Register getPolynomial( ) {
+        return mPolynomial;
+    }
+
+    /**
+     * Retrieves the CRC's initial value.
+     *
+     * @return CRC's initial value.
+     */
+    inline Register getInitialValue( ) {
+        return mInit;
+    }
+
+protected:
+    /**
+     * @brief Processes data from a given CRC register.
+     *
+     * Derived classes implement it with their fastest kernel. It must not modify the
+     * object so it can be called concurrently by updateParallel().
+     *
+     * @param state     CRC register to start from.
+     * @param data      Data to process.
+     * @param size      Number of bytes in <tt>data</tt>
+     *
+     * @return the updated CRC register.
+     */
+    virtual Register process( Register state, const void *data, size_t size ) = 0;
+
+    /**
+     * @brief Returns the reflected <tt>Width</tt>-bits value of the specified value.
+     *
+     * @param value Initial value.
+     *
+     * @return the reflected value.
+     */
+    inline Register reflectRegister( Register value ) {
+        return (Register) ( reflect( value ) >> ( sizeof ( Register ) * 8 - Width ) );
+    }
+
+    Register shift( Register, size_t );
+    Register multiplyModulo( Register, Register );
+    Register powerModulo( size_t );
+
+    /** Current hashing state. */
+    Register    mState;
+
+private:
+    Register mInit;
+    Register mPolynomial;
+    Register mXorValue;
+} ; // class CRCBaseT
+
+/**
+ * @brief Slicing-by-16 lookup tables of a CRC, generated at compile time.
+ *
+ * The first table is the classic byte-at-a-time table. Table <tt>k</tt> gives the CRC of
+ * a byte followed by <tt>k</tt> zero bytes. If the input is reflected, the tables are
+ * built with the reversed polynomial for a right-shifting register.
+ *
+ * @tparam Register     Unsigned type of the CRC register.
+ * @tparam Width        Number of bits of the CRC.
+ * @tparam Poly         CRC polynomial in normal form (without the x^Width term).
+ * @tparam RefIn        Input reflected flag.
+ */
+template<typename Register, int Width, uint64_t Poly, bool RefIn>
+struct CRCTable {
+    /** Lookup tables. */
+    Register    lookup[ 16 ][ 256 ];
+
+    /**
+     * @brief Builds the lookup tables.
+     */
+    constexpr CRCTable( ) : lookup( ) {
+        const Register mask = (Register) ~(Register) 0 >> ( sizeof ( Register ) * 8 - Width );
+        const Register top = (Register) 1 << ( Width - 1 );
+        Register reversed = 0;
+
+        for( int i = 0; i < Width; i++ ) {
+            reversed |= (Register) ( ( Poly >> i ) & 1 ) << ( Width - 1 - i );
+        }
+
+        for( unsigned n = 0; n < 256; n++ ) {
+            Register remainder = RefIn ? (Register) n : (Register) ( (Register) n << ( Width - 8 ) );
+
+            for( int i = 0; i < 8; i++ ) {
+                if( RefIn ) {
+                    remainder = ( remainder & 1 ) ? ( remainder >> 1 ) ^ reversed : remainder >> 1;
+                }
+                else {
+                    remainder = ( ( remainder & top ) ? ( remainder << 1 ) ^ Poly : remainder << 1 ) & mask;
+                }
+            }
+
+            lookup[ 0 ][ n ] = remainder;
+        }
+
+        for( unsigned n = 0; n < 256; n++ ) {
+            Register remainder = lookup[ 0 ][ n ];
+
+            for( int k = 1; k < 16; k++ ) {
+                if( RefIn ) {
+                    remainder = lookup[ 0 ][ remainder & 0xff ] ^ ( remainder >> 8 );
+                }
+                else {
+                    remainder = lookup[ 0 ][ ( remainder >> ( Width - 8 ) ) & 0xff ] ^ ( ( remainder << 8 ) & mask );
+                }
+
+                lookup[ k ][ n ] = remainder;
+            }
+        }
+    }
+} ;
+
+/**
+ * @brief Holds the single instance of a set of lookup tables.
+ *
+ * CRC variants sharing the same polynomial and input reflection (e.g. CRC16_CCITT and
+ * CRC16_XModem) share the same tables.
+ */
+template<typename Register, int Width, uint64_t Poly, bool RefIn>
+struct CRCLookup {
+    /** Lookup tables, stored in read-only data. */
+    static constexpr CRCTable<Register, Width, Poly, RefIn> msTable = CRCTable<Register, Width, Poly, RefIn>( );
+} ;
+
+template<typename Register, int Width, uint64_t Poly, bool RefIn>
+constexpr CRCTable<Register, Width, Poly, RefIn> CRCLookup<Register, Width, Poly, RefIn>::msTable;
+
+/**
+ * @brief Generic CRC following the Rocksoft model, with all parameters known at compile
+ * time.
+ *
+ * The compiler specializes the table loop for each instantiation: the reflection and the
+ * register width are constants so there is no runtime branch on them. Any catalogued CRC
+ * of a supported width can be instantiated, for example:
+ *
+ * <pre>
+ * typedef Crc<16, 0x8005, 0xffff, 0x0000, true, true> CRC16_Modbus;
+ * typedef Crc<32, 0x04c11db7, 0xffffffff, 0x00000000, false, false> CRC32_MPEG2;
+ * </pre>
+ *
+ * The state handling (init, finalize, combine, updateParallel) is inherited from the base
+ * class of the width. The base class may also process the bulk of the data with a hardware
+ * accelerated kernel for some polynomials.
+ *
+ * @tparam Width        Number of bits of the CRC. A CRCTraits specialization must exist.
+ * @tparam Poly         CRC polynomial in normal form (without the x^Width term).
+ * @tparam Init         Initial value of the register.
+ * @tparam XorOut       Value XOR'ed with the final register.
+ * @tparam RefIn        Input reflected flag.
+ * @tparam RefOut       Output reflected flag.
+ */
+template<int Width, uint64_t Poly, uint64_t Init, uint64_t XorOut, bool RefIn, bool RefOut>
+class Crc : public CRCTraits<Width>::Base {
+public:
+    /** Base class of the CRC width. */
+    typedef typename CRCTraits<Width>::Base Base;
+
+    /** Unsigned type of the CRC register. */
+    typedef typename CRCTraits<Width>::Register Register;
+
+    /**
+     * @brief Constructor
+     */
+    Crc( ) : Base( (Register) Init, (Register) Poly, (Register) XorOut, RefIn, RefOut ) { }
+
+    virtual ~Crc( ) { }
+
+protected:
+    /**
+     * @copydoc CRCBaseT::process( Register, const void *, size_t )
+     */
+    virtual Register process( Register state, const void *data, size_t size ) {
+        const uint8_t *buffer = (const uint8_t *) data;
+        size_t done = Base::accelerate( (Register) Poly, RefIn, state, buffer, size );
+
+        return compute( state, buffer + done, size - done );
+    }
+
+    /**
+     * @brief Retrieves the byte of the CRC register that is combined with a data byte.
+     *
+     * The byte order follows the direction of the register: the low byte comes first when
+     * the input is reflected, the high byte otherwise. Bytes past the register width are 0.
+     * Since <tt>index</tt> is a constant at every call, this folds to a single shift.
+     *
+     * @param crc       CRC register.
+     * @param index     Position of the data byte in the block being processed.
+     *
+     * @return the register byte.
+     */
+    static inline uint8_t registerByte( Register crc, int index ) {
+        if( index >= Width / 8 ) {
+            return 0;
+        }
+
+        return (uint8_t) ( RefIn ? crc >> ( 8 * index ) : crc >> ( Width - 8 - 8 * index ) );
+    }
+
+    /**
+     * @brief Computes the CRC with the lookup tables.
+     *
+     * The bulk of the data is processed 16 bytes at a time (slicing-by-16). Only the last
+     * few bytes are processed one at a time.
+     *
+     * @param crc       CRC register to start from.
+     * @param buffer    Data to process.
+     * @param size      Number of bytes in <tt>buffer</tt>
+     *
+     * @return the updated CRC register.
+     */
+    static Register compute( Register crc, const uint8_t *buffer, size_t size ) {
+        const Register ( *lookup )[ 256 ] = CRCLookup<Register, Width, Poly, RefIn>::msTable.lookup;
+        const Register mask = (Register) ~(Register) 0 >> ( sizeof ( Register ) * 8 - Width );
+
+        while( size >= 16 ) {
+            crc = lookup[ 15 ][ buffer[ 0 ] ^ registerByte( crc, 0 ) ] ^
+                    lookup[ 14 ][ buffer[ 1 ] ^ registerByte( crc, 1 ) ] ^
+                    lookup[ 13 ][ buffer[ 2 ] ^ registerByte( crc, 2 ) ] ^
+                    lookup[ 12 ][ buffer[ 3 ] ^ registerByte( crc, 3 ) ] ^
+                    lookup[ 11 ][ buffer[ 4 ] ^ registerByte( crc, 4 ) ] ^
+                    lookup[ 10 ][ buffer[ 5 ] ^ registerByte( crc, 5 ) ] ^
+                    lookup[ 9 ][ buffer[ 6 ] ^ registerByte( crc, 6 ) ] ^
+                    lookup[ 8 ][ buffer[ 7 ] ^ registerByte( crc, 7 ) ] ^
+                    lookup[ 7 ][ buffer[ 8 ] ^ registerByte( crc, 8 ) ] ^
+                    lookup[ 6 ][ buffer[ 9 ] ^ registerByte( crc, 9 ) ] ^
+                    lookup[ 5 ][ buffer[ 10 ] ^ registerByte( crc, 10 ) ] ^
+                    lookup[ 4 ][ buffer[ 11 ] ^ registerByte( crc, 11 ) ] ^
+                    lookup[ 3 ][ buffer[ 12 ] ^ registerByte( crc, 12 ) ] ^
+                    lookup[ 2 ][ buffer[ 13 ] ^ registerByte( crc, 13 ) ] ^
+                    lookup[ 1 ][ buffer[ 14 ] ^ registerByte( crc, 14 ) ] ^
+                    lookup[ 0 ][ buffer[ 15 ] ^ registerByte( crc, 15 ) ];
+
+            buffer += 16;
+            size -= 16;
+        }
+
+        while( size-- ) {
+            if( RefIn ) {
+                crc = lookup[ 0 ][ ( crc ^ *buffer ) & 0xff ] ^ ( crc >> 8 );
+            }
+            else {
+                crc = lookup[ 0 ][ ( ( crc >> ( Width - 8 ) ) ^ *buffer ) & 0xff ] ^ ( ( crc << 8 ) & mask );
+            }
+
+            buffer++;
+        }
+
+        return crc;
+    }
+} ;  // class Crc
+
+};  // namespace libhash
+
+#    endif  // __cplusplus
+
+#endif   // __LH_CRC_H00__
+
+// EOF: crc.h
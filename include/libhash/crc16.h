@@ -35,6 +35,8 @@
 // HEADER FILES
 //-----------------------------------------------------------------------------
 
+#    include "crc.h"
+
 //-----------------------------------------------------------------------------
 // CONSTANTS & MACROS
 //-----------------------------------------------------------------------------
@@ -57,139 +59,90 @@
 #    ifdef __cplusplus
 namespace libhash {
 
+/**
+ * @brief CRC-16 hardware accelerated kernels.
+ */
+template<>
+struct LIBHASH_API CRCAccelerator<uint16_t, 16> {
+    static size_t accelerate( uint16_t, bool, uint16_t &, const uint8_t *, size_t );
+    static const char *getName( uint16_t, bool );
+} ;
+
 /**
  * @brief Base class for all CRC-16 based algorithm.
  *
- * Note: All derived classes must used the reverse polynomial in order to create the
- * correct lookup tables.
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the lookup table is built from the reversed polynomial and the CRC is
+ * computed in the reflected domain (right-shifting register) so no data byte needs to be
+ * reflected.
+ *
+ * @see Crc
  */
-class LIBHASH_API CRC16Base : public CRCBase {
-public:
-    CRC16Base( uint16_t, uint16_t, uint16_t, bool, bool );
-    virtual ~CRC16Base( );
-
-    virtual void init( );
-    virtual void finalize( );
-
-    /**
-     * Retrieves the value that will be XOR'ed with the final CRC.
-     *
-     * @return value to be XOR'ed
-     */
-    inline uint16_t getXorValue( ) {
-        return mXorValue;
-    }
-
-    /**
-     * Retrieves the polynomial used by this CRC.
-     *
-     * @return CRC's polynomial
-     */
-    inline uint16_t getPolynomial( ) {
-        return mPolynomial;
-    }
-
-    /**
-     * Retrieves the CRC's initial value.
-     *
-     * @return CRC's initial value.
-     */
-    inline uint16_t getInitialValue( ) {
-        return mInit;
-    }
-
-protected:
-    void update( uint16_t *, const void *, size_t );
-    void initLookupTable( uint16_t * );
-
-    /** Current hashing state. */
-    uint16_t    mState;
-
-private:
-    uint16_t mInit;
-    uint16_t mPolynomial;
-    uint16_t mXorValue;
-} ; // class CRC16Base
+typedef CRCBaseT<uint16_t, 16> CRC16Base;
+
+extern template class LIBHASH_API CRCBaseT<uint16_t, 16>;
+
+/**
+ * @brief CRC-16 specialization of the generic CRC engine.
+ */
+template<>
+struct CRCTraits<16> {
+    typedef CRC16Base   Base;
+    typedef uint16_t    Register;
+} ;
 
 /**
  * @brief CRC16-CCITT algorithm.
  *
  * It provides a 16-bits hash fingerprint. It is sometimes called CRC-16 CCITT-FALSE
  *
- * Note: The first time a CRC-16 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation.
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by the carry-less
+ * multiplication folding of the CRC-32, with the polynomial widened to 32 bits.
+ *
+ * Note: The 16 slicing tables (8KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-16 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2019/11/09)
  *
  * @see CRC16_X25
  */
-class LIBHASH_API CRC16_CCITT : public CRC16Base {
-public:
-    CRC16_CCITT( );
-    virtual ~CRC16_CCITT( );
-
-    virtual void update( const void *data, size_t size );
-
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint16_t msLookup[ 256 ];
-    static bool msTableInit;
-} ;  // class CRC16_CCITT
+typedef Crc<16, 0x1021, 0xffff, 0x0000, false, false> CRC16_CCITT;
 
 /**
  * @brief CRC16-XModem algorithm.
  *
  * It provides a 16-bits hash fingerprint. It is sometimes called CRC-16 CCITT-ZERO
  *
- * Note: The first time a CRC-16 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation.
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by the carry-less
+ * multiplication folding of the CRC-32, with the polynomial widened to 32 bits.
+ *
+ * Note: The 16 slicing tables (8KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-16 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2019/11/09)
  *
  * @see CRC16_X25
  */
-class LIBHASH_API CRC16_XModem : public CRC16Base {
-public:
-    CRC16_XModem( );
-    virtual ~CRC16_XModem( );
-
-    virtual void update( const void *data, size_t size );
-
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint16_t msLookup[ 256 ];
-    static bool msTableInit;
-} ;  // class CRC16_XModem
+typedef Crc<16, 0x1021, 0x0000, 0x0000, false, false> CRC16_XModem;
 
 /**
  * @brief A CRC16-X25 implementation.
  *
- * Note: The first time a CRC-16 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation.
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by the carry-less
+ * multiplication folding of the CRC-32, with the polynomial widened to 32 bits.
+ *
+ * Note: The 16 slicing tables (8KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-16 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2019/11/09)
  *
  * @see CRC32
  */
-class LIBHASH_API CRC16_X25 : public CRC16Base {
-public:
-    CRC16_X25( );
-    virtual ~CRC16_X25( );
-
-    virtual void update( const void *data, size_t size );
-
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint16_t msLookup[ 256 ];
-    static bool msTableInit;
+typedef Crc<16, 0x1021, 0xffff, 0xffff, true, true> CRC16_X25;
 
-} ;  // class CRC16_X25
+extern template class LIBHASH_API Crc<16, 0x1021, 0xffff, 0x0000, false, false>;
+extern template class LIBHASH_API Crc<16, 0x1021, 0x0000, 0x0000, false, false>;
+extern template class LIBHASH_API Crc<16, 0x1021, 0xffff, 0xffff, true, true>;
 
 };  // namespace libhash
 
@@ -207,22 +160,28 @@ extern "C" {
 void LIBHASH_API* hash_crc16_ccitt_create( );
 int LIBHASH_API hash_crc16_ccitt_init( void *h );
 int LIBHASH_API hash_crc16_ccitt_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc16_ccitt_update_parallel( void *h, void *buf, size_t len, unsigned threads );
 int LIBHASH_API hash_crc16_ccitt_finalize( void *h );
 int LIBHASH_API hash_crc16_ccitt_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc16_ccitt_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB );
 int LIBHASH_API hash_crc16_ccitt_destroy( void *h );
 
 void LIBHASH_API* hash_crc16_xmodem_create( );
 int LIBHASH_API hash_crc16_xmodem_init( void *h );
 int LIBHASH_API hash_crc16_xmodem_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc16_xmodem_update_parallel( void *h, void *buf, size_t len, unsigned threads );
 int LIBHASH_API hash_crc16_xmodem_finalize( void *h );
 int LIBHASH_API hash_crc16_xmodem_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc16_xmodem_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB );
 int LIBHASH_API hash_crc16_xmodem_destroy( void *h );
 
 void LIBHASH_API* hash_crc16_x25_create( );
 int LIBHASH_API hash_crc16_x25_init( void *h );
 int LIBHASH_API hash_crc16_x25_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc16_x25_update_parallel( void *h, void *buf, size_t len, unsigned threads );
 int LIBHASH_API hash_crc16_x25_finalize( void *h );
 int LIBHASH_API hash_crc16_x25_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc16_x25_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB );
 int LIBHASH_API hash_crc16_x25_destroy( void *h );
 
 #    ifdef __cplusplus
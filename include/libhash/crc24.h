@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc24.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-10
+//
+// Description
+// CRC-24 base class of the generic CRC engine.
+//=============================================================================
+
+#ifndef __LH_CRC24_H00__
+#    define __LH_CRC24_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include "crc.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+namespace libhash {
+
+/**
+ * @brief Base class for all CRC-24 based algorithm.
+ *
+ * The register is a <tt>uint32_t</tt> whose top 8 bits are always 0: every operation masks
+ * it to 24 bits.
+ *
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the lookup table is built from the reversed polynomial and the CRC is
+ * computed in the reflected domain (right-shifting register) so no data byte needs to be
+ * reflected. There is no hardware accelerated kernel: the CRC-24 variants are computed
+ * with the slicing-by-16 tables, for example:
+ *
+ * <pre>
+ * typedef Crc<24, 0x864cfb, 0xb704ce, 0x000000, false, false> CRC24_OpenPGP;
+ * typedef Crc<24, 0x00065b, 0x555555, 0x000000, true, true> CRC24_BLE;
+ * </pre>
+ *
+ * @see Crc
+ */
+typedef CRCBaseT<uint32_t, 24> CRC24Base;
+
+extern template class LIBHASH_API CRCBaseT<uint32_t, 24>;
+
+/**
+ * @brief CRC-24 specialization of the generic CRC engine.
+ */
+template<>
+struct CRCTraits<24> {
+    typedef CRC24Base   Base;
+    typedef uint32_t    Register;
+} ;
+
+};  // namespace libhash
+
+#    endif  // __cplusplus
+
+#endif   // __LH_CRC24_H00__
+
+// EOF: crc24.h
@@ -35,6 +35,8 @@
 // HEADER FILES
 //-----------------------------------------------------------------------------
 
+#    include "crc.h"
+
 //-----------------------------------------------------------------------------
 // CONSTANTS & MACROS
 //-----------------------------------------------------------------------------
@@ -57,154 +59,92 @@
 #    ifdef __cplusplus
 namespace libhash {
 
+/**
+ * @brief CRC-32 hardware accelerated kernels.
+ */
+template<>
+struct LIBHASH_API CRCAccelerator<uint32_t, 32> {
+    static size_t accelerate( uint32_t, bool, uint32_t &, const uint8_t *, size_t );
+    static const char *getName( uint32_t, bool );
+} ;
+
 /**
  * @brief Base class for all CRC-32 based algorithm.
  *
- * Note: All derived classes must used the reverse polynomial in order to create the
- * correct lookup tables.
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the lookup tables are built from the reversed polynomial and the CRC is
+ * computed in the reflected domain (right-shifting register) so no data byte needs to be
+ * reflected.
+ *
+ * @see Crc
  */
-class LIBHASH_API CRC32Base : public CRCBase {
-public:
-    CRC32Base( uint32_t, uint32_t, uint32_t, bool, bool );
-    virtual ~CRC32Base( );
-
-    virtual void init( );
-    virtual void finalize( );
-
-    /**
-     * Retrieves the value that will be XOR'ed with the final CRC.
-     *
-     * @return value to be XOR'ed
-     */
-    inline uint32_t getXorValue( ) {
-        return mXorValue;
-    }
-
-    /**
-     * Retrieves the polynomial used by this CRC.
-     *
-     * @return CRC's polynomial
-     */
-    inline uint32_t getPolynomial( ) {
-        return mPolynomial;
-    }
-
-    /**
-     * Retrieves the CRC's initial value.
-     *
-     * @return CRC's initial value.
-     */
-    inline uint32_t getInitialValue( ) {
-        return mInit;
-    }
-
-protected:
-    virtual void update( uint32_t *, const void *, size_t  );
-    void initLookupTable( uint32_t * );
-
-    /** Current hashing state. */
-    uint32_t    mState;
-
-private:
-    uint32_t mInit;
-    uint32_t mPolynomial;
-    uint32_t mXorValue;
-
-} ; // class CRC32Base
+typedef CRCBaseT<uint32_t, 32> CRC32Base;
+
+extern template class LIBHASH_API CRCBaseT<uint32_t, 32>;
+
+/**
+ * @brief CRC-32 specialization of the generic CRC engine.
+ */
+template<>
+struct CRCTraits<32> {
+    typedef CRC32Base   Base;
+    typedef uint32_t    Register;
+} ;
 
 /**
  * @brief CRC32 algorithm as defined by RFC-1952.
  *
  * It provides a 32-bits hash fingerprint.
  *
- * Note: The first time a CRC-32 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation. The main
- * reason is to avoid using memory that will not be needed if the class is not used. 1KB
- * may seems ridiculus on modern computer but may have huge impact on embedded systems.
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by folding 64 bytes
+ * per iteration with carry-less multiplications (256 bytes with AVX-512 VPCLMULQDQ).
+ *
+ * Note: The 16 slicing tables (16KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-32 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2017/03/20)
  *
  * @see https://tools.ietf.org/html/rfc1952
  * @see CRC32C
  */
-class LIBHASH_API CRC32 : public CRC32Base {
-public:
-    CRC32( );
-
-    virtual ~CRC32( ) { };
-
-    virtual void update( const void *data, size_t size );
-
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint32_t msLookup[ 256 ];
-    static bool msTableInit;
-} ;  // class CRC32
+typedef Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, true, true> CRC32;
 
 /**
- * @brief CRC32 algorithm as defined by RFC-1952.
+ * @brief CRC32 algorithm as used by BZip2.
  *
- * It provides a 32-bits hash fingerprint.
+ * It provides a 32-bits hash fingerprint. It uses the CRC32 polynomial without reflection.
+ *
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by folding 64 bytes
+ * per iteration with carry-less multiplications (256 bytes with AVX-512 VPCLMULQDQ).
  *
- * Note: The first time a CRC-32 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation. The main
- * reason is to avoid using memory that will not be needed if the class is not used. 1KB
- * may seems ridiculus on modern computer but may have huge impact on embedded systems.
+ * Note: The 16 slicing tables (16KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-32 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2017/03/20)
  *
- * @see https://tools.ietf.org/html/rfc1952
- * @see CRC32C
+ * @see CRC32
  */
-class LIBHASH_API CRC32_BZip2 : public CRC32Base {
-public:
-    CRC32_BZip2( );
-
-    virtual ~CRC32_BZip2( ) { };
-
-    virtual void update( const void *data, size_t size );
-
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint32_t msLookup[ 256 ];
-    static bool msTableInit;
-} ;  // class CRC32_BZip2
+typedef Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, false, false> CRC32_BZip2;
 
 /**
  * @brief A CRC32-C implementation.
  *
  * CRC32-C is becoming more popular because of its hardware implementation on some Intel's
- * processor. This class does not use the hardware features of those processors.
+ * processor. On x86-64 CPUs supporting SSE4.2, this class uses the <tt>crc32</tt>
+ * instruction on three interleaved streams; otherwise it falls back to the slicing tables.
  *
- * Note: The first time a CRC-32 object is created, the constructor also builds the lookup
- * table so the it will take a little more as the  subsequent object creation. The main
- * reason is to avoid using memory that will not be needed if the class is not used. 1KB
- * may seems ridiculus on modern computer but may have huge impact on embedded systems.
+ * Note: The 16 slicing tables (16KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-32 object costs nothing and is thread-safe.
  *
  * @author Yanick Poirier (2019/11/02)
  *
  * @see CRC32
  */
-class LIBHASH_API CRC32C : public CRC32Base {
-public:
-    CRC32C( );
-
-    virtual ~CRC32C( ) { };
-
-    virtual void update( const void *data, size_t size );
+typedef Crc<32, 0x1edc6f41, 0xffffffff, 0xffffffff, true, true> CRC32C;
 
-protected:
-
-private:
-    /** CRC lookup table */
-    static uint32_t msLookup[ 256 ];
-    static bool msTableInit;
-
-} ;  // class CRC32C
+extern template class LIBHASH_API Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+extern template class LIBHASH_API Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, false, false>;
+extern template class LIBHASH_API Crc<32, 0x1edc6f41, 0xffffffff, 0xffffffff, true, true>;
 
 };  // namespace libhash
 
@@ -222,17 +162,33 @@ extern "C" {
 void LIBHASH_API* hash_crc32_create( );
 int LIBHASH_API hash_crc32_init( void *h );
 int LIBHASH_API hash_crc32_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc32_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc32_update_file( void *h, int fd );
 int LIBHASH_API hash_crc32_finalize( void *h );
 int LIBHASH_API hash_crc32_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc32_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB );
 int LIBHASH_API hash_crc32_destroy( void *h );
 
 void LIBHASH_API* hash_crc32c_create( );
 int LIBHASH_API hash_crc32c_init( void *h );
 int LIBHASH_API hash_crc32c_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc32c_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc32c_update_file( void *h, int fd );
 int LIBHASH_API hash_crc32c_finalize( void *h );
 int LIBHASH_API hash_crc32c_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc32c_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB );
 int LIBHASH_API hash_crc32c_destroy( void *h );
 
+void LIBHASH_API* hash_crc32bzip2_create( );
+int LIBHASH_API hash_crc32bzip2_init( void *h );
+int LIBHASH_API hash_crc32bzip2_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc32bzip2_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc32bzip2_update_file( void *h, int fd );
+int LIBHASH_API hash_crc32bzip2_finalize( void *h );
+int LIBHASH_API hash_crc32bzip2_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc32bzip2_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB );
+int LIBHASH_API hash_crc32bzip2_destroy( void *h );
+
 #    ifdef __cplusplus
 }   // extern "C"
 #    endif
@@ -0,0 +1,203 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc64.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-16
+//
+// Description
+// CRC-64 hashing algorithm declaration.
+//=============================================================================
+
+#ifndef __LH_CRC64_H00__
+#    define __LH_CRC64_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include "crc.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Retrieves the size of the hash algorithm in bits.
+ *
+ * @return always return 64.
+ */
+#    define hash_crc64_get_size() 64
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+namespace libhash {
+
+/**
+ * @brief CRC-64 hardware accelerated kernels.
+ */
+template<>
+struct LIBHASH_API CRCAccelerator<uint64_t, 64> {
+    static size_t accelerate( uint64_t, bool, uint64_t &, const uint8_t *, size_t );
+    static const char *getName( uint64_t, bool );
+} ;
+
+/**
+ * @brief Base class for all CRC-64 based algorithm.
+ *
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the lookup tables are built from the reversed polynomial and the CRC is
+ * computed in the reflected domain (right-shifting register) so no data byte needs to be
+ * reflected.
+ *
+ * @see Crc
+ */
+typedef CRCBaseT<uint64_t, 64> CRC64Base;
+
+extern template class LIBHASH_API CRCBaseT<uint64_t, 64>;
+
+/**
+ * @brief CRC-64 specialization of the generic CRC engine.
+ */
+template<>
+struct CRCTraits<64> {
+    typedef CRC64Base   Base;
+    typedef uint64_t    Register;
+} ;
+
+/**
+ * @brief CRC-64 algorithm as defined by ECMA-182.
+ *
+ * It provides a 64-bits hash fingerprint. The input and output are not reflected, the
+ * initial value and the final XOR value are 0.
+ *
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by folding 64 bytes
+ * per iteration with carry-less multiplications (256 bytes with AVX-512 VPCLMULQDQ).
+ *
+ * Note: The 16 slicing tables (32KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-64 object costs nothing and is thread-safe.
+ *
+ * @author Yanick Poirier (2019/11/16)
+ *
+ * @see https://www.ecma-international.org/publications/standards/Ecma-182.htm
+ * @see CRC64_XZ
+ */
+typedef Crc<64, 0x42f0e1eba9ea3693, 0x0000000000000000, 0x0000000000000000, false, false> CRC64_ECMA182;
+
+/**
+ * @brief CRC-64 algorithm as used by XZ.
+ *
+ * It provides a 64-bits hash fingerprint. It uses the ECMA-182 polynomial with reflected
+ * input and output; it is sometimes called CRC-64/GO-ECMA.
+ *
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by folding 64 bytes
+ * per iteration with carry-less multiplications (256 bytes with AVX-512 VPCLMULQDQ).
+ *
+ * Note: The 16 slicing tables (32KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-64 object costs nothing and is thread-safe.
+ *
+ * @author Yanick Poirier (2019/11/16)
+ *
+ * @see https://tukaani.org/xz/xz-file-format.txt
+ * @see CRC64_ECMA182
+ */
+typedef Crc<64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true> CRC64_XZ;
+
+/**
+ * @brief CRC-64 algorithm as used by the NVMe end-to-end data protection.
+ *
+ * It provides a 64-bits hash fingerprint. It is the 64-bits guard of the NVMe protection
+ * information (NVM Command Set, 64b Guard).
+ *
+ * On x86-64 CPUs supporting PCLMULQDQ, large buffers are processed by folding 64 bytes
+ * per iteration with carry-less multiplications (256 bytes with AVX-512 VPCLMULQDQ).
+ *
+ * Note: The 16 slicing tables (32KB) are generated at compile time and stored in read-only
+ * data, so creating a CRC-64 object costs nothing and is thread-safe.
+ *
+ * @author Yanick Poirier (2019/11/16)
+ *
+ * @see CRC64_XZ
+ */
+typedef Crc<64, 0xad93d23594c93659, 0xffffffffffffffff, 0xffffffffffffffff, true, true> CRC64_NVMe;
+
+extern template class LIBHASH_API Crc<64, 0x42f0e1eba9ea3693, 0x0000000000000000, 0x0000000000000000, false, false>;
+extern template class LIBHASH_API Crc<64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true>;
+extern template class LIBHASH_API Crc<64, 0xad93d23594c93659, 0xffffffffffffffff, 0xffffffffffffffff, true, true>;
+
+};  // namespace libhash
+
+
+#    endif  // __cplusplus
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+void LIBHASH_API* hash_crc64ecma_create( );
+int LIBHASH_API hash_crc64ecma_init( void *h );
+int LIBHASH_API hash_crc64ecma_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc64ecma_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc64ecma_update_file( void *h, int fd );
+int LIBHASH_API hash_crc64ecma_finalize( void *h );
+int LIBHASH_API hash_crc64ecma_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc64ecma_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB );
+int LIBHASH_API hash_crc64ecma_destroy( void *h );
+
+void LIBHASH_API* hash_crc64xz_create( );
+int LIBHASH_API hash_crc64xz_init( void *h );
+int LIBHASH_API hash_crc64xz_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc64xz_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc64xz_update_file( void *h, int fd );
+int LIBHASH_API hash_crc64xz_finalize( void *h );
+int LIBHASH_API hash_crc64xz_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc64xz_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB );
+int LIBHASH_API hash_crc64xz_destroy( void *h );
+
+void LIBHASH_API* hash_crc64nvme_create( );
+int LIBHASH_API hash_crc64nvme_init( void *h );
+int LIBHASH_API hash_crc64nvme_update( void *h, void *buf, size_t len );
+int LIBHASH_API hash_crc64nvme_update_parallel( void *h, void *buf, size_t len, unsigned threads );
+int LIBHASH_API hash_crc64nvme_update_file( void *h, int fd );
+int LIBHASH_API hash_crc64nvme_finalize( void *h );
+int LIBHASH_API hash_crc64nvme_get_value( void *h, uint8_t *buf, size_t len );
+int LIBHASH_API hash_crc64nvme_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB );
+int LIBHASH_API hash_crc64nvme_destroy( void *h );
+
+#    ifdef __cplusplus
+}   // extern "C"
+#    endif
+
+#endif   // __LH_CRC64_H00__
+
+// EOF: crc64.h
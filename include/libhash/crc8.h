@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc8.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-10
+//
+// Description
+// CRC-8 base class of the generic CRC engine.
+//=============================================================================
+
+#ifndef __LH_CRC8_H00__
+#    define __LH_CRC8_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include "crc.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+#    ifdef __cplusplus
+namespace libhash {
+
+/**
+ * @brief Base class for all CRC-8 based algorithm.
+ *
+ * Note: All derived classes must give the polynomial in its normal form. When the input
+ * is reflected, the lookup table is built from the reversed polynomial and the CRC is
+ * computed in the reflected domain (right-shifting register) so no data byte needs to be
+ * reflected. There is no hardware accelerated kernel: the CRC-8 variants are computed
+ * with the slicing-by-16 tables, for example:
+ *
+ * <pre>
+ * typedef Crc<8, 0x07, 0x00, 0x00, false, false> CRC8_SMBus;
+ * typedef Crc<8, 0x31, 0x00, 0x00, true, true> CRC8_Maxim;
+ * </pre>
+ *
+ * @see Crc
+ */
+typedef CRCBaseT<uint8_t, 8> CRC8Base;
+
+extern template class LIBHASH_API CRCBaseT<uint8_t, 8>;
+
+/**
+ * @brief CRC-8 specialization of the generic CRC engine.
+ */
+template<>
+struct CRCTraits<8> {
+    typedef CRC8Base    Base;
+    typedef uint8_t     Register;
+} ;
+
+};  // namespace libhash
+
+#    endif  // __cplusplus
+
+#endif   // __LH_CRC8_H00__
+
+// EOF: crc8.h
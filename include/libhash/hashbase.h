@@ -144,6 +144,17 @@ public:
      */
     int getValue( uint8_t *buffer, size_t size );
 
+    /**
+     * @brief Retrieves the name of the kernel processing the bulk of the data.
+     *
+     * The kernel is selected when the library is loaded, from the CPU features (see
+     * CPU). For example, a CRC32C object reports <tt>"sse4.2"</tt> on a CPU with the
+     * <tt>crc32</tt> instruction.
+     *
+     * @return the kernel name; <tt>"generic"</tt> for the portable implementation.
+     */
+    virtual const char *getKernel( );
+
 protected:
     /**
      * Constructs a hashing object. Upon its construction, the hashing object is not
@@ -195,6 +206,21 @@ protected:
         mOutReflection = outReflect;
     };
 
+    /**
+     * @brief Returns the reflected 64-bits value of the specified value.
+     *
+     * A reflected value is a value where each bit are swapped. For example, the reflected
+     * value of 0x55 (0b01010101) is 0xAA (0b10101010), 0x87 (0b10000111) is 0xE1
+     * (0b11100001), etc.
+     *
+     * @param value Initial 64-bits value.
+     *
+     * @return the reflected value.
+     */
+    inline uint64_t reflect( uint64_t value ) {
+        return ( (uint64_t) reflect( (uint32_t) value ) << 32 ) | reflect( (uint32_t) ( value >> 32 ) );
+    }
+
     /**
      * @brief Returns the reflected 32-bits value of the specified value.
      *
@@ -288,6 +314,16 @@ private:
 // PROTOTYPES
 //-----------------------------------------------------------------------------
 
+#    ifdef __cplusplus
+extern "C" {
+#    endif
+
+const char LIBHASH_API* hash_get_kernel( void *h );
+
+#    ifdef __cplusplus
+}   // extern "C"
+#    endif
+
 #endif   // __LH_HASHBASE_H00__
 
 // EOF: hashbase.h
@@ -41,8 +41,13 @@
 
 #    include <libhash/defs.h>
 #    include <libhash/hashbase.h>
+#    include <libhash/cpu.h>
+#    include <libhash/crc.h>
+#    include <libhash/crc8.h>
 #    include <libhash/crc16.h>
+#    include <libhash/crc24.h>
 #    include <libhash/crc32.h>
+#    include <libhash/crc64.h>
 #    include <libhash/md5.h>
 #    include <libhash/sha1.h>
 #    include <libhash/sha2.h>
@@ -69,6 +69,10 @@ namespace libhash {
  *
  * Security considerations on using MD5 have been updated by the RFC-6151.
  *
+ * Many independent messages are best hashed together with batch(), which processes 8 or
+ * 16 of them at a time in the AVX2 or AVX-512 lanes, or 2 at a time with the scalar
+ * instructions.
+ *
  * @author Yanick Poirier (2017/01/21)
  *
  * @see <a href="https://tools.ietf.org/html/rfc1321">RFC-1321</a>
@@ -85,8 +89,11 @@ public:
     virtual void update( const void *data, size_t size );
     virtual void finalize( );
 
+    static void batch( const void *const *, const size_t *, size_t, uint8_t * );
+    static const char *getBatchKernel( );
+
 protected:
-    void transform( uint8_t *block );
+    void transform( const uint8_t *blocks, size_t count );
 
 private:
     /** Current hashing state. */
@@ -117,6 +124,7 @@ int LIBHASH_API hash_md5_update( void *h, void *buf, size_t len );
 int LIBHASH_API hash_md5_finalize( void *h );
 int LIBHASH_API hash_md5_get_value( void *h, uint8_t *buf, size_t len );
 int LIBHASH_API hash_md5_destroy( void *h );
+int LIBHASH_API hash_md5_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests );
 
 #    ifdef __cplusplus
 } // extern "C"
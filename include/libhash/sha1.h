@@ -58,6 +58,11 @@ namespace libhash {
  * This class implements the SHA-1 Secure Hash Algorithm as defined in the Federal
  * Information Processing Standards Publication 180-2 (FIPS 180-2) release August 1st, 2002.
  *
+ * On x86-64 CPUs supporting the SHA extensions (SHA-NI), the blocks are processed with
+ * the sha1rnds4, sha1nexte, sha1msg1 and sha1msg2 instructions. Many independent messages
+ * are best hashed together with batch(), which processes 8 or 16 of them at a time in the
+ * AVX2 or AVX-512 lanes.
+ *
  * @author Yanick Poirier (2017/01/24)
  */
 class LIBHASH_API SHA1 : public HashingBase {
@@ -76,9 +81,13 @@ public:
     virtual void init( );
     virtual void update( const void *data, size_t size );
     virtual void finalize( );
+    virtual const char *getKernel( );
+
+    static void batch( const void *const *, const size_t *, size_t, uint8_t * );
+    static const char *getBatchKernel( );
 
 protected:
-    void transform( );
+    void transform( const uint8_t *blocks, size_t count );
 
 private:
     /** Current hashing state. */
@@ -112,6 +121,7 @@ int LIBHASH_API hash_sha1_update( void *h, void *buf, size_t len );
 int LIBHASH_API hash_sha1_finalize( void *h );
 int LIBHASH_API hash_sha1_get_value( void *h, uint8_t *buf, size_t len );
 int LIBHASH_API hash_sha1_destroy( void *h );
+int LIBHASH_API hash_sha1_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests );
 
 #    ifdef __cplusplus
 }   // extern "C"
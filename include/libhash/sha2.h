@@ -52,53 +52,105 @@
 namespace libhash {
 
 /**
- * This class implements the SHA-2 256-bits Secure Hash Algorithm as defined in the
- * Federal Information Processing Standards Publication 180-2 (FIPS 180-2) released on
- * August 1st, 2002.
+ * @brief Core of the SHA-2 algorithms.
  *
- * @author Yanick Poirier (2017/01/25)
+ * SHA-224 and SHA-256 on one side, SHA-384, SHA-512 and SHA-512/t on the other, only
+ * differ by their initial state and the size of their digest. This template implements
+ * the buffering, the padding and the big-endian digest once for each word size; the
+ * derived classes only provide init() (see start()). The digest is the first
+ * getHashSize() bits of the state.
+ *
+ * The blocks are processed with the fastest kernel of the word size supported by the CPU,
+ * so a kernel added for SHA-256 or SHA-512 applies to all the variants.
+ *
+ * @tparam Word     <tt>uint32_t</tt> for 64 rounds on 64 bytes blocks (SHA-224/256), or
+ *                  <tt>uint64_t</tt> for 80 rounds on 128 bytes blocks (SHA-384/512/512-t).
+ *
+ * @author Yanick Poirier (2019/12/21)
  */
-class LIBHASH_API SHA2_256 : public HashingBase {
+template<typename Word>
+class Sha2Core : public HashingBase {
 public:
 
-    /**
-     * Constructor.
-     */
-    SHA2_256( ) : HashingBase( 256 ) { }
-
     /**
      * Destructor.
      */
-    virtual ~SHA2_256( ) { }
+    virtual ~Sha2Core( ) { }
 
-    virtual void init( );
     virtual void update( const void *data, size_t size );
     virtual void finalize( );
+    virtual const char *getKernel( );
 
 protected:
 
     /**
-     * Constructor for SHA2-256 drived classes.
+     * Constructor.
      *
      * @param bits Size in bits of the hash value.
      */
-    SHA2_256( size_t bits ) : HashingBase( bits ) { }
+    Sha2Core( size_t bits ) : HashingBase( bits ) { }
 
-    void transform( );
+    void start( const Word *initial );
+    void transform( const uint8_t *blocks, size_t count );
     void pad( );
     void clear( );
 
     /** Current digest state. */
-    uint32_t    mState[8];
+    Word        mState[8];
 
-    /** Length of the message block in bits. */
-    uint64_t    mBitCount;
+    /** Length of the message in bits; <tt>mBitCount[ 0 ]</tt> holds the high 64 bits. */
+    uint64_t    mBitCount[2];
 
     /** Current message block index. */
     size_t      mIndex;
 
     /** Current message block. */
-    uint8_t     mBlock[64];
+    uint8_t     mBlock[ 16 * sizeof ( Word ) ];
+} ;  // class Sha2Core
+
+extern template class LIBHASH_API Sha2Core<uint32_t>;
+extern template class LIBHASH_API Sha2Core<uint64_t>;
+
+/**
+ * This class implements the SHA-2 256-bits Secure Hash Algorithm as defined in the
+ * Federal Information Processing Standards Publication 180-2 (FIPS 180-2) released on
+ * August 1st, 2002.
+ *
+ * On x86-64 CPUs supporting the SHA extensions (SHA-NI), the blocks are processed with
+ * the sha256rnds2, sha256msg1 and sha256msg2 instructions.
+ *
+ * Many independent messages are best hashed together with batch(), which processes 16 of
+ * them at a time in the AVX-512 lanes, or 8 in the AVX2 lanes when the SHA extensions are
+ * missing.
+ *
+ * @author Yanick Poirier (2017/01/25)
+ */
+class LIBHASH_API SHA2_256 : public Sha2Core<uint32_t> {
+public:
+
+    /**
+     * Constructor.
+     */
+    SHA2_256( ) : Sha2Core<uint32_t>( 256 ) { }
+
+    /**
+     * Destructor.
+     */
+    virtual ~SHA2_256( ) { }
+
+    virtual void init( );
+
+    static void batch( const void *const *, const size_t *, size_t, uint8_t * );
+    static const char *getBatchKernel( );
+
+protected:
+
+    /**
+     * Constructor for SHA2-256 drived classes.
+     *
+     * @param bits Size in bits of the hash value.
+     */
+    SHA2_256( size_t bits ) : Sha2Core<uint32_t>( bits ) { }
 } ;
 
 /**
@@ -121,7 +173,6 @@ public:
     virtual ~SHA2_224( ) { }
 
     virtual void init( );
-    virtual void finalize( );
 
 protected:
 } ;
@@ -131,15 +182,19 @@ protected:
  * Federal Information Processing Standards Publication 180-2 (FIPS 180-2) release August 1st,
  * 2002.
  *
+ * On x86-64 CPUs with AVX2 and BMI2, the message schedule is computed in the vector units
+ * and the rounds use the rorx rotations. batch() hashes many independent messages 8 at a
+ * time in the AVX-512 lanes, or 4 in the AVX2 lanes.
+ *
  * @author Yanick Poirier (2017/01/25)
  */
-class LIBHASH_API SHA2_512 : public HashingBase {
+class LIBHASH_API SHA2_512 : public Sha2Core<uint64_t> {
 public:
 
     /**
      * Constructor.
      */
-    SHA2_512( ) : HashingBase( 512 ) { }
+    SHA2_512( ) : Sha2Core<uint64_t>( 512 ) { }
 
     /**
      * Destructor.
@@ -147,8 +202,9 @@ public:
     virtual ~SHA2_512( ) { }
 
     virtual void init( );
-    virtual void update( const void *data, size_t size );
-    virtual void finalize( );
+
+    static void batch( const void *const *, const size_t *, size_t, uint8_t * );
+    static const char *getBatchKernel( );
 
 protected:
 
@@ -157,23 +213,7 @@ protected:
      *
      * @param bits Size in bits of the hash value.
      */
-    SHA2_512( size_t bits ) : HashingBase( bits ) { }
-
-    void transform( );
-    void pad( );
-    void clear( );
-
-    /** Current digest state. */
-    uint64_t    mState[8];
-
-    /** Length of the message block in bits. LSB is stored in offset 0. */
-    uint64_t    mBitCount[2];
-
-    /** Current message block index. */
-    size_t      mIndex;
-
-    /** Current message block. */
-    uint8_t     mBlock[128];
+    SHA2_512( size_t bits ) : Sha2Core<uint64_t>( bits ) { }
 } ;
 
 /**
@@ -196,7 +236,57 @@ public:
     virtual ~SHA2_384( ) { }
 
     virtual void init( );
-    virtual void finalize( );
+
+protected:
+} ;
+
+/**
+ * This class implements the SHA-2 512/224 Secure Hash Algorithm as defined in the
+ * FIPS 180-4 document released in August 2015: SHA-512 with an initial state generated
+ * from the digest size and a digest truncated to 224 bits. It uses the SHA-512 kernels.
+ *
+ * @author Yanick Poirier (2019/12/14)
+ */
+class LIBHASH_API SHA2_512_224 : public SHA2_512 {
+public:
+
+    /**
+     * Constructor.
+     */
+    SHA2_512_224( ) : SHA2_512( 224 ) { }
+
+    /**
+     * Destructor.
+     */
+    virtual ~SHA2_512_224( ) { }
+
+    virtual void init( );
+
+protected:
+} ;
+
+/**
+ * This class implements the SHA-2 512/256 Secure Hash Algorithm as defined in the
+ * FIPS 180-4 document released in August 2015: SHA-512 with an initial state generated
+ * from the digest size and a digest truncated to 256 bits. On 64-bits CPUs without the SHA
+ * extensions, it is faster than SHA-2 256 since each SHA-512 block holds twice the data.
+ *
+ * @author Yanick Poirier (2019/12/14)
+ */
+class LIBHASH_API SHA2_512_256 : public SHA2_512 {
+public:
+
+    /**
+     * Constructor.
+     */
+    SHA2_512_256( ) : SHA2_512( 256 ) { }
+
+    /**
+     * Destructor.
+     */
+    virtual ~SHA2_512_256( ) { }
+
+    virtual void init( );
 
 protected:
 } ;
@@ -357,6 +447,21 @@ int LIBHASH_API hash_sha2_256_get_value( void *h, uint8_t *buf, size_t len );
  */
 int LIBHASH_API hash_sha2_256_destroy( void *h );
 
+/**
+ * @brief Hashes a batch of independent messages with SHA2-256.
+ *
+ * The messages can have different lengths. See {@link SHA2_256::batch}.
+ *
+ * @param data    Pointers to the messages.
+ * @param sizes   Number of bytes of each message.
+ * @param count   Number of messages.
+ * @param digests Buffer receiving the <tt>count * 32</tt> bytes of digests, the digest of
+ *                message <tt>i</tt> starting at <tt>digests[i * 32]</tt>.
+ *
+ * @return a non-zero value on success of 0 if a pointer is <tt>NULL</tt>.
+ */
+int LIBHASH_API hash_sha2_256_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests );
+
 /**
  * Creates a new SHA2-384 handler.
  *
@@ -501,6 +606,165 @@ int LIBHASH_API hash_sha2_512_get_value( void *h, uint8_t *buf, size_t len );
  */
 int LIBHASH_API hash_sha2_512_destroy( void *h );
 
+/**
+ * @brief Hashes a batch of independent messages with SHA2-512.
+ *
+ * The messages can have different lengths. See {@link SHA2_512::batch}.
+ *
+ * @param data    Pointers to the messages.
+ * @param sizes   Number of bytes of each message.
+ * @param count   Number of messages.
+ * @param digests Buffer receiving the <tt>count * 64</tt> bytes of digests, the digest of
+ *                message <tt>i</tt> starting at <tt>digests[i * 64]</tt>.
+ *
+ * @return a non-zero value on success of 0 if a pointer is <tt>NULL</tt>.
+ */
+int LIBHASH_API hash_sha2_512_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests );
+
+/**
+ * Creates a new SHA2-512/224 handler.
+ *
+ * @return pointer to the newly created SHA2-512/224 handler or <tt>null</tt> on error.
+ */
+void LIBHASH_API* hash_sha2_512_224_create( );
+
+/**
+ * @brief Initializes the specified SHA2-512/224 handler.
+ *
+ * This function prepares the SHA2-512/224 handler for hashing data. It must be called prior
+ * the first {@link hash_sha2_512_224_update} or {@link hash_sha2_512_224_final} calls.
+ *
+ * @param h Pointer to a valid SHA2-512/224 handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_224_init( void *h );
+
+/**
+ * @brief Updates the specified SHA2-512/224 handler's state with the data.
+ *
+ * This function updates the SHA2-512/224 bits handler's state by hashing data. It must be
+ * called after {@link hash_sha2_512_224_init} and before {@link hash_sha2_512_224_final}. The
+ * result of calling this function before {@link hash_sha2_512_224_init} or after
+ * {@link hash_sha2_512_224_final} is undefined.
+ *
+ * @param h   Pointer to a valid SHA2-512/224 bits handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to a set of data to hash.
+ * @param len Number of bytes in <tt>buf</tt> to hash.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_224_update( void *h, void *buf, size_t len );
+
+/**
+ * @brief Finalizes the specified SHA2-512/224 handler's state.
+ *
+ * This function finalizes the SHA2-512/224 handler's state and returns the hashing value. It
+ * must be called after {@link hash_sha2_512_224_init} The result of calling this function
+ * before {@link hash_sha2_512_224_init} is undefined.
+ *
+ * @param h   Pointer to a valid SHA2-512/224 handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to buffer to receive the calculated hash value.
+ * @param len Number of bytes in <tt>buf</tt>.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_224_finalize( void *h );
+
+/**
+ * @brief Retrieves the hashing value after the last <tt>buffer[</tt> method call.
+ *
+ * The result of calling this method prior to the {@link hash_sha2_512_224_finalize} method is
+ * undefined. If the memory buffer is smaller than the hash size, only the higher part of
+ * the hash value is returned.
+ *
+ * @param buf  Memory buffer to receive the hashing result.
+ * @param size Size of the memory buffer in bytes.
+ *
+ * @return the number of bytes copied into <tt>buf</tt>.
+ */
+int LIBHASH_API hash_sha2_512_224_get_value( void *h, uint8_t *buf, size_t len );
+
+/**
+ * Destroys an existing SHA2-512/224 handler.
+ *
+ * @param h Pointer to a valid SHA2-512/224 handler. Cannot be <tt>NULL</tt>.
+ * @return pointer to the newly created SHA2-512/224 handler or <tt>null</tt> on error.
+ */
+int LIBHASH_API hash_sha2_512_224_destroy( void *h );
+
+/**
+ * Creates a new SHA2-512/256 handler.
+ *
+ * @return pointer to the newly created SHA2-512/256 handler or <tt>null</tt> on error.
+ */
+void LIBHASH_API* hash_sha2_512_256_create( );
+
+/**
+ * @brief Initializes the specified SHA2-512/256 handler.
+ *
+ * This function prepares the SHA2-512/256 handler for hashing data. It must be called prior
+ * the first {@link hash_sha2_512_256_update} or {@link hash_sha2_512_256_final} calls.
+ *
+ * @param h Pointer to a valid SHA2-512/256 handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_256_init( void *h );
+
+/**
+ * @brief Updates the specified SHA2-512/256 handler's state with the data.
+ *
+ * This function updates the SHA2-512/256 bits handler's state by hashing data. It must be
+ * called after {@link hash_sha2_512_256_init} and before {@link hash_sha2_512_256_final}. The
+ * result of calling this function before {@link hash_sha2_512_256_init} or after
+ * {@link hash_sha2_512_256_final} is undefined.
+ *
+ * @param h   Pointer to a valid SHA2-512/256 bits handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to a set of data to hash.
+ * @param len Number of bytes in <tt>buf</tt> to hash.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_256_update( void *h, void *buf, size_t len );
+
+/**
+ * @brief Finalizes the specified SHA2-512/256 handler's state.
+ *
+ * This function finalizes the SHA2-512/256 handler's state and returns the hashing value. It
+ * must be called after {@link hash_sha2_512_256_init} The result of calling this function
+ * before {@link hash_sha2_512_256_init} is undefined.
+ *
+ * @param h   Pointer to a valid SHA2-512/256 handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to buffer to receive the calculated hash value.
+ * @param len Number of bytes in <tt>buf</tt>.
+ *
+ * @return a non-zero value on success of 0 if <tt>h</tt> is not valid.
+ */
+int LIBHASH_API hash_sha2_512_256_finalize( void *h );
+
+/**
+ * @brief Retrieves the hashing value after the last <tt>buffer[</tt> method call.
+ *
+ * The result of calling this method prior to the {@link hash_sha2_512_256_finalize} method is
+ * undefined. If the memory buffer is smaller than the hash size, only the higher part of
+ * the hash value is returned.
+ *
+ * @param buf  Memory buffer to receive the hashing result.
+ * @param size Size of the memory buffer in bytes.
+ *
+ * @return the number of bytes copied into <tt>buf</tt>.
+ */
+int LIBHASH_API hash_sha2_512_256_get_value( void *h, uint8_t *buf, size_t len );
+
+/**
+ * Destroys an existing SHA2-512/256 handler.
+ *
+ * @param h Pointer to a valid SHA2-512/256 handler. Cannot be <tt>NULL</tt>.
+ * @return pointer to the newly created SHA2-512/256 handler or <tt>null</tt> on error.
+ */
+int LIBHASH_API hash_sha2_512_256_destroy( void *h );
+
 #    ifdef __cplusplus
 }
 #    endif
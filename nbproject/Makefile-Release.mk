@@ -35,9 +35,14 @@ OBJECTDIR=${CND_BUILDDIR}/${CND_CONF}/${CND_PLATFORM}
 
 # Object Files
 OBJECTFILES= \
+	${OBJECTDIR}/src/cpu.o \
+	${OBJECTDIR}/src/crc.o \
+	${OBJECTDIR}/src/crc16.o \
 	${OBJECTDIR}/src/crc32.o \
+	${OBJECTDIR}/src/crc64.o \
 	${OBJECTDIR}/src/hashbase.o \
 	${OBJECTDIR}/src/md5.o \
+	${OBJECTDIR}/src/multibuffer.o \
 	${OBJECTDIR}/src/sha1.o \
 	${OBJECTDIR}/src/sha2.o
 
@@ -50,7 +55,12 @@ TESTFILES= \
 
 # Test Object Files
 TESTOBJECTFILES= \
+	${TESTDIR}/tests/CPUTests.o \
+	${TESTDIR}/tests/CRC16Tests.o \
+	${TESTDIR}/tests/CRC24Tests.o \
 	${TESTDIR}/tests/CRC32Tests.o \
+	${TESTDIR}/tests/CRC64Tests.o \
+	${TESTDIR}/tests/CRC8Tests.o \
 	${TESTDIR}/tests/MD5Tests.o \
 	${TESTDIR}/tests/SHA1Tests.o \
 	${TESTDIR}/tests/SHA2Tests.o \
@@ -81,11 +91,31 @@ ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/liblibhash.${CND_DLIB_EXT}: ${OBJECTF
 	${MKDIR} -p ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}
 	${LINK.cc} -o ${CND_DISTDIR}/${CND_CONF}/${CND_PLATFORM}/liblibhash.${CND_DLIB_EXT} ${OBJECTFILES} ${LDLIBSOPTIONS} -shared -fPIC
 
+${OBJECTDIR}/src/cpu.o: src/cpu.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/cpu.o src/cpu.cpp
+
+${OBJECTDIR}/src/crc.o: src/crc.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc.o src/crc.cpp
+
+${OBJECTDIR}/src/crc16.o: src/crc16.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc16.o src/crc16.cpp
+
 ${OBJECTDIR}/src/crc32.o: src/crc32.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc32.o src/crc32.cpp
 
+${OBJECTDIR}/src/crc64.o: src/crc64.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc64.o src/crc64.cpp
+
 ${OBJECTDIR}/src/hashbase.o: src/hashbase.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -96,6 +126,11 @@ ${OBJECTDIR}/src/md5.o: src/md5.cpp
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/md5.o src/md5.cpp
 
+${OBJECTDIR}/src/multibuffer.o: src/multibuffer.cpp
+	${MKDIR} -p ${OBJECTDIR}/src
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -fPIC  -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/multibuffer.o src/multibuffer.cpp
+
 ${OBJECTDIR}/src/sha1.o: src/sha1.cpp
 	${MKDIR} -p ${OBJECTDIR}/src
 	${RM} "$@.d"
@@ -113,17 +148,47 @@ ${OBJECTDIR}/src/sha2.o: src/sha2.cpp
 .build-tests-conf: .build-tests-subprojects .build-conf ${TESTFILES}
 .build-tests-subprojects:
 
-${TESTDIR}/TestFiles/f2: ${TESTDIR}/tests/CRC32Tests.o ${TESTDIR}/tests/MD5Tests.o ${TESTDIR}/tests/SHA1Tests.o ${TESTDIR}/tests/SHA2Tests.o ${TESTDIR}/tests/libHashTest.o ${TESTDIR}/tests/libHashTestCases.o ${OBJECTFILES:%.o=%_nomain.o}
+${TESTDIR}/TestFiles/f2: ${TESTDIR}/tests/CPUTests.o ${TESTDIR}/tests/CRC16Tests.o ${TESTDIR}/tests/CRC24Tests.o ${TESTDIR}/tests/CRC32Tests.o ${TESTDIR}/tests/CRC64Tests.o ${TESTDIR}/tests/CRC8Tests.o ${TESTDIR}/tests/MD5Tests.o ${TESTDIR}/tests/SHA1Tests.o ${TESTDIR}/tests/SHA2Tests.o ${TESTDIR}/tests/libHashTest.o ${TESTDIR}/tests/libHashTestCases.o ${OBJECTFILES:%.o=%_nomain.o}
 	${MKDIR} -p ${TESTDIR}/TestFiles
 	${LINK.cc} -o ${TESTDIR}/TestFiles/f2 $^ ${LDLIBSOPTIONS}  -lcppunit 
 
 
+${TESTDIR}/tests/CPUTests.o: tests/CPUTests.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CPUTests.o tests/CPUTests.cpp
+
+
+${TESTDIR}/tests/CRC16Tests.o: tests/CRC16Tests.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CRC16Tests.o tests/CRC16Tests.cpp
+
+
+${TESTDIR}/tests/CRC24Tests.o: tests/CRC24Tests.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CRC24Tests.o tests/CRC24Tests.cpp
+
+
 ${TESTDIR}/tests/CRC32Tests.o: tests/CRC32Tests.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CRC32Tests.o tests/CRC32Tests.cpp
 
 
+${TESTDIR}/tests/CRC64Tests.o: tests/CRC64Tests.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CRC64Tests.o tests/CRC64Tests.cpp
+
+
+${TESTDIR}/tests/CRC8Tests.o: tests/CRC8Tests.cpp 
+	${MKDIR} -p ${TESTDIR}/tests
+	${RM} "$@.d"
+	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/CRC8Tests.o tests/CRC8Tests.cpp
+
+
 ${TESTDIR}/tests/MD5Tests.o: tests/MD5Tests.cpp 
 	${MKDIR} -p ${TESTDIR}/tests
 	${RM} "$@.d"
@@ -154,6 +219,45 @@ ${TESTDIR}/tests/libHashTestCases.o: tests/libHashTestCases.cpp
 	$(COMPILE.cc) -O2 -MMD -MP -MF "$@.d" -o ${TESTDIR}/tests/libHashTestCases.o tests/libHashTestCases.cpp
 
 
+${OBJECTDIR}/src/cpu_nomain.o: ${OBJECTDIR}/src/cpu.o src/cpu.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/cpu.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/cpu_nomain.o src/cpu.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/cpu.o ${OBJECTDIR}/src/cpu_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/crc_nomain.o: ${OBJECTDIR}/src/crc.o src/crc.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/crc.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc_nomain.o src/crc.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/crc.o ${OBJECTDIR}/src/crc_nomain.o;\
+	fi
+
+${OBJECTDIR}/src/crc16_nomain.o: ${OBJECTDIR}/src/crc16.o src/crc16.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/crc16.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc16_nomain.o src/crc16.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/crc16.o ${OBJECTDIR}/src/crc16_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/crc32_nomain.o: ${OBJECTDIR}/src/crc32.o src/crc32.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/crc32.o`; \
@@ -167,6 +271,19 @@ ${OBJECTDIR}/src/crc32_nomain.o: ${OBJECTDIR}/src/crc32.o src/crc32.cpp
 	    ${CP} ${OBJECTDIR}/src/crc32.o ${OBJECTDIR}/src/crc32_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/crc64_nomain.o: ${OBJECTDIR}/src/crc64.o src/crc64.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/crc64.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/crc64_nomain.o src/crc64.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/crc64.o ${OBJECTDIR}/src/crc64_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/hashbase_nomain.o: ${OBJECTDIR}/src/hashbase.o src/hashbase.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/hashbase.o`; \
@@ -193,6 +310,19 @@ ${OBJECTDIR}/src/md5_nomain.o: ${OBJECTDIR}/src/md5.o src/md5.cpp
 	    ${CP} ${OBJECTDIR}/src/md5.o ${OBJECTDIR}/src/md5_nomain.o;\
 	fi
 
+${OBJECTDIR}/src/multibuffer_nomain.o: ${OBJECTDIR}/src/multibuffer.o src/multibuffer.cpp 
+	${MKDIR} -p ${OBJECTDIR}/src
+	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/multibuffer.o`; \
+	if (echo "$$NMOUTPUT" | ${GREP} '|main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T main$$') || \
+	   (echo "$$NMOUTPUT" | ${GREP} 'T _main$$'); \
+	then  \
+	    ${RM} "$@.d";\
+	    $(COMPILE.cc) -O2 -fPIC  -Dmain=__nomain -MMD -MP -MF "$@.d" -o ${OBJECTDIR}/src/multibuffer_nomain.o src/multibuffer.cpp;\
+	else  \
+	    ${CP} ${OBJECTDIR}/src/multibuffer.o ${OBJECTDIR}/src/multibuffer_nomain.o;\
+	fi
+
 ${OBJECTDIR}/src/sha1_nomain.o: ${OBJECTDIR}/src/sha1.o src/sha1.cpp 
 	${MKDIR} -p ${OBJECTDIR}/src
 	@NMOUTPUT=`${NM} ${OBJECTDIR}/src/sha1.o`; \
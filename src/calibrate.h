@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       calibrate.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-30
+//
+// Description
+// Internal declarations of the kernel calibration. This header is not installed.
+//=============================================================================
+
+#ifndef __LH_CALIBRATE_H00__
+#    define __LH_CALIBRATE_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include <stddef.h>
+#    include "../include/libhash/cpu.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+namespace libhash {
+
+/**
+ * @internal
+ *
+ * @brief Runs a kernel once for the calibration.
+ *
+ * @param context   Context given to cpuCalibrate().
+ * @param kernel    Index of the kernel to run.
+ * @param buffer    Data to process.
+ * @param size      Number of bytes in <tt>buffer</tt>
+ *
+ * @return <tt>false</tt> if the kernel cannot process <tt>size</tt> bytes.
+ */
+typedef bool ( *CPUBenchmark )( const void *context, unsigned kernel, const uint8_t *buffer, size_t size );
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+bool cpuCalibrate( const char *, unsigned, CPUBenchmark, const void *, size_t[] );
+
+};  // namespace libhash
+
+#endif   // __LH_CALIBRATE_H00__
+
+// EOF: calibrate.h
@@ -0,0 +1,596 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       cpu.cpp
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-23
+//
+// Description
+// Runtime detection of the CPU features used to select the hashing kernels.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../include/libhash/defs.h"
+#include "../include/libhash/cpu.h"
+#include "calibrate.h"
+#include "kernels.h"
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#    include <cpuid.h>
+#endif
+
+using namespace libhash;
+
+//-----------------------------------------------------------------------------
+// MACROS
+//-----------------------------------------------------------------------------
+
+/** XCR0 bits of the SSE and AVX states. */
+#define CPU_XCR0_AVX            0x06
+
+/** XCR0 bits of the SSE, AVX, opmask and ZMM states. */
+#define CPU_XCR0_AVX512         0xe6
+
+/** Number of bytes processed by each timed run of a kernel. */
+#define CPU_CALIBRATE_BYTES     ( 256 * 1024 )
+
+/** Number of timed runs of a kernel; the fastest one is kept. */
+#define CPU_CALIBRATE_RUNS      5
+
+/** First line of a calibration cache file, followed by the CPU features. */
+#define CPU_CALIBRATE_MAGIC     "libhash-calibration"
+
+/** Number of buffer size classes measured by the calibration. */
+#define CPU_CALIBRATE_CLASSES   6
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * @brief Name of a CPU feature or tier accepted by <tt>LIBHASH_CPU</tt>.
+ */
+struct CPUName {
+    const char  *name;          ///< Name, as written in the environment variable
+    uint32_t    features;       ///< HASH_CPU_* flags
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Calibration decision of an algorithm.
+ */
+struct CPUCalibration {
+    std::string             name;           ///< Name given to cpuCalibrate()
+    std::vector<size_t>     thresholds;     ///< Minimum buffer size of each kernel but the first
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Calibration decisions of the process.
+ */
+struct CPUCalibrationState {
+    std::mutex                  lock;       ///< Serializes the calibrations
+    std::string                 path;       ///< Cache file the decisions were read from
+    std::vector<CPUCalibration> entries;    ///< Decisions
+} ;
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & STATIC VARIABLES
+//-----------------------------------------------------------------------------
+
+/** Buffer sizes measured by the calibration. */
+static const size_t cpuCalibrateSizes[ CPU_CALIBRATE_CLASSES ] = {
+    64, 256, 1024, 4096, 16384, 65536
+} ;
+
+/** Tiers of <tt>LIBHASH_CPU</tt>. */
+static const CPUName cpuTiers[] = {
+    { "generic", 0 },
+    { "sse4", HASH_CPU_TIER_SSE4 },
+    { "avx2", HASH_CPU_TIER_AVX2 },
+    { "avx512", HASH_CPU_TIER_AVX512 },
+    { NULL, 0 }
+} ;
+
+/**
+ * Features that <tt>LIBHASH_CPU</tt> can disable. Disabling a feature also disables the
+ * features that require it: AVX-512 kernels assume AVX2, and VPCLMUL and the fast AVX-512
+ * are only used with AVX-512.
+ */
+static const CPUName cpuFeatures[] = {
+    { "ssse3", HASH_CPU_SSSE3 },
+    { "sse4.1", HASH_CPU_SSE41 },
+    { "sse4.2", HASH_CPU_SSE42 },
+    { "pclmul", HASH_CPU_PCLMUL },
+    { "avx", HASH_CPU_AVX | HASH_CPU_AVX2 | HASH_CPU_AVX512 | HASH_CPU_VPCLMUL | HASH_CPU_AVX512_FAST },
+    { "avx2", HASH_CPU_AVX2 | HASH_CPU_AVX512 | HASH_CPU_VPCLMUL | HASH_CPU_AVX512_FAST },
+    { "bmi2", HASH_CPU_BMI2 },
+    { "sha", HASH_CPU_SHA },
+    { "avx512", HASH_CPU_AVX512 | HASH_CPU_VPCLMUL | HASH_CPU_AVX512_FAST },
+    { "vpclmul", HASH_CPU_VPCLMUL },
+    { "avx512fast", HASH_CPU_AVX512_FAST },
+    { NULL, 0 }
+} ;
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * Probes the CPU features with <tt>cpuid</tt>. The AVX and AVX-512 features are only
+ * reported if the operating system saves their registers (XCR0).
+ */
+static uint32_t cpuDetect( ) {
+    uint32_t features = 0;
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+    unsigned int eax, ebx, ecx, edx;
+    unsigned int xcr0 = 0;
+    unsigned int max = __get_cpuid_max( 0, NULL );
+
+    if( max < 1 ) {
+        return 0;
+    }
+
+    __cpuid( 1, eax, ebx, ecx, edx );
+
+    if( ecx & bit_SSSE3 ) {
+        features |= HASH_CPU_SSSE3;
+    }
+    if( ecx & bit_SSE4_1 ) {
+        features |= HASH_CPU_SSE41;
+    }
+    if( ecx & bit_SSE4_2 ) {
+        features |= HASH_CPU_SSE42;
+    }
+    if( ecx & bit_PCLMUL ) {
+        features |= HASH_CPU_PCLMUL;
+    }
+    if( ecx & bit_OSXSAVE ) {
+        unsigned int xcr0High;
+
+        __asm__( "xgetbv" : "=a" ( xcr0 ), "=d" ( xcr0High ) : "c" ( 0 ) );
+    }
+    if( ( ecx & bit_AVX ) && ( xcr0 & CPU_XCR0_AVX ) == CPU_XCR0_AVX ) {
+        features |= HASH_CPU_AVX;
+    }
+
+    if( max < 7 ) {
+        return features;
+    }
+
+    __cpuid_count( 7, 0, eax, ebx, ecx, edx );
+
+    if( ( ebx & bit_AVX2 ) && ( features & HASH_CPU_AVX ) ) {
+        features |= HASH_CPU_AVX2;
+    }
+    if( ebx & bit_BMI2 ) {
+        features |= HASH_CPU_BMI2;
+    }
+    if( ebx & bit_SHA ) {
+        features |= HASH_CPU_SHA;
+    }
+    if( ( ebx & bit_AVX512F ) && ( ebx & bit_AVX512BW ) && ( ebx & bit_AVX512VL ) &&
+            ( xcr0 & CPU_XCR0_AVX512 ) == CPU_XCR0_AVX512 ) {
+        features |= HASH_CPU_AVX512;
+
+        // VPCLMULQDQ came with the CPUs whose clock barely drops with AVX-512
+        if( ecx & bit_VPCLMULQDQ ) {
+            features |= HASH_CPU_VPCLMUL | HASH_CPU_AVX512_FAST;
+        }
+    }
+#endif
+
+    return features;
+}
+
+/**
+ * @internal
+ *
+ * Looks up a name of the environment variable.
+ *
+ * @return the matching entry or <tt>NULL</tt>.
+ */
+static const CPUName *cpuLookup( const CPUName *names, const char *name, size_t length ) {
+    for( ; names->name != NULL; names++ ) {
+        if( strlen( names->name ) == length && strncmp( names->name, name, length ) == 0 ) {
+            return names;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the features the kernels are bound to, read from <tt>LIBHASH_CPU</tt> on first
+ * use. Only cpuBind() changes them afterward.
+ */
+static uint32_t &cpuSelected( ) {
+    static uint32_t features = CPU::restrict( CPU::getDetected( ), getenv( HASH_CPU_ENV ) );
+
+    return features;
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the calibration decisions, constructed on first use.
+ */
+static CPUCalibrationState &cpuCalibrationState( ) {
+    static CPUCalibrationState state;
+
+    return state;
+}
+
+/**
+ * @internal
+ *
+ * Reads the decisions of a cache file. The file is ignored if it was written with other
+ * CPU features.
+ */
+static void cpuCalibrationLoad( CPUCalibrationState &state, const char *path ) {
+    char line[ 256 ];
+    FILE *file;
+
+    state.path = path;
+    state.entries.clear( );
+
+    file = fopen( path, "r" );
+    if( file == NULL ) {
+        return;
+    }
+
+    if( fgets( line, sizeof ( line ), file ) == NULL ||
+            strncmp( line, CPU_CALIBRATE_MAGIC " ", strlen( CPU_CALIBRATE_MAGIC ) + 1 ) != 0 ||
+            strtoul( line + strlen( CPU_CALIBRATE_MAGIC ) + 1, NULL, 16 ) != CPU::getFeatures( ) ) {
+        fclose( file );
+        return;
+    }
+
+    while( fgets( line, sizeof ( line ), file ) != NULL ) {
+        CPUCalibration entry;
+        char *next = line;
+        char *end;
+
+        while( *next != '\0' && *next != ' ' && *next != '\n' ) {
+            next++;
+        }
+
+        entry.name.assign( line, next - line );
+
+        for( ;; ) {
+            unsigned long long threshold = strtoull( next, &end, 10 );
+
+            if( end == next ) {
+                break;
+            }
+
+            entry.thresholds.push_back( (size_t) threshold );
+            next = end;
+        }
+
+        if( !entry.name.empty( ) ) {
+            state.entries.push_back( entry );
+        }
+    }
+
+    fclose( file );
+}
+
+/**
+ * @internal
+ *
+ * Writes the decisions to the cache file. The file is replaced atomically so concurrent
+ * processes never read a partial file. Errors are ignored: the decisions are measured
+ * again by the next process.
+ */
+static void cpuCalibrationSave( CPUCalibrationState &state ) {
+    std::string temporary = state.path + "." + std::to_string( (long) getpid( ) );
+    FILE *file = fopen( temporary.c_str( ), "w" );
+    bool written;
+
+    if( file == NULL ) {
+        return;
+    }
+
+    fprintf( file, "%s %x\n", CPU_CALIBRATE_MAGIC, CPU::getFeatures( ) );
+
+    for( size_t i = 0; i < state.entries.size( ); i++ ) {
+        fputs( state.entries[ i ].name.c_str( ), file );
+
+        for( size_t j = 0; j < state.entries[ i ].thresholds.size( ); j++ ) {
+            fprintf( file, " %llu", (unsigned long long) state.entries[ i ].thresholds[ j ] );
+        }
+
+        fputc( '\n', file );
+    }
+
+    written = ferror( file ) == 0;
+    if( fclose( file ) != 0 || !written || rename( temporary.c_str( ), state.path.c_str( ) ) != 0 ) {
+        unlink( temporary.c_str( ) );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Measures the time a kernel takes to process a buffer.
+ *
+ * @return the best time in nanoseconds of CPU_CALIBRATE_RUNS runs of CPU_CALIBRATE_BYTES
+ *         bytes, or -1 if the kernel cannot process the buffer size.
+ */
+static double cpuMeasure( CPUBenchmark run, const void *context, unsigned kernel, const uint8_t *buffer, size_t size ) {
+    size_t repeat = CPU_CALIBRATE_BYTES / size;
+    double best = -1;
+
+    // Warm up the caches and the frequency
+    if( !run( context, kernel, buffer, size ) ) {
+        return -1;
+    }
+
+    for( int i = 0; i < CPU_CALIBRATE_RUNS; i++ ) {
+        struct timespec start, stop;
+        double elapsed;
+
+        clock_gettime( CLOCK_MONOTONIC, &start );
+        for( size_t j = 0; j < repeat; j++ ) {
+            run( context, kernel, buffer, size );
+        }
+        clock_gettime( CLOCK_MONOTONIC, &stop );
+
+        elapsed = ( stop.tv_sec - start.tv_sec ) * 1e9 + ( stop.tv_nsec - start.tv_nsec );
+        if( best < 0 || elapsed < best ) {
+            best = elapsed;
+        }
+    }
+
+    return best;
+}
+
+//=== CPU implementation ======================================================
+
+/**
+ * @brief Retrieves the features supported by the CPU and the operating system.
+ *
+ * @return the HASH_CPU_* flags, ignoring <tt>LIBHASH_CPU</tt>.
+ */
+uint32_t CPU::getDetected( ) {
+    static const uint32_t detected = cpuDetect( );
+
+    return detected;
+}
+
+/**
+ * @brief Retrieves the features the hashing kernels may use.
+ *
+ * These are the detected features restricted by the <tt>LIBHASH_CPU</tt> environment
+ * variable, read the first time this method is called.
+ *
+ * @return the HASH_CPU_* flags.
+ */
+uint32_t CPU::getFeatures( ) {
+    return cpuSelected( );
+}
+
+/**
+ * @brief Restricts a set of features following the syntax of <tt>LIBHASH_CPU</tt>.
+ *
+ * Unknown names are ignored.
+ *
+ * @param features  HASH_CPU_* flags to restrict.
+ * @param value     Value of the environment variable. May be <tt>NULL</tt>.
+ *
+ * @return the remaining HASH_CPU_* flags.
+ */
+uint32_t CPU::restrict( uint32_t features, const char *value ) {
+    while( value != NULL && *value != '\0' ) {
+        const char *end = strchr( value, ',' );
+        size_t length = end != NULL ? (size_t) ( end - value ) : strlen( value );
+        const CPUName *entry;
+
+        if( *value == '-' ) {
+            entry = cpuLookup( cpuFeatures, value + 1, length - 1 );
+            if( entry != NULL ) {
+                features &= ~entry->features;
+            }
+        }
+        else {
+            entry = cpuLookup( cpuTiers, value, length );
+            if( entry != NULL ) {
+                features &= entry->features;
+            }
+        }
+
+        value = end != NULL ? end + 1 : NULL;
+    }
+
+    return features;
+}
+
+/**
+ * @internal
+ *
+ * Binds the kernels of every algorithm to other CPU features, so the tests can compare the
+ * kernels of each tier in a single process. The features are restricted to the detected
+ * ones. The minimum buffer sizes go back to their defaults: calibrations that already ran
+ * are not run again.
+ *
+ * Not thread safe: no hash may be computed while the kernels are bound.
+ *
+ * @param features  HASH_CPU_* flags the kernels may use.
+ */
+void libhash::cpuBind( uint32_t features ) {
+    cpuSelected( ) = features & CPU::getDetected( );
+
+    crc32Rebind( );
+    crc64Rebind( );
+    md5Rebind( );
+    sha1Rebind( );
+    sha2Rebind( );
+}
+
+//=== Calibration implementation ==============================================
+
+/**
+ * @internal
+ *
+ * @brief Selects the kernels of an algorithm by measuring them.
+ *
+ * This is only done if the environment variable <tt>LIBHASH_CALIBRATE</tt> is set. The
+ * kernels are ordered from the simplest (index 0, always usable) to the widest. Each one
+ * is timed on buffers of 64 bytes to 64KB and the fastest kernel of each size is kept.
+ * Kernel <tt>k</tt> is then used from the smallest measured size where the winner of that
+ * size and of all larger sizes is <tt>k</tt> or a wider kernel. If it already wins on 64
+ * bytes, it is used for all sizes: the caller must still apply the minimum size the
+ * kernel accepts.
+ *
+ * The decision is kept for the process and, if <tt>LIBHASH_CALIBRATE</tt> is a file path,
+ * stored in that file to be reused by later processes with the same CPU features.
+ *
+ * @param name          Unique name of the set of kernels.
+ * @param kernels       Number of kernels, including the first one.
+ * @param run           Runs a kernel once.
+ * @param context       Context given to <tt>run</tt>.
+ * @param thresholds    Receives the minimum buffer size of the kernels 1 to
+ *                      <tt>kernels - 1</tt>; 0 if a kernel always wins and
+ *                      <tt>SIZE_MAX</tt> if it never wins.
+ *                      Left unchanged if the calibration is disabled.
+ *
+ * @return <tt>true</tt> if the thresholds were calibrated.
+ */
+bool libhash::cpuCalibrate( const char *name, unsigned kernels, CPUBenchmark run, const void *context, size_t thresholds[] ) {
+    const char *mode = getenv( HASH_CALIBRATE_ENV );
+    CPUCalibrationState &state = cpuCalibrationState( );
+    bool persistent;
+    unsigned winners[ CPU_CALIBRATE_CLASSES ];
+    std::vector<uint8_t> buffer( cpuCalibrateSizes[ CPU_CALIBRATE_CLASSES - 1 ] );
+    CPUCalibration entry;
+
+    if( mode == NULL || *mode == '\0' || strcmp( mode, "0" ) == 0 || kernels < 2 ) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard( state.lock );
+
+    persistent = strcmp( mode, "1" ) != 0;
+    if( persistent && state.path != mode ) {
+        cpuCalibrationLoad( state, mode );
+    }
+
+    for( size_t i = 0; i < state.entries.size( ); i++ ) {
+        if( state.entries[ i ].name == name && state.entries[ i ].thresholds.size( ) == kernels - 1 ) {
+            for( unsigned k = 1; k < kernels; k++ ) {
+                thresholds[ k - 1 ] = state.entries[ i ].thresholds[ k - 1 ];
+            }
+
+            return true;
+        }
+    }
+
+    for( size_t i = 0; i < buffer.size( ); i++ ) {
+        buffer[ i ] = (uint8_t) ( i * 0x9e3779b1 >> 24 );
+    }
+
+    for( int c = 0; c < CPU_CALIBRATE_CLASSES; c++ ) {
+        double best = -1;
+
+        winners[ c ] = 0;
+        for( unsigned k = 0; k < kernels; k++ ) {
+            double elapsed = cpuMeasure( run, context, k, buffer.data( ), cpuCalibrateSizes[ c ] );
+
+            if( elapsed >= 0 && ( best < 0 || elapsed < best ) ) {
+                best = elapsed;
+                winners[ c ] = k;
+            }
+        }
+    }
+
+    entry.name = name;
+    for( unsigned k = 1; k < kernels; k++ ) {
+        size_t threshold = SIZE_MAX;
+
+        for( int c = CPU_CALIBRATE_CLASSES - 1; c >= 0 && winners[ c ] >= k; c-- ) {
+            threshold = c > 0 ? cpuCalibrateSizes[ c ] : 0;
+        }
+
+        thresholds[ k - 1 ] = threshold;
+        entry.thresholds.push_back( threshold );
+    }
+
+    state.entries.push_back( entry );
+    if( persistent ) {
+        cpuCalibrationSave( state );
+    }
+
+    return true;
+}
+
+//=== C API implementation ====================================================
+
+/**
+ * @brief Retrieves the features supported by the CPU and the operating system.
+ *
+ * @return the HASH_CPU_* flags, ignoring the <tt>LIBHASH_CPU</tt> environment variable.
+ */
+uint32_t hash_cpu_get_detected( ) {
+    return CPU::getDetected( );
+}
+
+/**
+ * @brief Retrieves the CPU features used by the hashing kernels.
+ *
+ * @return the HASH_CPU_* flags, restricted by the <tt>LIBHASH_CPU</tt> environment
+ *         variable.
+ */
+uint32_t hash_cpu_get_features( ) {
+    return CPU::getFeatures( );
+}
+
+// EOF: cpu.cpp
@@ -0,0 +1,424 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc.cpp
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-09
+//
+// Description
+// CRC base class implementation, shared by all the CRC widths.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../include/libhash/defs.h"
+#include "../include/libhash/hashbase.h"
+#include "../include/libhash/crc8.h"
+#include "../include/libhash/crc16.h"
+#include "../include/libhash/crc24.h"
+#include "../include/libhash/crc32.h"
+#include "../include/libhash/crc64.h"
+
+using namespace libhash;
+
+//-----------------------------------------------------------------------------
+// MACROS
+//-----------------------------------------------------------------------------
+
+/** Size of the read buffer of updateFile(). */
+#define CRC_FILE_BUFFER         ( 1024 * 1024 )
+
+/** Minimum number of bytes per thread for updateParallel(). */
+#define CRC_PARALLEL_MIN        ( 256 * 1024 )
+
+/**
+ * Minimum number of bytes per thread for updateParallel() on 32 bits and more. Their
+ * folding kernels process a smaller segment faster than a thread starts.
+ */
+#define CRC_PARALLEL_MIN_WIDE   ( 1024 * 1024 )
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & STATIC VARIABLES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// CLASSES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+//=== CRCBaseT implementation =================================================
+
+/**
+ * @brief CRC base constructor.
+ *
+ * The values are truncated to <tt>Width</tt> bits.
+ *
+ * @param initValue     CRC initial value.
+ * @param polynomial    CRC polynomial.
+ * @param xorValue      Value to be XOR at the end of the CRC calculation.
+ * @param inReflect     Input reflection flag. If <tt>true</tt>, the input data is
+ *                      reflected before use.
+ * @param outReflect    Output reflection flag. If <tt>true</tt>, the output value is
+ *                      reflected.
+ */
+template<typename Register, int Width>
+CRCBaseT<Register, Width>::CRCBaseT( Register initValue,
+                                     Register polynomial,
+                                     Register xorValue,
+                                     bool inReflect,
+                                     bool outReflect ) : CRCBase( Width, inReflect, outReflect ) {
+    const Register mask = (Register) ~(Register) 0 >> ( sizeof ( Register ) * 8 - Width );
+
+    mInit = initValue & mask;
+    mPolynomial = polynomial & mask;
+    mXorValue = xorValue & mask;
+}
+
+template<typename Register, int Width>
+CRCBaseT<Register, Width>::~CRCBaseT( ) { }
+
+/**
+ * @copydoc HashingBase::init()
+ */
+template<typename Register, int Width>
+void CRCBaseT<Register, Width>::init( ) {
+    mState = isInputReflected( ) ? reflectRegister( mInit ) : mInit;
+}
+
+/**
+ * @copydoc HashingBase::update( const void *, size_t )
+ */
+template<typename Register, int Width>
+void CRCBaseT<Register, Width>::update( const void *data, size_t size ) {
+    mState = process( mState, data, size );
+}
+
+/**
+ * @brief Updates the CRC state using several threads.
+ *
+ * The buffer is split in one segment per thread. Each segment is processed concurrently
+ * from a zero register with the fastest kernel of the derived class, then the partial
+ * registers are merged in order by shifting the running register over the length of the
+ * next segment. Buffers too small to give each thread CRC_PARALLEL_MIN bytes
+ * (CRC_PARALLEL_MIN_WIDE for 32 bits and more) use fewer threads, down to a plain
+ * update().
+ *
+ * @param data      Data buffer use to update the current CRC.
+ * @param size      Number of bytes in <tt>data</tt>
+ * @param threads   Maximum number of threads to use, including the calling thread. If 0,
+ *                  the number of hardware threads is used.
+ */
+template<typename Register, int Width>
+void CRCBaseT<Register, Width>::updateParallel( const void *data, size_t size, unsigned threads ) {
+    const uint8_t *buffer = (const uint8_t *) data;
+    const size_t minimum = Width >= 32 ? CRC_PARALLEL_MIN_WIDE : CRC_PARALLEL_MIN;
+    size_t segment;
+    Register state;
+
+    if( threads == 0 ) {
+        threads = std::thread::hardware_concurrency( );
+    }
+
+    if( size / minimum < threads ) {
+        threads = (unsigned) ( size / minimum );
+    }
+
+    if( threads <= 1 ) {
+        update( data, size );
+        return;
+    }
+
+    // Segments are multiple of 64 bytes to keep the folding kernels on their fast path
+    segment = ( size / threads ) & ~( (size_t) 63 );
+
+    std::vector<Register> partial( threads );
+    std::vector<std::thread> workers( threads );
+
+    for( unsigned i = 1; i < threads; i++ ) {
+        const uint8_t *start = buffer + segment * i;
+        size_t length = ( i == threads - 1 ) ? size - segment * i : segment;
+
+        try {
+            workers[ i ] = std::thread( [ this, &partial, i, start, length ]( ) {
+                partial[ i ] = process( 0, start, length );
+            } );
+        }
+        catch( const std::system_error & ) {
+            partial[ i ] = process( 0, start, length );
+        }
+    }
+
+    // The calling thread processes the first segment from the current register
+    state = process( mState, buffer, segment );
+
+    for( unsigned i = 1; i < threads; i++ ) {
+        size_t length = ( i == threads - 1 ) ? size - segment * i : segment;
+
+        if( workers[ i ].joinable( ) ) {
+            workers[ i ].join( );
+        }
+
+        state = shift( state, length ) ^ partial[ i ];
+    }
+
+    mState = state;
+}
+
+/**
+ * @brief Updates the CRC state with the content of a file, skipping its holes.
+ *
+ * The data regions of the file are located with <tt>lseek( SEEK_DATA / SEEK_HOLE )</tt>
+ * and only these regions are read. A hole is a run of zero bytes: the register is moved
+ * over it with shift() in O(log N) steps instead of feeding the zeros through the tables.
+ * A sparse image with little data costs about as much as that data.
+ *
+ * On file systems or platforms without hole detection, the whole file is read.
+ *
+ * The file is read from offset 0 to its end with <tt>pread()</tt>; the file offset is
+ * changed by the hole detection.
+ *
+ * @param fd    Open file descriptor, readable and seekable.
+ *
+ * @return <tt>true</tt> on success or <tt>false</tt> on an I/O error (<tt>errno</tt> is
+ *         set). On error, the CRC state is undefined.
+ */
+template<typename Register, int Width>
+bool CRCBaseT<Register, Width>::updateFile( int fd ) {
+    std::vector<uint8_t> buffer( CRC_FILE_BUFFER );
+    struct stat info;
+    off_t offset = 0;
+    off_t end;
+
+    if( fstat( fd, &info ) != 0 ) {
+        return false;
+    }
+
+    end = info.st_size;
+
+    while( offset < end ) {
+        off_t data = offset;
+        off_t hole = end;
+
+#if defined( SEEK_DATA ) && defined( SEEK_HOLE )
+        data = lseek( fd, offset, SEEK_DATA );
+        if( data < 0 ) {
+            // ENXIO: no more data up to the end of the file; otherwise holes are not supported
+            data = ( errno == ENXIO ) ? end : offset;
+        }
+        else {
+            hole = lseek( fd, data, SEEK_HOLE );
+            if( hole < 0 || hole > end ) {
+                hole = end;
+            }
+        }
+#endif
+
+        if( data > offset ) {
+            mState = shift( mState, (size_t) ( data - offset ) );
+        }
+
+        for( offset = data; offset < hole; ) {
+            size_t length = (size_t) ( hole - offset ) < buffer.size( ) ? (size_t) ( hole - offset ) : buffer.size( );
+            ssize_t count = pread( fd, buffer.data( ), length, offset );
+
+            if( count < 0 && errno == EINTR ) {
+                continue;
+            }
+
+            if( count <= 0 ) {
+                // Truncated while reading
+                if( count == 0 ) {
+                    errno = EIO;
+                }
+
+                return false;
+            }
+
+            mState = process( mState, buffer.data( ), (size_t) count );
+            offset += count;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @copydoc HashingBase::getKernel()
+ *
+ * The CRCs without a hardware accelerated kernel report <tt>"slicing-by-16"</tt>.
+ */
+template<typename Register, int Width>
+const char *CRCBaseT<Register, Width>::getKernel( ) {
+    const char *kernel = getAccelerator( mPolynomial, isInputReflected( ) );
+
+    return kernel != NULL ? kernel : "slicing-by-16";
+}
+
+/**
+ * @copydoc HashingBase::finalize()
+ *
+ * The final value follows the Rocksoft model: the register is reflected if the output
+ * reflection differs from the domain the register was computed in, then XOR'ed with
+ * the final XOR value. The result is stored MSB first.
+ */
+template<typename Register, int Width>
+void CRCBaseT<Register, Width>::finalize( ) {
+    Register value = mState;
+
+    if( isInputReflected( ) != isOutputReflected( ) ) {
+        value = reflectRegister( value );
+    }
+
+    value ^= getXorValue( );
+
+    for( int i = 0; i < Width / 8; i++ ) {
+        mHash[ i ] = (uint8_t) ( value >> ( Width - 8 - 8 * i ) );
+    }
+
+    mState = 0;
+}
+
+/**
+ * @brief Combines the CRC of two consecutive blocks of data.
+ *
+ * Computes the CRC of the concatenation of A and B from the CRC of A, the CRC of B and
+ * the length of B, without processing the data again. The CRC of A is moved forward over
+ * the length of B by a multiplication with <tt>x^(8 * lenB) mod P</tt>, computed in
+ * O(log lenB) steps.
+ *
+ * @param crcA  Final CRC value of the first block.
+ * @param crcB  Final CRC value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ *
+ * @return the final CRC value of both blocks.
+ */
+template<typename Register, int Width>
+Register CRCBaseT<Register, Width>::combine( Register crcA, Register crcB, size_t lenB ) {
+    Register stateA = crcA ^ mXorValue;
+    Register initial = isInputReflected( ) ? reflectRegister( mInit ) : mInit;
+    Register delta;
+
+    // Final value to register value
+    if( isInputReflected( ) != isOutputReflected( ) ) {
+        stateA = reflectRegister( stateA );
+    }
+
+    // By linearity, only the difference with the initial register needs to be moved
+    delta = shift( stateA ^ initial, lenB );
+
+    if( isInputReflected( ) != isOutputReflected( ) ) {
+        delta = reflectRegister( delta );
+    }
+
+    return crcB ^ delta;
+}
+
+/**
+ * @brief Moves a CRC register forward over <tt>len</tt> zero bytes.
+ *
+ * @param state     CRC register, reflected if the input is reflected.
+ * @param len       Number of zero bytes.
+ *
+ * @return the register after processing <tt>len</tt> zero bytes.
+ */
+template<typename Register, int Width>
+Register CRCBaseT<Register, Width>::shift( Register state, size_t len ) {
+    if( isInputReflected( ) ) {
+        return reflectRegister( multiplyModulo( reflectRegister( state ), powerModulo( len ) ) );
+    }
+
+    return multiplyModulo( state, powerModulo( len ) );
+}
+
+/**
+ * @brief Multiplies two polynomials modulo the CRC polynomial.
+ *
+ * Both operands and the result are in normal (non-reflected) form.
+ */
+template<typename Register, int Width>
+Register CRCBaseT<Register, Width>::multiplyModulo( Register a, Register b ) {
+    const Register mask = (Register) ~(Register) 0 >> ( sizeof ( Register ) * 8 - Width );
+    const Register top = (Register) 1 << ( Width - 1 );
+    Register product = 0;
+
+    for( int i = Width - 1; i >= 0; i-- ) {
+        product = (Register) ( ( ( product & top ) ? ( product << 1 ) ^ mPolynomial : product << 1 ) & mask );
+
+        if( ( a >> i ) & 1 ) {
+            product ^= b;
+        }
+    }
+
+    return product;
+}
+
+/**
+ * @brief Computes <tt>x^(8 * len) mod P</tt> by square-and-multiply.
+ */
+template<typename Register, int Width>
+Register CRCBaseT<Register, Width>::powerModulo( size_t len ) {
+    Register result = 1;
+    // x^8 mod P, computed as x^4 * x^4 since x^8 does not fit in an 8-bits register
+    Register square = multiplyModulo( 0x10, 0x10 );
+
+    while( len ) {
+        if( len & 1 ) {
+            result = multiplyModulo( result, square );
+        }
+
+        square = multiplyModulo( square, square );
+        len >>= 1;
+    }
+
+    return result;
+}
+
+template class libhash::CRCBaseT<uint8_t, 8>;
+template class libhash::CRCBaseT<uint16_t, 16>;
+template class libhash::CRCBaseT<uint32_t, 24>;
+template class libhash::CRCBaseT<uint32_t, 32>;
+template class libhash::CRCBaseT<uint64_t, 64>;
+
+// EOF: crc.cpp
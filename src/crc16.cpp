@@ -38,6 +38,7 @@
 #include "../include/libhash/defs.h"
 #include "../include/libhash/hashbase.h"
 #include "../include/libhash/crc16.h"
+#include "../include/libhash/crc32.h"
 
 using namespace libhash;
 
@@ -53,15 +54,6 @@ using namespace libhash;
 // CONSTANTS & STATIC VARIABLES
 //-----------------------------------------------------------------------------
 
-bool CRC16_CCITT::msTableInit = false;
-uint16_t CRC16_CCITT::msLookup[ 256 ];
-
-bool CRC16_XModem::msTableInit = false;
-uint16_t CRC16_XModem::msLookup[ 256 ];
-
-bool CRC16_X25::msTableInit = false;
-uint16_t CRC16_X25::msLookup[ 256 ];
-
 //-----------------------------------------------------------------------------
 // CLASSES
 //-----------------------------------------------------------------------------
@@ -74,134 +66,61 @@ uint16_t CRC16_X25::msLookup[ 256 ];
 // IMPLEMENTATION
 //-----------------------------------------------------------------------------
 
-//=== CRC16Base implementation ================================================
-
-/**
- * @brief CRC-16 base constructor.
- *
- * @param initValue     CRC initial value.
- * @param polynomial    CRC polynomial.
- * @param xorValue      Value to be XOR at the end of the CRC calculation.
- * @param inReflect     Input reflection flag. If <tt>true</tt>, the input data is
- *                      reflected before use.
- * @param outReflect    Output reflection flag. If <tt>true</tt>, the output value is
- *                      reflected.
- */
-CRC16Base::CRC16Base( uint16_t initValue,
-                      uint16_t polynomial,
-                      uint16_t xorValue,
-                      bool inReflect,
-                      bool outReflect ) : CRCBase( 16, inReflect, outReflect ) {
-    mInit = initValue;
-    mPolynomial = polynomial;
-    mXorValue = xorValue;
-}
-
-#include <stdio.h>
-
-CRC16Base::~CRC16Base( ) { }
+//=== CRCAccelerator<uint16_t, 16> implementation =============================
 
 /**
- * @brief Initializes the lookup table.
- *
- * @param table     Array of the lookup entries to be calculated. The array must have room
- *                  for 256 entries of 16-bits each.
+ * @brief Processes the bulk of a buffer with a hardware accelerated kernel.
+ *
+ * A CRC-16 with the polynomial <tt>P</tt> is a CRC-32 with the polynomial
+ * <tt>P * x^16</tt>: the remainder of <tt>M * x^32</tt> by <tt>P * x^16</tt> is the
+ * remainder of <tt>M * x^16</tt> by <tt>P</tt>, times <tt>x^16</tt>. The register is
+ * widened to 32 bits and processed by the carry-less multiplication folding of the
+ * CRC-32 (see CRC32Base::accelerate()). Only the polynomials 0x1021 and 0x8005 have
+ * folding constants; other polynomials return 0 and are processed with the lookup tables.
+ *
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ * @param state         Current CRC register. Updated with the processed bytes.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>
+ *
+ * @return the number of bytes processed.
  */
-void CRC16Base::initLookupTable( uint16_t *table ) {
-    uint16_t remainder;
+size_t CRCAccelerator<uint16_t, 16>::accelerate( uint16_t polynomial, bool reflected, uint16_t &state, const uint8_t *buffer, size_t size ) {
+    uint32_t wide;
+    size_t done;
 
-    for( uint16_t n = 0; n < 256; n++ ) {
-        remainder = n << 8;
-
-        for( int i = 0 ; i < 8 ; i++ ) {
-            if ( remainder & 0x8000 ) {
-                remainder = ( ( remainder << 1 ) ^ mPolynomial );
-            }
-            else {
-
-                remainder = ( remainder << 1 );
-            }
-        }
-
-        table[ n ] = remainder;
+    if( polynomial != 0x1021 && polynomial != 0x8005 ) {
+        return 0;
     }
-}
 
-/**
- * @copydoc HashingBase::init()
- */
-void CRC16Base::init( ) {
-    mState = mInit;
-}
+    // In the reflected domain, the register R * x^16 is R in the low 16 bits
+    wide = reflected ? state : (uint32_t) state << 16;
+    done = CRC32Base::accelerate( (uint32_t) polynomial << 16, reflected, wide, buffer, size );
+    state = reflected ? (uint16_t) wide : (uint16_t) ( wide >> 16 );
 
-/**
- * @brief Update the CRC16 state.
- *
- * @param lookupTable   Lookup table to use
- * @param data          Data buffer use to update the current CRC.
- * @param size          Number of bytes in <tt>data</tt>
- */
-void CRC16Base::update( uint16_t *lookupTable, const void *data, size_t size ) {
-    uint8_t *buffer = (uint8_t *) data;
-    uint8_t b;
-
-    while( size-- ) {
-        if( isInputReflected( ) ) {
-            b = reflect( ( uint8_t ) * buffer );
-        }
-        else {
-            b = *buffer;
-        }
-
-        mState = lookupTable[ ( ( mState >> 8 )  ^ b ) & 0xff ] ^ ( mState << 8 );
-        buffer++;
-    }
+    return done;
 }
 
 /**
- * @copydoc HashingBase::finalize()
+ * @brief Retrieves the name of the kernel used by accelerate() on large buffers.
+ *
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ *
+ * @return the kernel name or <tt>NULL</tt> if the polynomial is not accelerated.
  */
-void CRC16Base::finalize( ) {
-    mState = mState ^getXorValue( );
-
-    if( isOutputReflected( ) ) {
-        mHash[0] = reflect( (uint8_t) ( mState & 0x00ff ) );
-        mHash[1] = reflect( (uint8_t) ( ( mState & 0xff00 ) >> 8 ) );
-    }
-    else {
-
-        mHash[ 0 ] = (uint8_t) ( ( ( mState & 0xff00 ) >> 8 ) );
-        mHash[ 1 ] = (uint8_t) ( mState & 0x00ff );
+const char *CRCAccelerator<uint16_t, 16>::getName( uint16_t polynomial, bool reflected ) {
+    if( polynomial != 0x1021 && polynomial != 0x8005 ) {
+        return NULL;
     }
 
-    mState = 0;
+    return CRC32Base::getAccelerator( (uint32_t) polynomial << 16, reflected );
 }
 
 //=== CRC16_CCITT implementation ==============================================
 
-/**
- * @brief Constructor
- *
- * Initializes the CRC with the polynomial 0x1021.
- */
-CRC16_CCITT::CRC16_CCITT( ) : CRC16Base( 0xffff, 0x1021, 0, false, false )  {
-    if( ! CRC16_CCITT::msTableInit ) {
-        // Initialize the lookup
-
-        initLookupTable( CRC16_CCITT::msLookup );
-        CRC16_CCITT::msTableInit = true;
-    }
-}
-
-CRC16_CCITT::~CRC16_CCITT( ) { }
-
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void CRC16_CCITT::update( const void *data, size_t size ) {
-
-    CRC16Base::update( CRC16_CCITT::msLookup, data, size );
-}
+template class libhash::Crc<16, 0x1021, 0xffff, 0x0000, false, false>;
 
 //void CRC16_CCITT::finalize( ) {
 //    mState = mState ^getXorValue( );
@@ -268,6 +187,32 @@ int hash_crc16_ccitt_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-16-CCITT handler's state using several threads.
+ *
+ * Same as {@link hash_crc16_ccitt_update} but large buffers are processed concurrently. See
+ * {@link CRC16Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-16-CCITT handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc16_ccitt_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC16_CCITT *crc = dynamic_cast<CRC16_CCITT *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-16-CCITT handler's state.
  *
@@ -322,6 +267,33 @@ int hash_crc16_ccitt_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Combines the CRC-16-CCITT values of two consecutive blocks of data.
+ *
+ * Computes the CRC-16-CCITT of the concatenation of A and B without processing the data
+ * again. See {@link CRC16Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-16-CCITT handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-16-CCITT value of the first block.
+ * @param crcB  CRC-16-CCITT value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-16-CCITT value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc16_ccitt_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB ) {
+    int rc = 0;
+    CRC16_CCITT *crc = dynamic_cast<CRC16_CCITT *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * Destroys an existing CRC-16-CCITT handler.
  *
@@ -344,28 +316,7 @@ int hash_crc16_ccitt_destroy( void *h ) {
 
 //=== CRC16_XMODEM implementation =============================================
 
-/**
- * @brief Constructor
- *
- * Initializes the CRC with the polynomial 0x1021.
- */
-CRC16_XModem::CRC16_XModem( ) : CRC16Base( 0, 0x1021, 0, false, false )  {
-    if( ! CRC16_XModem::msTableInit ) {
-        // Initialize the lookup
-        initLookupTable( CRC16_XModem::msLookup );
-        CRC16_XModem::msTableInit = true;
-    }
-}
-
-CRC16_XModem::~CRC16_XModem( ) { }
-
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void CRC16_XModem::update( const void *data, size_t size ) {
-
-    CRC16Base::update( CRC16_XModem::msLookup, data, size );
-}
+template class libhash::Crc<16, 0x1021, 0x0000, 0x0000, false, false>;
 
 /**
  * Creates a new CRC-16-XMODEM handler.
@@ -428,6 +379,32 @@ int hash_crc16_xmodem_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-16-XMODEM handler's state using several threads.
+ *
+ * Same as {@link hash_crc16_xmodem_update} but large buffers are processed concurrently. See
+ * {@link CRC16Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-16-XMODEM handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc16_xmodem_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC16_XModem *crc = dynamic_cast<CRC16_XModem *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-16-XMODEM handler's state.
  *
@@ -483,50 +460,55 @@ int hash_crc16_xmodem_get_value( void *h, uint8_t *buf, size_t len ) {
 }
 
 /**
- * Destroys an existing CRC-16-XMODEM handler.
+ * @brief Combines the CRC-16-XMODEM values of two consecutive blocks of data.
  *
- * @param h Pointer to a valid CRC-16-XMODEM handler. Cannot be <tt>NULL</tt>.
+ * Computes the CRC-16-XMODEM of the concatenation of A and B without processing the data
+ * again. See {@link CRC16Base::combine}.
  *
- * @return a non-zero value on success or 0 on error.
+ * @param h     Pointer to a valid CRC-16-XMODEM handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-16-XMODEM value of the first block.
+ * @param crcB  CRC-16-XMODEM value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-16-XMODEM value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
  */
-int hash_crc16_xmodem_destroy( void *h ) {
+int hash_crc16_xmodem_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB ) {
     int rc = 0;
     CRC16_XModem *crc = dynamic_cast<CRC16_XModem *> ( (HashingBase *) h );
 
-    if(  crc != NULL ) {
+    if(  crc != NULL && crcAB != NULL ) {
 
+        *crcAB = crc->combine( crcA, crcB, lenB );
         rc = 1;
-        delete crc;
     }
 
     return rc;
 }
 
-//=== CRC16_X25 implementation ================================================
-
 /**
- * @brief Constructor
+ * Destroys an existing CRC-16-XMODEM handler.
  *
- * Initializes the CRC with the polynomial 0x1021.
+ * @param h Pointer to a valid CRC-16-XMODEM handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 on error.
  */
-CRC16_X25::CRC16_X25( ) : CRC16Base( 0xffff, 0x1021, 0xffff, true, true ) {
-    if( ! CRC16_X25::msTableInit ) {
-        // Initialize the lookup table.
+int hash_crc16_xmodem_destroy( void *h ) {
+    int rc = 0;
+    CRC16_XModem *crc = dynamic_cast<CRC16_XModem *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
 
-        initLookupTable( CRC16_X25::msLookup  );
-        CRC16_X25::msTableInit = true;
+        rc = 1;
+        delete crc;
     }
-}
 
-CRC16_X25::~CRC16_X25( ) { }
+    return rc;
+}
 
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void CRC16_X25::update( const void *data, size_t size ) {
+//=== CRC16_X25 implementation ================================================
 
-    CRC16Base::update( CRC16_X25::msLookup, data, size );
-}
+template class libhash::Crc<16, 0x1021, 0xffff, 0xffff, true, true>;
 
 //void CRC16_X25::finalize( ) {
 //    mState = mState ^ getXorValue( );
@@ -593,6 +575,32 @@ int hash_crc16_x25_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-16-X25 handler's state using several threads.
+ *
+ * Same as {@link hash_crc16_x25_update} but large buffers are processed concurrently. See
+ * {@link CRC16Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-16-X25 handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc16_x25_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC16_X25 *crc = dynamic_cast<CRC16_X25 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-16-X25 handler's state.
  *
@@ -647,6 +655,33 @@ int hash_crc16_x25_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Combines the CRC-16-X25 values of two consecutive blocks of data.
+ *
+ * Computes the CRC-16-X25 of the concatenation of A and B without processing the data
+ * again. See {@link CRC16Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-16-X25 handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-16-X25 value of the first block.
+ * @param crcB  CRC-16-X25 value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-16-X25 value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc16_x25_combine( void *h, uint16_t crcA, uint16_t crcB, size_t lenB, uint16_t *crcAB ) {
+    int rc = 0;
+    CRC16_X25 *crc = dynamic_cast<CRC16_X25 *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * Destroys an existing CRC-16-X25 handler.
  *
@@ -35,9 +35,18 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <mutex>
 #include "../include/libhash/defs.h"
 #include "../include/libhash/hashbase.h"
+#include "../include/libhash/cpu.h"
 #include "../include/libhash/crc32.h"
+#include "calibrate.h"
+#include "crcfold.h"
+#include "kernels.h"
+
+#if defined( __x86_64__ )
+#    include <immintrin.h>
+#endif
 
 using namespace libhash;
 
@@ -45,26 +54,271 @@ using namespace libhash;
 // MACROS
 //-----------------------------------------------------------------------------
 
+/** CRC-32C reflected polynomial. */
+#define CRC32C_POLY_REFLECTED   0x82f63b78
+
+/** Block size of each stream when interleaving the CRC-32C instruction on large buffers. */
+#define CRC32C_LONG             8192
+
+/** Block size of each stream when interleaving the CRC-32C instruction on small buffers. */
+#define CRC32C_SHORT            256
+
 //-----------------------------------------------------------------------------
 // STRUCTURES & TYPEDEFS
 //-----------------------------------------------------------------------------
 
+/**
+ * @internal
+ *
+ * @brief Constants of the carry-less multiplication folding of a 32-bits CRC.
+ *
+ * Each pair of fold constants moves a 128-bits block forward over a given distance. For a
+ * non-reflected CRC, the low and high constants are <tt>x^D mod P</tt> and
+ * <tt>x^(D+64) mod P</tt>. For a reflected CRC, they are the 64-bits reversed
+ * <tt>x^(D+63) mod P</tt> and <tt>x^(D-1) mod P</tt> to account for the product of two
+ * reversed values being shifted by one bit.
+ */
+struct CRC32FoldConstants {
+    uint64_t    k2048[ 2 ];     ///< Fold over 256 bytes (AVX-512)
+    uint64_t    k512[ 2 ];      ///< Fold over 64 bytes
+    uint64_t    k384[ 2 ];      ///< Fold over 48 bytes
+    uint64_t    k256[ 2 ];      ///< Fold over 32 bytes
+    uint64_t    k128[ 2 ];      ///< Fold over 16 bytes
+    uint64_t    k96;            ///< Reduction of 128 bits to 96 bits
+    uint64_t    k64;            ///< Reduction of 96 bits to 64 bits
+    uint64_t    mu;             ///< Barrett constant: x^64 / P
+    uint64_t    poly;           ///< Polynomial with its x^32 term
+    bool        reflected;      ///< Input reflected flag
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Byte lookup tables of an operator appending zero bytes to a CRC-32C register.
+ *
+ * Table <tt>k</tt> applies the operator to byte <tt>k</tt> of the register.
+ */
+struct CRC32CShiftTables {
+    uint32_t    shift[ 4 ][ 256 ];
+} ;
+
+/**
+ * @internal
+ *
+ * @brief CRC-32C kernel, or <tt>NULL</tt> if the CPU does not support it. The folding
+ * kernels are in a CRCFoldKernels.
+ */
+struct CRC32Kernels {
+    /** CRC-32C with the SSE4.2 <tt>crc32</tt> instruction. */
+    uint32_t ( *crc32c )( uint32_t, const uint8_t *, size_t );
+
+    size_t      crc32cMin;      ///< Minimum number of bytes for <tt>crc32c</tt>
+} ;
+
+/** Folding kernels of the 32-bits CRCs. */
+typedef CRCFoldKernels<uint32_t, CRC32FoldConstants> CRC32FoldKernels;
+
 //-----------------------------------------------------------------------------
 // CONSTANTS & STATIC VARIABLES
 //-----------------------------------------------------------------------------
 
-bool CRC32::msTableInit = false;
-uint32_t CRC32::msLookup[ 256 ];
+/**
+ * @internal
+ *
+ * Reverses the order of the bits of a 32-bits value.
+ */
+static constexpr uint32_t crc32Reverse( uint32_t value ) {
+    uint32_t reversed = 0;
+
+    for( int i = 0; i < 32; i++ ) {
+        reversed = ( reversed << 1 ) | ( value & 1 );
+        value >>= 1;
+    }
 
-bool CRC32_BZip2::msTableInit = false;
-uint32_t CRC32_BZip2::msLookup[ 256 ];
+    return reversed;
+}
 
-bool CRC32C::msTableInit = false;
-uint32_t CRC32C::msLookup[ 256 ];
+/**
+ * @internal
+ *
+ * Multiplies a 32x32 GF(2) matrix by a vector. Column <tt>n</tt> of the matrix is the
+ * image of bit <tt>n</tt>.
+ */
+static constexpr uint32_t gf2MatrixTimes( const uint32_t *mat, uint32_t vec ) {
+    uint32_t sum = 0;
 
-//-----------------------------------------------------------------------------
-// CLASSES
-//-----------------------------------------------------------------------------
+    while( vec ) {
+        if( vec & 1 ) {
+            sum ^= *mat;
+        }
+
+        vec >>= 1;
+        mat++;
+    }
+
+    return sum;
+}
+
+/**
+ * @internal
+ *
+ * Squares a 32x32 GF(2) matrix.
+ */
+static constexpr void gf2MatrixSquare( uint32_t *square, const uint32_t *mat ) {
+    for( int n = 0; n < 32; n++ ) {
+        square[ n ] = gf2MatrixTimes( mat, mat[ n ] );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Builds the byte lookup tables of the operator appending <tt>len</tt> zero bytes to a
+ * raw (not pre or post conditioned) CRC-32C register.
+ *
+ * @param len       Number of zero bytes. Must be a power of 2.
+ */
+static constexpr CRC32CShiftTables crc32cMakeShift( size_t len ) {
+    CRC32CShiftTables zeros = { };
+    uint32_t even[ 32 ] = { };
+    uint32_t odd[ 32 ] = { };
+    uint32_t *op = even;
+
+    // Operator for one zero bit
+    odd[ 0 ] = CRC32C_POLY_REFLECTED;
+    for( int n = 1; n < 32; n++ ) {
+        odd[ n ] = 1u << ( n - 1 );
+    }
+
+    // Square up to one zero byte, then once more per power of 2
+    gf2MatrixSquare( even, odd );
+    gf2MatrixSquare( odd, even );
+    gf2MatrixSquare( even, odd );
+
+    while( len > 1 ) {
+        if( op == even ) {
+            gf2MatrixSquare( odd, even );
+            op = odd;
+        }
+        else {
+            gf2MatrixSquare( even, odd );
+            op = even;
+        }
+
+        len >>= 1;
+    }
+
+    for( uint32_t n = 0; n < 256; n++ ) {
+        zeros.shift[ 0 ][ n ] = gf2MatrixTimes( op, n );
+        zeros.shift[ 1 ][ n ] = gf2MatrixTimes( op, n << 8 );
+        zeros.shift[ 2 ][ n ] = gf2MatrixTimes( op, n << 16 );
+        zeros.shift[ 3 ][ n ] = gf2MatrixTimes( op, n << 24 );
+    }
+
+    return zeros;
+}
+
+/**
+ * @internal
+ *
+ * Computes <tt>x^n mod P</tt>.
+ *
+ * @param polynomial    CRC polynomial in normal form (without the x^32 term).
+ * @param n             Exponent.
+ */
+static constexpr uint32_t crc32XPowMod( uint32_t polynomial, unsigned n ) {
+    uint32_t remainder = 1;
+
+    while( n-- ) {
+        remainder = ( remainder & 0x80000000 ) ? ( remainder << 1 ) ^ polynomial : remainder << 1;
+    }
+
+    return remainder;
+}
+
+/**
+ * @internal
+ *
+ * Computes a pair of fold constants to move a 128-bits block over <tt>distance</tt> bits.
+ */
+static constexpr void crc32FoldPair( uint64_t *k, uint32_t polynomial, unsigned distance, bool reflected ) {
+    if( reflected ) {
+        k[ 0 ] = (uint64_t) crc32Reverse( crc32XPowMod( polynomial, distance + 63 ) ) << 32;
+        k[ 1 ] = (uint64_t) crc32Reverse( crc32XPowMod( polynomial, distance - 1 ) ) << 32;
+    }
+    else {
+        k[ 0 ] = crc32XPowMod( polynomial, distance );
+        k[ 1 ] = crc32XPowMod( polynomial, distance + 64 );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Computes the folding and reduction constants of a 32-bits CRC.
+ *
+ * @param polynomial    CRC polynomial in normal form (without the x^32 term).
+ * @param reflected     Input reflected flag.
+ */
+static constexpr CRC32FoldConstants crc32MakeFold( uint32_t polynomial, bool reflected ) {
+    CRC32FoldConstants constants = { };
+    uint64_t remainder = (uint64_t) polynomial << 32;
+    uint64_t mu = (uint64_t) 1 << 32;
+
+    crc32FoldPair( constants.k2048, polynomial, 2048, reflected );
+    crc32FoldPair( constants.k512, polynomial, 512, reflected );
+    crc32FoldPair( constants.k384, polynomial, 384, reflected );
+    crc32FoldPair( constants.k256, polynomial, 256, reflected );
+    crc32FoldPair( constants.k128, polynomial, 128, reflected );
+
+    // mu = x^64 / P. The x^64 term cancels with P * x^32 on the first step.
+    for( int i = 63; i >= 32; i-- ) {
+        if( remainder & ( (uint64_t) 1 << i ) ) {
+            mu |= (uint64_t) 1 << ( i - 32 );
+            remainder ^= ( ( (uint64_t) 1 << 32 ) | polynomial ) << ( i - 32 );
+        }
+    }
+
+    constants.reflected = reflected;
+    if( reflected ) {
+        constants.k96 = (uint64_t) crc32Reverse( crc32XPowMod( polynomial, 95 ) ) << 32;
+        constants.k64 = crc32Reverse( crc32XPowMod( polynomial, 63 ) );
+        constants.mu = ( (uint64_t) crc32Reverse( (uint32_t) mu ) << 1 ) | 1;
+        constants.poly = ( (uint64_t) crc32Reverse( polynomial ) << 1 ) | 1;
+    }
+    else {
+        constants.k96 = crc32XPowMod( polynomial, 96 );
+        constants.k64 = crc32XPowMod( polynomial, 64 );
+        constants.mu = mu;
+        constants.poly = ( (uint64_t) 1 << 32 ) | polynomial;
+    }
+
+    return constants;
+}
+
+/** Operators appending CRC32C_LONG zero bytes to a CRC-32C register. */
+static constexpr CRC32CShiftTables crc32cLongShift = crc32cMakeShift( CRC32C_LONG );
+
+/** Operators appending CRC32C_SHORT zero bytes to a CRC-32C register. */
+static constexpr CRC32CShiftTables crc32cShortShift = crc32cMakeShift( CRC32C_SHORT );
+
+/** Folding constants of CRC32 (reflected polynomial 0x04c11db7). */
+static constexpr CRC32FoldConstants crc32FoldReflected = crc32MakeFold( 0x04c11db7, true );
+
+/** Folding constants of CRC32_BZip2 (non-reflected polynomial 0x04c11db7). */
+static constexpr CRC32FoldConstants crc32FoldNormal = crc32MakeFold( 0x04c11db7, false );
+
+/** Folding constants of the CRC-16 polynomial 0x1021 (CCITT) widened to 32 bits, reflected. */
+static constexpr CRC32FoldConstants crc32FoldCCITTReflected = crc32MakeFold( 0x10210000, true );
+
+/** Folding constants of the CRC-16 polynomial 0x1021 (CCITT) widened to 32 bits. */
+static constexpr CRC32FoldConstants crc32FoldCCITTNormal = crc32MakeFold( 0x10210000, false );
+
+/** Folding constants of the CRC-16 polynomial 0x8005 (ARC) widened to 32 bits, reflected. */
+static constexpr CRC32FoldConstants crc32FoldARCReflected = crc32MakeFold( 0x80050000, true );
+
+/** Folding constants of the CRC-16 polynomial 0x8005 (ARC) widened to 32 bits. */
+static constexpr CRC32FoldConstants crc32FoldARCNormal = crc32MakeFold( 0x80050000, false );
 
 //-----------------------------------------------------------------------------
 // PROTOTYPES
@@ -74,121 +328,506 @@ uint32_t CRC32C::msLookup[ 256 ];
 // IMPLEMENTATION
 //-----------------------------------------------------------------------------
 
-//=== CRC32Base implementation ================================================
-
-CRC32Base::CRC32Base( uint32_t initValue,
-                      uint32_t polynomial,
-                      uint32_t xorValue,
-                      bool inReflect,
-                      bool outReflect ) : CRCBase( 32, inReflect, outReflect ) {
-    mInit = initValue;
-    mPolynomial = polynomial;
-    mXorValue = xorValue;
+/**
+ * @internal
+ *
+ * Applies a zero bytes operator built by crc32cMakeShift() to a CRC-32C register.
+ */
+static inline uint32_t crc32cShift( const uint32_t zeros[][ 256 ], uint32_t crc ) {
+    return zeros[ 0 ][ crc & 0xff ] ^ zeros[ 1 ][ ( crc >> 8 ) & 0xff ] ^
+            zeros[ 2 ][ ( crc >> 16 ) & 0xff ] ^ zeros[ 3 ][ crc >> 24 ];
 }
 
-CRC32Base::~CRC32Base( ) { }
+#if defined( __x86_64__ )
 
 /**
- * @brief Initializes the lookup table.
+ * @internal
+ *
+ * Computes a CRC-32C with the SSE4.2 <tt>crc32</tt> instruction, 8 bytes at a time.
  *
- * @param table     Array of the lookup entries to compute. The array must have room for
- *                  256 entries of 32-bits each.
+ * The instruction has a latency of 3 cycles but a throughput of 1 per cycle. On large
+ * buffers, three adjacent blocks are processed as independent streams and merged by
+ * shifting the CRC of the first blocks over the length of the following ones.
+ *
+ * @param crc       Current CRC register (reflected).
+ * @param buffer    Data to process.
+ * @param size      Number of bytes in <tt>buffer</tt>
+ *
+ * @return the updated CRC register.
  */
-void CRC32Base::initLookupTable( uint32_t *table ) {
-    uint32_t remainder;
+__attribute__(( target( "sse4.2" ) ))
+static uint32_t crc32cHardware( uint32_t crc, const uint8_t *buffer, size_t size ) {
+    uint64_t crc0, crc1, crc2;
+    uint64_t w0, w1, w2;
+    const uint8_t *end;
+
+    // Process the head up to an 8 bytes boundary
+    while( size && ( (uintptr_t) buffer & 7 ) ) {
+        crc = _mm_crc32_u8( crc, *buffer );
+        buffer++;
+        size--;
+    }
+
+    crc0 = crc;
+
+    // Three interleaved streams of CRC32C_LONG bytes each
+    while( size >= CRC32C_LONG * 3 ) {
+        crc1 = 0;
+        crc2 = 0;
+        end = buffer + CRC32C_LONG;
+
+        do {
+            ::memcpy( &w0, buffer, 8 );
+            ::memcpy( &w1, buffer + CRC32C_LONG, 8 );
+            ::memcpy( &w2, buffer + CRC32C_LONG * 2, 8 );
+            crc0 = _mm_crc32_u64( crc0, w0 );
+            crc1 = _mm_crc32_u64( crc1, w1 );
+            crc2 = _mm_crc32_u64( crc2, w2 );
+            buffer += 8;
+        } while( buffer < end );
+
+        crc0 = crc32cShift( crc32cLongShift.shift, (uint32_t) crc0 ) ^ crc1;
+        crc0 = crc32cShift( crc32cLongShift.shift, (uint32_t) crc0 ) ^ crc2;
+        buffer += CRC32C_LONG * 2;
+        size -= CRC32C_LONG * 3;
+    }
 
-    for( uint16_t n = 0; n < 256; n++ ) {
-        remainder = n << 24;
+    // Three interleaved streams of CRC32C_SHORT bytes each
+    while( size >= CRC32C_SHORT * 3 ) {
+        crc1 = 0;
+        crc2 = 0;
+        end = buffer + CRC32C_SHORT;
+
+        do {
+            ::memcpy( &w0, buffer, 8 );
+            ::memcpy( &w1, buffer + CRC32C_SHORT, 8 );
+            ::memcpy( &w2, buffer + CRC32C_SHORT * 2, 8 );
+            crc0 = _mm_crc32_u64( crc0, w0 );
+            crc1 = _mm_crc32_u64( crc1, w1 );
+            crc2 = _mm_crc32_u64( crc2, w2 );
+            buffer += 8;
+        } while( buffer < end );
+
+        crc0 = crc32cShift( crc32cShortShift.shift, (uint32_t) crc0 ) ^ crc1;
+        crc0 = crc32cShift( crc32cShortShift.shift, (uint32_t) crc0 ) ^ crc2;
+        buffer += CRC32C_SHORT * 2;
+        size -= CRC32C_SHORT * 3;
+    }
 
-        for( int i = 0 ; i < 8 ; i++ ) {
-            if ( remainder & 0x80000000 ) {
-                remainder = ( ( remainder << 1 ) ^ mPolynomial );
-            }
-            else {
+    // Remaining 8 bytes words
+    while( size >= 8 ) {
+        ::memcpy( &w0, buffer, 8 );
+        crc0 = _mm_crc32_u64( crc0, w0 );
+        buffer += 8;
+        size -= 8;
+    }
 
-                remainder = ( remainder << 1 );
-            }
-        }
+    // Tail
+    crc = (uint32_t) crc0;
+    while( size-- ) {
+        crc = _mm_crc32_u8( crc, *buffer );
+        buffer++;
+    }
+
+    return crc;
+}
+
+#endif  // __x86_64__
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Loads a 128-bits block. For a non-reflected CRC, the bytes are swapped so the first
+ * byte holds the highest degree coefficients.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static inline __m128i crc32FoldLoad( const uint8_t *buffer, bool reflected ) {
+    __m128i block = _mm_loadu_si128( (const __m128i *) buffer );
 
-        table[ n ] = remainder;
+    if( ! reflected ) {
+        block = _mm_shuffle_epi8( block, _mm_setr_epi8( 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) );
     }
+
+    return block;
 }
 
 /**
- * @copydoc HashingBase::init()
+ * @internal
+ *
+ * Moves a 128-bits block forward over the distance of the fold constants <tt>k</tt>.
  */
-void CRC32Base::init( ) {
-    mState = mInit;
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static inline __m128i crc32Fold128( __m128i block, __m128i k ) {
+    return _mm_xor_si128( _mm_clmulepi64_si128( block, k, 0x00 ), _mm_clmulepi64_si128( block, k, 0x11 ) );
 }
 
 /**
- * @brief Update the CRC32 state.
+ * @internal
+ *
+ * Folds the remaining 128-bits blocks in the accumulator and reduces it to a 32-bits CRC
+ * register using a Barrett reduction.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param accumulator   Folded value of the data processed so far.
+ * @param buffer        Remaining data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16.
  *
- * @param lookupTable   Lookup table to use
- * @param data          Data buffer use to update the current CRC.
- * @param size          Number of bytes in <tt>data</tt>
+ * @return the updated CRC register.
  */
-void CRC32Base::update( uint32_t *lookupTable, const void *data, size_t size ) {
-    uint8_t *buffer = (uint8_t *) data;
-    uint8_t b;
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static uint32_t crc32FoldReduce( const CRC32FoldConstants *constants, __m128i accumulator,
+                                 const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m128i k128 = _mm_loadu_si128( (const __m128i *) constants->k128 );
+    uint64_t lo, hi, t, u, q;
+    __m128i product;
+
+    while( size >= 16 ) {
+        accumulator = _mm_xor_si128( crc32Fold128( accumulator, k128 ), crc32FoldLoad( buffer, reflected ) );
+        buffer += 16;
+        size -= 16;
+    }
 
-    while( size-- ) {
-        if( isInputReflected( ) ) {
-            b = reflect( ( uint8_t ) * buffer );
-        }
-        else {
-            b = *buffer;
-        }
+    lo = _mm_cvtsi128_si64( accumulator );
+    hi = _mm_extract_epi64( accumulator, 1 );
 
-        mState = lookupTable[ ( ( mState >> 24 )  ^ b ) & 0xff ] ^ ( mState << 8 );
-        buffer++;
+    if( reflected ) {
+        // 128 bits to 96 bits
+        product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( lo ), _mm_cvtsi64_si128( constants->k96 ), 0x00 );
+        product = _mm_xor_si128( product, _mm_set_epi64x( hi >> 32, hi << 32 ) );
+
+        // 96 bits to 64 bits
+        t = (uint64_t) _mm_cvtsi128_si64( product ) >> 32;
+        u = _mm_extract_epi64( product, 1 ) ^
+                _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( t ), _mm_cvtsi64_si128( constants->k64 ), 0x00 ) );
+
+        // Barrett reduction
+        q = _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( u & 0xffffffff ), _mm_cvtsi64_si128( constants->mu ), 0x00 ) );
+        q &= 0xffffffff;
+        u ^= _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( q ), _mm_cvtsi64_si128( constants->poly ), 0x00 ) );
+
+        return (uint32_t) ( u >> 32 );
+    }
+
+    // 128 bits to 96 bits
+    product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( hi ), _mm_cvtsi64_si128( constants->k96 ), 0x00 );
+    product = _mm_xor_si128( product, _mm_set_epi64x( lo >> 32, lo << 32 ) );
+
+    // 96 bits to 64 bits
+    t = _mm_extract_epi64( product, 1 );
+    u = _mm_cvtsi128_si64( product ) ^
+            _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( t ), _mm_cvtsi64_si128( constants->k64 ), 0x00 ) );
+
+    // Barrett reduction
+    q = (uint64_t) _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( u >> 32 ), _mm_cvtsi64_si128( constants->mu ), 0x00 ) ) >> 32;
+    u ^= _mm_cvtsi128_si64( _mm_clmulepi64_si128( _mm_cvtsi64_si128( q ), _mm_cvtsi64_si128( constants->poly ), 0x00 ) );
+
+    return (uint32_t) u;
+}
+
+/**
+ * @internal
+ *
+ * Computes a 32-bits CRC by folding 64 bytes per iteration with PCLMULQDQ.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param crc           Current CRC register.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16 and
+ *                      at least 64.
+ *
+ * @return the updated CRC register.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static uint32_t crc32FoldPCLMUL( const CRC32FoldConstants *constants, uint32_t crc,
+                                 const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m128i k512 = _mm_loadu_si128( (const __m128i *) constants->k512 );
+    __m128i x0, x1, x2, x3;
+
+    x0 = crc32FoldLoad( buffer, reflected );
+    x1 = crc32FoldLoad( buffer + 16, reflected );
+    x2 = crc32FoldLoad( buffer + 32, reflected );
+    x3 = crc32FoldLoad( buffer + 48, reflected );
+    x0 = _mm_xor_si128( x0, reflected ? _mm_cvtsi32_si128( crc ) : _mm_set_epi32( crc, 0, 0, 0 ) );
+    buffer += 64;
+    size -= 64;
+
+    while( size >= 64 ) {
+        x0 = _mm_xor_si128( crc32Fold128( x0, k512 ), crc32FoldLoad( buffer, reflected ) );
+        x1 = _mm_xor_si128( crc32Fold128( x1, k512 ), crc32FoldLoad( buffer + 16, reflected ) );
+        x2 = _mm_xor_si128( crc32Fold128( x2, k512 ), crc32FoldLoad( buffer + 32, reflected ) );
+        x3 = _mm_xor_si128( crc32Fold128( x3, k512 ), crc32FoldLoad( buffer + 48, reflected ) );
+        buffer += 64;
+        size -= 64;
     }
+
+    // Fold the 4 accumulators into one
+    x3 = _mm_xor_si128( x3, crc32Fold128( x0, _mm_loadu_si128( (const __m128i *) constants->k384 ) ) );
+    x3 = _mm_xor_si128( x3, crc32Fold128( x1, _mm_loadu_si128( (const __m128i *) constants->k256 ) ) );
+    x3 = _mm_xor_si128( x3, crc32Fold128( x2, _mm_loadu_si128( (const __m128i *) constants->k128 ) ) );
+
+    return crc32FoldReduce( constants, x3, buffer, size );
 }
 
 /**
- * @copydoc HashingBase::finalize()
+ * @internal
+ *
+ * Loads a 512-bits block. See crc32FoldLoad().
  */
-void CRC32Base::finalize( ) {
-    mState = mState ^getXorValue( );
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static inline __m512i crc32FoldLoad512( const uint8_t *buffer, bool reflected ) {
+    __m512i block = _mm512_loadu_si512( buffer );
 
-    if( isOutputReflected( ) ) {
-        mHash[ 0 ] = reflect( (uint8_t) ( mState & 0x000000ff ) );
-        mHash[ 1 ] = reflect( (uint8_t) ( ( mState & 0x0000ff00 ) >> 8 ) );
-        mHash[ 2 ] = reflect( (uint8_t) ( ( mState & 0x00ff0000 ) >> 16 ) );
-        mHash[ 3 ] = reflect( (uint8_t) ( ( mState & 0xff000000 ) >> 24 ) );
+    if( ! reflected ) {
+        block = _mm512_shuffle_epi8( block, _mm512_maskz_broadcast_i32x4( 0xffff,
+                _mm_setr_epi8( 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) ) );
     }
-    else {
-        mHash[ 0 ] = (uint8_t) ( ( mState & 0xff000000 ) >> 24 );
-        mHash[ 1 ] = (uint8_t) ( ( mState & 0x00ff0000 ) >> 16 );
-        mHash[ 2 ] = (uint8_t) ( ( mState & 0x0000ff00 ) >> 8 );
-        mHash[ 3 ] = (uint8_t) ( mState & 0x000000ff );
+
+    return block;
+}
+
+/**
+ * @internal
+ *
+ * Moves the four 128-bits lanes of a 512-bits block forward. See crc32Fold128().
+ */
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static inline __m512i crc32Fold512( __m512i block, __m512i k ) {
+    return _mm512_xor_si512( _mm512_clmulepi64_epi128( block, k, 0x00 ), _mm512_clmulepi64_epi128( block, k, 0x11 ) );
+}
+
+/**
+ * @internal
+ *
+ * Computes a 32-bits CRC by folding 256 bytes per iteration with the AVX-512 VPCLMULQDQ
+ * instruction.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param crc           Current CRC register.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16 and
+ *                      at least 256.
+ *
+ * @return the updated CRC register.
+ */
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static uint32_t crc32FoldVPCLMUL( const CRC32FoldConstants *constants, uint32_t crc,
+                                  const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m512i k2048 = _mm512_maskz_broadcast_i32x4( 0xffff, _mm_loadu_si128( (const __m128i *) constants->k2048 ) );
+    __m512i k512 = _mm512_maskz_broadcast_i32x4( 0xffff, _mm_loadu_si128( (const __m128i *) constants->k512 ) );
+    __m512i z0, z1, z2, z3;
+    __m128i x;
+
+    z0 = crc32FoldLoad512( buffer, reflected );
+    z1 = crc32FoldLoad512( buffer + 64, reflected );
+    z2 = crc32FoldLoad512( buffer + 128, reflected );
+    z3 = crc32FoldLoad512( buffer + 192, reflected );
+    z0 = _mm512_xor_si512( z0, _mm512_inserti32x4( _mm512_setzero_si512( ),
+            reflected ? _mm_cvtsi32_si128( crc ) : _mm_set_epi32( crc, 0, 0, 0 ), 0 ) );
+    buffer += 256;
+    size -= 256;
+
+    while( size >= 256 ) {
+        z0 = _mm512_xor_si512( crc32Fold512( z0, k2048 ), crc32FoldLoad512( buffer, reflected ) );
+        z1 = _mm512_xor_si512( crc32Fold512( z1, k2048 ), crc32FoldLoad512( buffer + 64, reflected ) );
+        z2 = _mm512_xor_si512( crc32Fold512( z2, k2048 ), crc32FoldLoad512( buffer + 128, reflected ) );
+        z3 = _mm512_xor_si512( crc32Fold512( z3, k2048 ), crc32FoldLoad512( buffer + 192, reflected ) );
+        buffer += 256;
+        size -= 256;
     }
 
-    mState = 0;
+    // Fold the 4 accumulators into one, then its 4 lanes into one
+    z1 = _mm512_xor_si512( z1, crc32Fold512( z0, k512 ) );
+    z2 = _mm512_xor_si512( z2, crc32Fold512( z1, k512 ) );
+    z3 = _mm512_xor_si512( z3, crc32Fold512( z2, k512 ) );
+
+    x = _mm512_maskz_extracti32x4_epi32( 0xf, z3, 3 );
+    x = _mm_xor_si128( x, crc32Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 0 ), _mm_loadu_si128( (const __m128i *) constants->k384 ) ) );
+    x = _mm_xor_si128( x, crc32Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 1 ), _mm_loadu_si128( (const __m128i *) constants->k256 ) ) );
+    x = _mm_xor_si128( x, crc32Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 2 ), _mm_loadu_si128( (const __m128i *) constants->k128 ) ) );
+
+    return crc32FoldReduce( constants, x, buffer, size );
 }
 
-//=== CRC32 implementation ====================================================
+/**
+ * @internal
+ *
+ * Runs a CRC-32C kernel for cpuCalibrate(): the lookup tables (0) or the
+ * <tt>crc32</tt> instruction (1).
+ */
+static bool crc32cBenchmark( const void *context, unsigned kernel, const uint8_t *buffer, size_t size ) {
+    static volatile uint32_t sink;
+    const CRC32Kernels *kernels = (const CRC32Kernels *) context;
+
+    sink = kernel == 0 ? CRCSlicing<CRC32C>::compute( sink, buffer, size ) : kernels->crc32c( sink, buffer, size );
+
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Selects the CRC-32C kernel supported by the CPU (see CPU::getFeatures()). The minimum
+ * buffer size is a default until it is calibrated.
+ */
+static CRC32Kernels crc32Bind( ) {
+    CRC32Kernels kernels = { NULL, 0 };
+
+    if( CPU::has( HASH_CPU_SSE42 ) ) {
+        kernels.crc32c = crc32cHardware;
+    }
+
+    return kernels;
+}
+
+/**
+ * Kernels, bound when the library is loaded. Before that, they are all <tt>NULL</tt> and
+ * the lookup tables are used. The minimum sizes are only changed by the calibration.
+ */
+static CRC32Kernels crc32Kernels = crc32Bind( );
+
+/**
+ * @internal
+ *
+ * Selects the folding kernels supported by the CPU, calibrated with the constants of the
+ * reflected polynomial 0x04c11db7.
+ */
+static CRC32FoldKernels crc32FoldBind( ) {
+    return crcFoldBind<uint32_t, CRC32FoldConstants>( "crc32-fold", "crc32-fold-wide", crc32FoldPCLMUL, crc32FoldVPCLMUL,
+                                                      CRCSlicing<CRC32>::compute, &crc32FoldReflected );
+}
+
+/** Folding kernels, bound when the library is loaded. */
+static CRC32FoldKernels crc32Fold = crc32FoldBind( );
+
+/**
+ * @internal
+ *
+ * Measures the minimum buffer size of the <tt>crc32</tt> instruction with cpuCalibrate(),
+ * the first time a CRC-32C could use it. Calibrating on first use rather than when the
+ * library is loaded keeps the measure out of the start up of the processes that never
+ * compute a CRC. Must be called before reading <tt>crc32Kernels.crc32cMin</tt>.
+ */
+static void crc32cCalibrate( ) {
+    static std::once_flag once;
+
+    std::call_once( once, [ ]( ) {
+        size_t thresholds[ 1 ];
+
+        if( cpuCalibrate( "crc32c", 2, crc32cBenchmark, &crc32Kernels, thresholds ) ) {
+            crc32Kernels.crc32cMin = thresholds[ 0 ];
+        }
+    } );
+}
+
+#endif  // __x86_64__
+
+//=== CRCAccelerator<uint32_t, 32> implementation =============================
+
+/**
+ * @brief Processes the bulk of a buffer with a hardware accelerated kernel.
+ *
+ * Only the CRC-32 polynomials with a dedicated kernel are accelerated: CRC-32C uses the
+ * SSE4.2 <tt>crc32</tt> instruction and the polynomial 0x04c11db7 uses the carry-less
+ * multiplication folding (reflected or not). Other polynomials return 0 and are entirely
+ * processed with the lookup tables.
+ *
+ * The folding also accepts the CRC-16 polynomials 0x1021 and 0x8005 multiplied by x^16
+ * (0x10210000 and 0x80050000). A CRC-16 register <tt>R</tt> is then the 32-bits register
+ * <tt>R * x^16</tt>: <tt>R << 16</tt>, or <tt>R</tt> itself in the reflected domain.
+ * See CRC16Base::accelerate().
+ *
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ * @param state         Current CRC register. Updated with the processed bytes.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>
+ *
+ * @return the number of bytes processed.
+ */
+size_t CRCAccelerator<uint32_t, 32>::accelerate( uint32_t polynomial, bool reflected, uint32_t &state, const uint8_t *buffer, size_t size ) {
+#if defined( __x86_64__ )
+    if( polynomial == 0x1edc6f41 && reflected && crc32Kernels.crc32c != NULL ) {
+        crc32cCalibrate( );
+        if( size >= crc32Kernels.crc32cMin ) {
+            state = crc32Kernels.crc32c( state, buffer, size );
+            return size;
+        }
+    }
+
+    if( polynomial == 0x04c11db7 ) {
+        return crcFoldUpdate( crc32Fold, reflected ? &crc32FoldReflected : &crc32FoldNormal, &state, buffer, size );
+    }
+
+    if( polynomial == 0x10210000 ) {
+        return crcFoldUpdate( crc32Fold, reflected ? &crc32FoldCCITTReflected : &crc32FoldCCITTNormal, &state, buffer, size );
+    }
+
+    if( polynomial == 0x80050000 ) {
+        return crcFoldUpdate( crc32Fold, reflected ? &crc32FoldARCReflected : &crc32FoldARCNormal, &state, buffer, size );
+    }
+#else
+    (void) polynomial;
+    (void) reflected;
+    (void) state;
+    (void) buffer;
+    (void) size;
+#endif
+
+    return 0;
+}
 
 /**
- * @brief Constructor
+ * @brief Retrieves the name of the kernel used by accelerate() on large buffers.
  *
- * Initializes the CRC with the polynomial 0x04c11db7.
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ *
+ * @return the kernel name or <tt>NULL</tt> if the polynomial is not accelerated.
  */
-CRC32::CRC32( ) : CRC32Base( 0xffffffff, 0x04c11db7, 0xffffffff, true, true ) {
-    if( ! CRC32::msTableInit ) {
-        // Initialize the lookup
-        initLookupTable( CRC32::msLookup );
-        CRC32::msTableInit = true;
+const char *CRCAccelerator<uint32_t, 32>::getName( uint32_t polynomial, bool reflected ) {
+#if defined( __x86_64__ )
+    if( polynomial == 0x1edc6f41 && reflected && crc32Kernels.crc32c != NULL ) {
+        crc32cCalibrate( );
+        if( crc32Kernels.crc32cMin != SIZE_MAX ) {
+            return "sse4.2";
+        }
+    }
+
+    if( polynomial == 0x04c11db7 || polynomial == 0x10210000 || polynomial == 0x80050000 ) {
+        return crcFoldName( crc32Fold );
     }
+#else
+    (void) polynomial;
+    (void) reflected;
+#endif
+
+    return NULL;
 }
 
+//=== Kernel binding ==========================================================
+
 /**
- * @copydoc HashingBase::update( const void *, size_t )
+ * @internal
+ *
+ * Binds the CRC-32C and folding kernels again after cpuBind() changed the CPU features.
+ * The minimum buffer sizes go back to their defaults.
  */
-void CRC32::update( const void *data, size_t size ) {
-    CRC32Base::update( CRC32::msLookup, data, size );
+void libhash::crc32Rebind( ) {
+#if defined( __x86_64__ )
+    crc32Kernels = crc32Bind( );
+    crc32Fold = crc32FoldBind( );
+#endif
 }
 
+//=== CRC32 implementation ====================================================
+
+template class libhash::Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, true, true>;
+
 /**
  * Creates a new CRC-32 handler.
  *
@@ -249,6 +888,55 @@ int hash_crc32_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-32 handler's state using several threads.
+ *
+ * Same as {@link hash_crc32_update} but large buffers are processed concurrently. See
+ * {@link CRC32Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-32 handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC32 *crc = dynamic_cast<CRC32 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-32 handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc32_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC32Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-32 handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc32_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC32 *crc = dynamic_cast<CRC32 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-32 handler's state.
  *
@@ -303,6 +991,33 @@ int hash_crc32_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Combines the CRC-32 values of two consecutive blocks of data.
+ *
+ * Computes the CRC-32 of the concatenation of A and B without processing the data
+ * again. See {@link CRC32Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-32 handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-32 value of the first block.
+ * @param crcB  CRC-32 value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-32 value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB ) {
+    int rc = 0;
+    CRC32 *crc = dynamic_cast<CRC32 *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * Destroys an existing CRC-32 handler.
  *
@@ -325,25 +1040,7 @@ int hash_crc32_destroy( void *h ) {
 
 //=== CRC32C implementation ===================================================
 
-/**
- * @brief Constructor
- *
- * Initializes the CRC with the polynomial 0x1edc6f41.
- */
-CRC32C::CRC32C( ) : CRC32Base( 0xffffffff, 0x1edc6f41, 0xffffffff, true, true ) {
-    if( ! CRC32C::msTableInit ) {
-        // Initialize the lookup table.
-        initLookupTable( CRC32C::msLookup  );
-        CRC32C::msTableInit = true;
-    }
-}
-
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void CRC32C::update( const void *data, size_t size ) {
-    CRC32Base::update( CRC32C::msLookup, data, size );
-}
+template class libhash::Crc<32, 0x1edc6f41, 0xffffffff, 0xffffffff, true, true>;
 
 /**
  * Creates a new CRC-32C handler.
@@ -405,6 +1102,55 @@ int hash_crc32c_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-32C handler's state using several threads.
+ *
+ * Same as {@link hash_crc32c_update} but large buffers are processed concurrently. See
+ * {@link CRC32Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-32C handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32c_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC32C *crc = dynamic_cast<CRC32C *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-32C handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc32c_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC32Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-32C handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc32c_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC32C *crc = dynamic_cast<CRC32C *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-32C handler's state.
  *
@@ -459,6 +1205,33 @@ int hash_crc32c_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Combines the CRC-32C values of two consecutive blocks of data.
+ *
+ * Computes the CRC-32C of the concatenation of A and B without processing the data
+ * again. See {@link CRC32Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-32C handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-32C value of the first block.
+ * @param crcB  CRC-32C value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-32C value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32c_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB ) {
+    int rc = 0;
+    CRC32C *crc = dynamic_cast<CRC32C *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * Destroys an existing CRC-32C handler.
  *
@@ -480,25 +1253,7 @@ int hash_crc32c_destroy( void *h ) {
 
 //=== CRC32_BZip2 implementation ==============================================
 
-/**
- * @brief Constructor
- *
- * Initializes the CRC with the polynomial 0x1edc6f41.
- */
-CRC32_BZip2::CRC32_BZip2( ) : CRC32Base( 0xffffffff, 0x04c11db7, 0xffffffff, false, false ) {
-    if( ! CRC32_BZip2::msTableInit ) {
-        // Initialize the lookup table.
-        initLookupTable( CRC32_BZip2::msLookup  );
-        CRC32_BZip2::msTableInit = true;
-    }
-}
-
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void CRC32_BZip2::update( const void *data, size_t size ) {
-    CRC32Base::update( CRC32_BZip2::msLookup, data, size );
-}
+template class libhash::Crc<32, 0x04c11db7, 0xffffffff, 0xffffffff, false, false>;
 
 /**
  * Creates a new CRC-32C handler.
@@ -560,6 +1315,55 @@ int hash_crc32bzip2_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Updates the specified CRC-32/BZip2 handler's state using several threads.
+ *
+ * Same as {@link hash_crc32bzip2_update} but large buffers are processed concurrently. See
+ * {@link CRC32Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-32/BZip2 handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32bzip2_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC32_BZip2 *crc = dynamic_cast<CRC32_BZip2 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-32/BZip2 handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc32bzip2_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC32Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-32/BZip2 handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc32bzip2_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC32_BZip2 *crc = dynamic_cast<CRC32_BZip2 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
 /**
  * @brief Finalizes the specified CRC-32C handler's state.
  *
@@ -614,6 +1418,33 @@ int hash_crc32bzip2_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
+/**
+ * @brief Combines the CRC-32/BZip2 values of two consecutive blocks of data.
+ *
+ * Computes the CRC-32/BZip2 of the concatenation of A and B without processing the data
+ * again. See {@link CRC32Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-32/BZip2 handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-32/BZip2 value of the first block.
+ * @param crcB  CRC-32/BZip2 value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-32/BZip2 value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc32bzip2_combine( void *h, uint32_t crcA, uint32_t crcB, size_t lenB, uint32_t *crcAB ) {
+    int rc = 0;
+    CRC32_BZip2 *crc = dynamic_cast<CRC32_BZip2 *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
 /**
  * Destroys an existing CRC-32C handler.
  *
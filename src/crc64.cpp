@@ -0,0 +1,1150 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crc64.cpp
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-16
+//
+// Description
+// CRC-64 hashing algorithm implementation.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/libhash/defs.h"
+#include "../include/libhash/hashbase.h"
+#include "../include/libhash/cpu.h"
+#include "../include/libhash/crc64.h"
+#include "calibrate.h"
+#include "crcfold.h"
+#include "kernels.h"
+
+#if defined( __x86_64__ )
+#    include <immintrin.h>
+#endif
+
+using namespace libhash;
+
+//-----------------------------------------------------------------------------
+// MACROS
+//-----------------------------------------------------------------------------
+
+/** ECMA-182 polynomial, used by CRC64_ECMA182 and CRC64_XZ. */
+#define CRC64_POLY_ECMA         0x42f0e1eba9ea3693
+
+/** NVMe polynomial. */
+#define CRC64_POLY_NVME         0xad93d23594c93659
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * @brief Constants of the carry-less multiplication folding of a 64-bits CRC.
+ *
+ * The fold constants are the same as for a 32-bits CRC (see crc32.cpp): for a
+ * non-reflected CRC, the low and high constants are <tt>x^D mod P</tt> and
+ * <tt>x^(D+64) mod P</tt>; for a reflected CRC, they are the reversed
+ * <tt>x^(D+63) mod P</tt> and <tt>x^(D-1) mod P</tt>. With a 64-bits register, the
+ * final 128-bits block is folded once more into a 128-bits value which is reduced with a
+ * Barrett reduction.
+ */
+struct CRC64FoldConstants {
+    uint64_t    k2048[ 2 ];     ///< Fold over 256 bytes (AVX-512)
+    uint64_t    k512[ 2 ];      ///< Fold over 64 bytes
+    uint64_t    k384[ 2 ];      ///< Fold over 48 bytes
+    uint64_t    k256[ 2 ];      ///< Fold over 32 bytes
+    uint64_t    k128[ 2 ];      ///< Fold over 16 bytes
+    uint64_t    k64;            ///< Fold of the last block: x^128 mod P
+    uint64_t    mu;             ///< Barrett constant: x^128 / P, without its x^64 term
+    uint64_t    poly;           ///< Polynomial without its x^64 term
+    bool        reflected;      ///< Input reflected flag
+} ;
+
+/** Folding kernels of the 64-bits CRCs. */
+typedef CRCFoldKernels<uint64_t, CRC64FoldConstants> CRC64FoldKernels;
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & STATIC VARIABLES
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * Reverses the order of the bits of a 64-bits value.
+ */
+static constexpr uint64_t crc64Reverse( uint64_t value ) {
+    uint64_t reversed = 0;
+
+    for( int i = 0; i < 64; i++ ) {
+        reversed = ( reversed << 1 ) | ( value & 1 );
+        value >>= 1;
+    }
+
+    return reversed;
+}
+
+/**
+ * @internal
+ *
+ * Computes <tt>x^n mod P</tt>.
+ *
+ * @param polynomial    CRC polynomial in normal form (without the x^64 term).
+ * @param n             Exponent.
+ */
+static constexpr uint64_t crc64XPowMod( uint64_t polynomial, unsigned n ) {
+    uint64_t remainder = 1;
+
+    while( n-- ) {
+        remainder = ( remainder >> 63 ) ? ( remainder << 1 ) ^ polynomial : remainder << 1;
+    }
+
+    return remainder;
+}
+
+/**
+ * @internal
+ *
+ * Computes a pair of fold constants to move a 128-bits block over <tt>distance</tt> bits.
+ */
+static constexpr void crc64FoldPair( uint64_t *k, uint64_t polynomial, unsigned distance, bool reflected ) {
+    if( reflected ) {
+        k[ 0 ] = crc64Reverse( crc64XPowMod( polynomial, distance + 63 ) );
+        k[ 1 ] = crc64Reverse( crc64XPowMod( polynomial, distance - 1 ) );
+    }
+    else {
+        k[ 0 ] = crc64XPowMod( polynomial, distance );
+        k[ 1 ] = crc64XPowMod( polynomial, distance + 64 );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Computes the folding and reduction constants of a 64-bits CRC.
+ *
+ * @param polynomial    CRC polynomial in normal form (without the x^64 term).
+ * @param reflected     Input reflected flag.
+ */
+static constexpr CRC64FoldConstants crc64MakeFold( uint64_t polynomial, bool reflected ) {
+    CRC64FoldConstants constants = { };
+    uint64_t remainder = polynomial;
+    uint64_t mu = 0;
+
+    crc64FoldPair( constants.k2048, polynomial, 2048, reflected );
+    crc64FoldPair( constants.k512, polynomial, 512, reflected );
+    crc64FoldPair( constants.k384, polynomial, 384, reflected );
+    crc64FoldPair( constants.k256, polynomial, 256, reflected );
+    crc64FoldPair( constants.k128, polynomial, 128, reflected );
+
+    // mu = x^128 / P. The x^128 term cancels with P * x^64 on the first step, leaving
+    // P * x^64 in the remainder; only its upper 64 bits decide the next quotient bits.
+    for( int i = 63; i >= 0; i-- ) {
+        if( ( remainder >> i ) & 1 ) {
+            mu |= (uint64_t) 1 << i;
+            remainder ^= (uint64_t) 1 << i;
+
+            if( i > 0 ) {
+                remainder ^= polynomial >> ( 64 - i );
+            }
+        }
+    }
+
+    constants.reflected = reflected;
+    if( reflected ) {
+        constants.k64 = crc64Reverse( crc64XPowMod( polynomial, 127 ) );
+        constants.mu = crc64Reverse( mu );
+        constants.poly = crc64Reverse( polynomial );
+    }
+    else {
+        constants.k64 = crc64XPowMod( polynomial, 128 );
+        constants.mu = mu;
+        constants.poly = polynomial;
+    }
+
+    return constants;
+}
+
+/** Folding constants of CRC64_ECMA182 (non-reflected ECMA-182 polynomial). */
+static constexpr CRC64FoldConstants crc64FoldEcma = crc64MakeFold( CRC64_POLY_ECMA, false );
+
+/** Folding constants of CRC64_XZ (reflected ECMA-182 polynomial). */
+static constexpr CRC64FoldConstants crc64FoldXZ = crc64MakeFold( CRC64_POLY_ECMA, true );
+
+/** Folding constants of CRC64_NVMe (reflected NVMe polynomial). */
+static constexpr CRC64FoldConstants crc64FoldNVMe = crc64MakeFold( CRC64_POLY_NVME, true );
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Loads a 128-bits block. For a non-reflected CRC, the bytes are swapped so the first
+ * byte holds the highest degree coefficients.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static inline __m128i crc64FoldLoad( const uint8_t *buffer, bool reflected ) {
+    __m128i block = _mm_loadu_si128( (const __m128i *) buffer );
+
+    if( ! reflected ) {
+        block = _mm_shuffle_epi8( block, _mm_setr_epi8( 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) );
+    }
+
+    return block;
+}
+
+/**
+ * @internal
+ *
+ * Moves a 128-bits block forward over the distance of the fold constants <tt>k</tt>.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static inline __m128i crc64Fold128( __m128i block, __m128i k ) {
+    return _mm_xor_si128( _mm_clmulepi64_si128( block, k, 0x00 ), _mm_clmulepi64_si128( block, k, 0x11 ) );
+}
+
+/**
+ * @internal
+ *
+ * Folds the remaining 128-bits blocks in the accumulator and reduces it to a 64-bits CRC
+ * register using a Barrett reduction.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param accumulator   Folded value of the data processed so far.
+ * @param buffer        Remaining data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16.
+ *
+ * @return the updated CRC register.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static uint64_t crc64FoldReduce( const CRC64FoldConstants *constants, __m128i accumulator,
+                                 const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m128i k128 = _mm_loadu_si128( (const __m128i *) constants->k128 );
+    uint64_t lo, hi, q;
+    __m128i product;
+
+    while( size >= 16 ) {
+        accumulator = _mm_xor_si128( crc64Fold128( accumulator, k128 ), crc64FoldLoad( buffer, reflected ) );
+        buffer += 16;
+        size -= 16;
+    }
+
+    if( reflected ) {
+        // Fold the first 64 bits over the last 64 bits: R = A * x^64 mod P, 128 bits
+        product = _mm_clmulepi64_si128( accumulator, _mm_cvtsi64_si128( constants->k64 ), 0x00 );
+        hi = _mm_cvtsi128_si64( product ) ^ _mm_extract_epi64( accumulator, 1 );
+        lo = _mm_extract_epi64( product, 1 );
+
+        // Barrett reduction. The reversed products are one bit short of the register.
+        product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( hi ), _mm_cvtsi64_si128( constants->mu ), 0x00 );
+        q = hi ^ ( (uint64_t) _mm_cvtsi128_si64( product ) << 1 );
+        product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( q ), _mm_cvtsi64_si128( constants->poly ), 0x00 );
+
+        return lo ^ ( (uint64_t) _mm_extract_epi64( product, 1 ) << 1 ) ^ ( (uint64_t) _mm_cvtsi128_si64( product ) >> 63 );
+    }
+
+    // Fold the first 64 bits over the last 64 bits: R = A * x^64 mod P, 128 bits
+    product = _mm_clmulepi64_si128( accumulator, _mm_cvtsi64_si128( constants->k64 ), 0x01 );
+    hi = _mm_extract_epi64( product, 1 ) ^ _mm_cvtsi128_si64( accumulator );
+    lo = _mm_cvtsi128_si64( product );
+
+    // Barrett reduction
+    product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( hi ), _mm_cvtsi64_si128( constants->mu ), 0x00 );
+    q = hi ^ _mm_extract_epi64( product, 1 );
+    product = _mm_clmulepi64_si128( _mm_cvtsi64_si128( q ), _mm_cvtsi64_si128( constants->poly ), 0x00 );
+
+    return lo ^ _mm_cvtsi128_si64( product );
+}
+
+/**
+ * @internal
+ *
+ * Computes a 64-bits CRC by folding 64 bytes per iteration with PCLMULQDQ.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param crc           Current CRC register.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16 and
+ *                      at least 64.
+ *
+ * @return the updated CRC register.
+ */
+__attribute__(( target( "pclmul,sse4.1" ) ))
+static uint64_t crc64FoldPCLMUL( const CRC64FoldConstants *constants, uint64_t crc,
+                                 const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m128i k512 = _mm_loadu_si128( (const __m128i *) constants->k512 );
+    __m128i x0, x1, x2, x3;
+
+    x0 = crc64FoldLoad( buffer, reflected );
+    x1 = crc64FoldLoad( buffer + 16, reflected );
+    x2 = crc64FoldLoad( buffer + 32, reflected );
+    x3 = crc64FoldLoad( buffer + 48, reflected );
+    x0 = _mm_xor_si128( x0, reflected ? _mm_cvtsi64_si128( crc ) : _mm_set_epi64x( crc, 0 ) );
+    buffer += 64;
+    size -= 64;
+
+    while( size >= 64 ) {
+        x0 = _mm_xor_si128( crc64Fold128( x0, k512 ), crc64FoldLoad( buffer, reflected ) );
+        x1 = _mm_xor_si128( crc64Fold128( x1, k512 ), crc64FoldLoad( buffer + 16, reflected ) );
+        x2 = _mm_xor_si128( crc64Fold128( x2, k512 ), crc64FoldLoad( buffer + 32, reflected ) );
+        x3 = _mm_xor_si128( crc64Fold128( x3, k512 ), crc64FoldLoad( buffer + 48, reflected ) );
+        buffer += 64;
+        size -= 64;
+    }
+
+    // Fold the 4 accumulators into one
+    x3 = _mm_xor_si128( x3, crc64Fold128( x0, _mm_loadu_si128( (const __m128i *) constants->k384 ) ) );
+    x3 = _mm_xor_si128( x3, crc64Fold128( x1, _mm_loadu_si128( (const __m128i *) constants->k256 ) ) );
+    x3 = _mm_xor_si128( x3, crc64Fold128( x2, _mm_loadu_si128( (const __m128i *) constants->k128 ) ) );
+
+    return crc64FoldReduce( constants, x3, buffer, size );
+}
+
+/**
+ * @internal
+ *
+ * Loads a 512-bits block. See crc64FoldLoad().
+ */
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static inline __m512i crc64FoldLoad512( const uint8_t *buffer, bool reflected ) {
+    __m512i block = _mm512_loadu_si512( buffer );
+
+    if( ! reflected ) {
+        block = _mm512_shuffle_epi8( block, _mm512_maskz_broadcast_i32x4( 0xffff,
+                _mm_setr_epi8( 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0 ) ) );
+    }
+
+    return block;
+}
+
+/**
+ * @internal
+ *
+ * Moves the four 128-bits lanes of a 512-bits block forward. See crc64Fold128().
+ */
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static inline __m512i crc64Fold512( __m512i block, __m512i k ) {
+    return _mm512_xor_si512( _mm512_clmulepi64_epi128( block, k, 0x00 ), _mm512_clmulepi64_epi128( block, k, 0x11 ) );
+}
+
+/**
+ * @internal
+ *
+ * Computes a 64-bits CRC by folding 256 bytes per iteration with the AVX-512 VPCLMULQDQ
+ * instruction.
+ *
+ * @param constants     Folding constants of the CRC.
+ * @param crc           Current CRC register.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>. Must be a multiple of 16 and
+ *                      at least 256.
+ *
+ * @return the updated CRC register.
+ */
+__attribute__(( target( "avx512f,avx512bw,vpclmulqdq,pclmul,sse4.1" ) ))
+static uint64_t crc64FoldVPCLMUL( const CRC64FoldConstants *constants, uint64_t crc,
+                                  const uint8_t *buffer, size_t size ) {
+    bool reflected = constants->reflected;
+    __m512i k2048 = _mm512_maskz_broadcast_i32x4( 0xffff, _mm_loadu_si128( (const __m128i *) constants->k2048 ) );
+    __m512i k512 = _mm512_maskz_broadcast_i32x4( 0xffff, _mm_loadu_si128( (const __m128i *) constants->k512 ) );
+    __m512i z0, z1, z2, z3;
+    __m128i x;
+
+    z0 = crc64FoldLoad512( buffer, reflected );
+    z1 = crc64FoldLoad512( buffer + 64, reflected );
+    z2 = crc64FoldLoad512( buffer + 128, reflected );
+    z3 = crc64FoldLoad512( buffer + 192, reflected );
+    z0 = _mm512_xor_si512( z0, _mm512_inserti32x4( _mm512_setzero_si512( ),
+            reflected ? _mm_cvtsi64_si128( crc ) : _mm_set_epi64x( crc, 0 ), 0 ) );
+    buffer += 256;
+    size -= 256;
+
+    while( size >= 256 ) {
+        z0 = _mm512_xor_si512( crc64Fold512( z0, k2048 ), crc64FoldLoad512( buffer, reflected ) );
+        z1 = _mm512_xor_si512( crc64Fold512( z1, k2048 ), crc64FoldLoad512( buffer + 64, reflected ) );
+        z2 = _mm512_xor_si512( crc64Fold512( z2, k2048 ), crc64FoldLoad512( buffer + 128, reflected ) );
+        z3 = _mm512_xor_si512( crc64Fold512( z3, k2048 ), crc64FoldLoad512( buffer + 192, reflected ) );
+        buffer += 256;
+        size -= 256;
+    }
+
+    // Fold the 4 accumulators into one, then its 4 lanes into one
+    z1 = _mm512_xor_si512( z1, crc64Fold512( z0, k512 ) );
+    z2 = _mm512_xor_si512( z2, crc64Fold512( z1, k512 ) );
+    z3 = _mm512_xor_si512( z3, crc64Fold512( z2, k512 ) );
+
+    x = _mm512_maskz_extracti32x4_epi32( 0xf, z3, 3 );
+    x = _mm_xor_si128( x, crc64Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 0 ), _mm_loadu_si128( (const __m128i *) constants->k384 ) ) );
+    x = _mm_xor_si128( x, crc64Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 1 ), _mm_loadu_si128( (const __m128i *) constants->k256 ) ) );
+    x = _mm_xor_si128( x, crc64Fold128( _mm512_maskz_extracti32x4_epi32( 0xf, z3, 2 ), _mm_loadu_si128( (const __m128i *) constants->k128 ) ) );
+
+    return crc64FoldReduce( constants, x, buffer, size );
+}
+
+/**
+ * @internal
+ *
+ * Selects the folding kernels supported by the CPU, calibrated with the constants of
+ * CRC64_XZ.
+ */
+static CRC64FoldKernels crc64FoldBind( ) {
+    return crcFoldBind<uint64_t, CRC64FoldConstants>( "crc64-fold", "crc64-fold-wide", crc64FoldPCLMUL, crc64FoldVPCLMUL,
+                                                      CRCSlicing<CRC64_XZ>::compute, &crc64FoldXZ );
+}
+
+/** Folding kernels, bound when the library is loaded. */
+static CRC64FoldKernels crc64Fold = crc64FoldBind( );
+
+#endif  // __x86_64__
+
+//=== CRCAccelerator<uint64_t, 64> implementation =============================
+
+/**
+ * @brief Processes the bulk of a buffer with a hardware accelerated kernel.
+ *
+ * The carry-less multiplication folding is used for the ECMA-182 polynomial (reflected
+ * or not) and the reflected NVMe polynomial. Other polynomials return 0 and are entirely
+ * processed with the lookup tables.
+ *
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ * @param state         Current CRC register. Updated with the processed bytes.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>
+ *
+ * @return the number of bytes processed.
+ */
+size_t CRCAccelerator<uint64_t, 64>::accelerate( uint64_t polynomial, bool reflected, uint64_t &state, const uint8_t *buffer, size_t size ) {
+#if defined( __x86_64__ )
+    if( polynomial == CRC64_POLY_ECMA ) {
+        return crcFoldUpdate( crc64Fold, reflected ? &crc64FoldXZ : &crc64FoldEcma, &state, buffer, size );
+    }
+
+    if( polynomial == CRC64_POLY_NVME && reflected ) {
+        return crcFoldUpdate( crc64Fold, &crc64FoldNVMe, &state, buffer, size );
+    }
+#else
+    (void) polynomial;
+    (void) reflected;
+    (void) state;
+    (void) buffer;
+    (void) size;
+#endif
+
+    return 0;
+}
+
+/**
+ * @brief Retrieves the name of the kernel used by accelerate() on large buffers.
+ *
+ * @param polynomial    CRC polynomial in normal form.
+ * @param reflected     Input reflected flag.
+ *
+ * @return the kernel name or <tt>NULL</tt> if the polynomial is not accelerated.
+ */
+const char *CRCAccelerator<uint64_t, 64>::getName( uint64_t polynomial, bool reflected ) {
+#if defined( __x86_64__ )
+    if( polynomial == CRC64_POLY_ECMA || ( polynomial == CRC64_POLY_NVME && reflected ) ) {
+        return crcFoldName( crc64Fold );
+    }
+#else
+    (void) polynomial;
+    (void) reflected;
+#endif
+
+    return NULL;
+}
+
+//=== Kernel binding ==========================================================
+
+/**
+ * @internal
+ *
+ * Binds the folding kernels again after cpuBind() changed the CPU features. The minimum
+ * buffer sizes go back to their defaults.
+ */
+void libhash::crc64Rebind( ) {
+#if defined( __x86_64__ )
+    crc64Fold = crc64FoldBind( );
+#endif
+}
+
+//=== CRC64_ECMA182 implementation ============================================
+
+template class libhash::Crc<64, 0x42f0e1eba9ea3693, 0x0000000000000000, 0x0000000000000000, false, false>;
+
+/**
+ * Creates a new CRC-64/ECMA-182 handler.
+ *
+ * @return pointer to the newly created CRC-64/ECMA-182 handler or <tt>null</tt> on error.
+ */
+void* hash_crc64ecma_create( ) {
+
+    return new CRC64_ECMA182( );
+}
+
+/**
+ * @brief Initializes the specified CRC-64/ECMA-182 handler.
+ *
+ * This function prepares the CRC-64/ECMA-182 handler for hashing data. It must be called prior the
+ * first {@link hash_crc64ecma_update} or {@link hash_crc64ecma_final} calls.
+ *
+ * @param h Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64ecma_init( void *h ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->init( );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/ECMA-182 handler's state with the data.
+ *
+ * This function updates the CRC-64/ECMA-182 handler's state by hashing data. It must be called
+ * after {@link hash_crc64ecma_init} and before {@link hash_crc64ecma_final}. The result of
+ * calling this function before {@link hash_crc64ecma_init} or after {@link hash_crc64ecma_final}
+ * is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to a set of data to hash.
+ * @param len Number of bytes in <tt>buf</tt> to hash.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64ecma_update( void *h, void *buf, size_t len ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->update( buf, len );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/ECMA-182 handler's state using several threads.
+ *
+ * Same as {@link hash_crc64ecma_update} but large buffers are processed concurrently. See
+ * {@link CRC64Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64ecma_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/ECMA-182 handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc64ecma_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC64Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc64ecma_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Finalizes the specified CRC-64/ECMA-182 handler's state.
+ *
+ * This function finalizes the CRC-64/ECMA-182 handler's state and returns the hashing value. It
+ * must be called after {@link hash_crc64ecma_init} The result of calling this function before
+ * {@link hash_crc64ecma_init} is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to buffer to receive the calculated hash value.
+ * @param len Number of bytes in <tt>buf</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64ecma_finalize( void *h ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        crc->finalize( );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Retrieves the hashing value after the last  <tt>hash_crc64ecma_finalize</tt>
+ * function call.
+ *
+ * The result of calling this method prior to the {@link hash_crc64ecma_finalize} method is
+ * undefined. If the memory buffer is smaller than the hash size, only the higher part of
+ * the hash value is returned.
+ *
+ * If <tt>h</tt> is not a valid CRC-64/ECMA-182 handler, the function returns immediately.
+ *
+ * @param h    Pointer to a valid CRC-64/ECMA-182 handler.
+ * @param buf  Memory buffer to receive the hashing result.
+ * @param size Size of the memory buffer in bytes.
+ *
+ * @return the number of bytes copied into <tt>buf</tt>.
+ */
+int hash_crc64ecma_get_value( void *h, uint8_t *buf, size_t len ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->getValue( buf, len );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Combines the CRC-64/ECMA-182 values of two consecutive blocks of data.
+ *
+ * Computes the CRC-64/ECMA-182 of the concatenation of A and B without processing the data
+ * again. See {@link CRC64Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-64/ECMA-182 value of the first block.
+ * @param crcB  CRC-64/ECMA-182 value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-64/ECMA-182 value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64ecma_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * Destroys an existing CRC-64/ECMA-182 handler.
+ *
+ * @param h Pointer to a valid CRC-64/ECMA-182 handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 on error.
+ */
+int hash_crc64ecma_destroy( void *h ) {
+    int rc = 0;
+    CRC64_ECMA182 *crc = dynamic_cast<CRC64_ECMA182 *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        delete crc;
+    }
+
+    return rc;
+}
+
+//=== CRC64_XZ implementation =================================================
+
+template class libhash::Crc<64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true>;
+
+/**
+ * Creates a new CRC-64/XZ handler.
+ *
+ * @return pointer to the newly created CRC-64/XZ handler or <tt>null</tt> on error.
+ */
+void* hash_crc64xz_create( ) {
+
+    return new CRC64_XZ( );
+}
+
+/**
+ * @brief Initializes the specified CRC-64/XZ handler.
+ *
+ * This function prepares the CRC-64/XZ handler for hashing data. It must be called prior the
+ * first {@link hash_crc64xz_update} or {@link hash_crc64xz_final} calls.
+ *
+ * @param h Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64xz_init( void *h ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->init( );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/XZ handler's state with the data.
+ *
+ * This function updates the CRC-64/XZ handler's state by hashing data. It must be called
+ * after {@link hash_crc64xz_init} and before {@link hash_crc64xz_final}. The result of
+ * calling this function before {@link hash_crc64xz_init} or after {@link hash_crc64xz_final}
+ * is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to a set of data to hash.
+ * @param len Number of bytes in <tt>buf</tt> to hash.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64xz_update( void *h, void *buf, size_t len ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->update( buf, len );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/XZ handler's state using several threads.
+ *
+ * Same as {@link hash_crc64xz_update} but large buffers are processed concurrently. See
+ * {@link CRC64Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64xz_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/XZ handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc64xz_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC64Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc64xz_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Finalizes the specified CRC-64/XZ handler's state.
+ *
+ * This function finalizes the CRC-64/XZ handler's state and returns the hashing value. It
+ * must be called after {@link hash_crc64xz_init} The result of calling this function before
+ * {@link hash_crc64xz_init} is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to buffer to receive the calculated hash value.
+ * @param len Number of bytes in <tt>buf</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64xz_finalize( void *h ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        crc->finalize( );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Retrieves the hashing value after the last  <tt>hash_crc64xz_finalize</tt>
+ * function call.
+ *
+ * The result of calling this method prior to the {@link hash_crc64xz_finalize} method is
+ * undefined. If the memory buffer is smaller than the hash size, only the higher part of
+ * the hash value is returned.
+ *
+ * If <tt>h</tt> is not a valid CRC-64/XZ handler, the function returns immediately.
+ *
+ * @param h    Pointer to a valid CRC-64/XZ handler.
+ * @param buf  Memory buffer to receive the hashing result.
+ * @param size Size of the memory buffer in bytes.
+ *
+ * @return the number of bytes copied into <tt>buf</tt>.
+ */
+int hash_crc64xz_get_value( void *h, uint8_t *buf, size_t len ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->getValue( buf, len );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Combines the CRC-64/XZ values of two consecutive blocks of data.
+ *
+ * Computes the CRC-64/XZ of the concatenation of A and B without processing the data
+ * again. See {@link CRC64Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-64/XZ value of the first block.
+ * @param crcB  CRC-64/XZ value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-64/XZ value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64xz_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * Destroys an existing CRC-64/XZ handler.
+ *
+ * @param h Pointer to a valid CRC-64/XZ handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 on error.
+ */
+int hash_crc64xz_destroy( void *h ) {
+    int rc = 0;
+    CRC64_XZ *crc = dynamic_cast<CRC64_XZ *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        delete crc;
+    }
+
+    return rc;
+}
+
+//=== CRC64_NVMe implementation ===============================================
+
+template class libhash::Crc<64, 0xad93d23594c93659, 0xffffffffffffffff, 0xffffffffffffffff, true, true>;
+
+/**
+ * Creates a new CRC-64/NVMe handler.
+ *
+ * @return pointer to the newly created CRC-64/NVMe handler or <tt>null</tt> on error.
+ */
+void* hash_crc64nvme_create( ) {
+
+    return new CRC64_NVMe( );
+}
+
+/**
+ * @brief Initializes the specified CRC-64/NVMe handler.
+ *
+ * This function prepares the CRC-64/NVMe handler for hashing data. It must be called prior the
+ * first {@link hash_crc64nvme_update} or {@link hash_crc64nvme_final} calls.
+ *
+ * @param h Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64nvme_init( void *h ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->init( );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/NVMe handler's state with the data.
+ *
+ * This function updates the CRC-64/NVMe handler's state by hashing data. It must be called
+ * after {@link hash_crc64nvme_init} and before {@link hash_crc64nvme_final}. The result of
+ * calling this function before {@link hash_crc64nvme_init} or after {@link hash_crc64nvme_final}
+ * is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to a set of data to hash.
+ * @param len Number of bytes in <tt>buf</tt> to hash.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64nvme_update( void *h, void *buf, size_t len ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->update( buf, len );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/NVMe handler's state using several threads.
+ *
+ * Same as {@link hash_crc64nvme_update} but large buffers are processed concurrently. See
+ * {@link CRC64Base::updateParallel}.
+ *
+ * @param h       Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ * @param buf     Pointer to a set of data to hash.
+ * @param len     Number of bytes in <tt>buf</tt> to hash.
+ * @param threads Maximum number of threads to use or 0 for the number of hardware threads.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64nvme_update_parallel( void *h, void *buf, size_t len, unsigned threads ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        crc->updateParallel( buf, len, threads );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Updates the specified CRC-64/NVMe handler's state with the content of a file.
+ *
+ * Same as {@link hash_crc64nvme_update} with the whole content of the file. The holes of a
+ * sparse file are skipped without being read. See {@link CRC64Base::updateFile}.
+ *
+ * @param h   Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ * @param fd  Open file descriptor, readable and seekable.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid or on an I/O error.
+ */
+int hash_crc64nvme_update_file( void *h, int fd ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->updateFile( fd ) ? 1 : 0;
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Finalizes the specified CRC-64/NVMe handler's state.
+ *
+ * This function finalizes the CRC-64/NVMe handler's state and returns the hashing value. It
+ * must be called after {@link hash_crc64nvme_init} The result of calling this function before
+ * {@link hash_crc64nvme_init} is undefined.
+ *
+ * @param h   Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ * @param buf Pointer to buffer to receive the calculated hash value.
+ * @param len Number of bytes in <tt>buf</tt>.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64nvme_finalize( void *h ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        crc->finalize( );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Retrieves the hashing value after the last  <tt>hash_crc64nvme_finalize</tt>
+ * function call.
+ *
+ * The result of calling this method prior to the {@link hash_crc64nvme_finalize} method is
+ * undefined. If the memory buffer is smaller than the hash size, only the higher part of
+ * the hash value is returned.
+ *
+ * If <tt>h</tt> is not a valid CRC-64/NVMe handler, the function returns immediately.
+ *
+ * @param h    Pointer to a valid CRC-64/NVMe handler.
+ * @param buf  Memory buffer to receive the hashing result.
+ * @param size Size of the memory buffer in bytes.
+ *
+ * @return the number of bytes copied into <tt>buf</tt>.
+ */
+int hash_crc64nvme_get_value( void *h, uint8_t *buf, size_t len ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = crc->getValue( buf, len );
+    }
+
+    return rc;
+}
+
+/**
+ * @brief Combines the CRC-64/NVMe values of two consecutive blocks of data.
+ *
+ * Computes the CRC-64/NVMe of the concatenation of A and B without processing the data
+ * again. See {@link CRC64Base::combine}.
+ *
+ * @param h     Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ * @param crcA  CRC-64/NVMe value of the first block.
+ * @param crcB  CRC-64/NVMe value of the second block.
+ * @param lenB  Length in bytes of the second block.
+ * @param crcAB Pointer to receive the CRC-64/NVMe value of both blocks.
+ *
+ * @return a non-zero value on success or 0 if <tt>h</tt> is not valid.
+ */
+int hash_crc64nvme_combine( void *h, uint64_t crcA, uint64_t crcB, size_t lenB, uint64_t *crcAB ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL && crcAB != NULL ) {
+
+        *crcAB = crc->combine( crcA, crcB, lenB );
+        rc = 1;
+    }
+
+    return rc;
+}
+
+/**
+ * Destroys an existing CRC-64/NVMe handler.
+ *
+ * @param h Pointer to a valid CRC-64/NVMe handler. Cannot be <tt>NULL</tt>.
+ *
+ * @return a non-zero value on success or 0 on error.
+ */
+int hash_crc64nvme_destroy( void *h ) {
+    int rc = 0;
+    CRC64_NVMe *crc = dynamic_cast<CRC64_NVMe *> ( (HashingBase *) h );
+
+    if(  crc != NULL ) {
+
+        rc = 1;
+        delete crc;
+    }
+
+    return rc;
+}
+
+// EOF: crc64.cpp
@@ -0,0 +1,278 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       crcfold.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-11-16
+//
+// Description
+// Internal dispatch of the carry-less multiplication folding kernels, shared by the
+// CRC-32 and CRC-64 widths. This header is not installed.
+//=============================================================================
+
+#ifndef __LH_CRCFOLD_H00__
+#    define __LH_CRCFOLD_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include <stddef.h>
+#    include <algorithm>
+#    include <mutex>
+#    include "../include/libhash/cpu.h"
+#    include "calibrate.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+/** Minimum number of bytes for which the PCLMULQDQ folding is worth it. */
+#    define CRC_FOLD_MIN            64
+
+/** Minimum number of bytes for which the AVX-512 VPCLMULQDQ folding is worth it. */
+#    define CRC_FOLD_WIDE_MIN       1024
+
+/** Number of bytes folded per iteration by AVX-512 VPCLMULQDQ, the minimum it accepts. */
+#    define CRC_FOLD_WIDE_BLOCK     256
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+namespace libhash {
+
+/**
+ * @internal
+ *
+ * @brief Gives access to the lookup tables kernel of a CRC, to calibrate the hardware
+ * accelerated kernels against it.
+ */
+template<class Algorithm>
+class CRCSlicing : public Algorithm {
+public:
+    using Algorithm::compute;
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Carry-less multiplication folding kernels of a CRC width.
+ *
+ * The kernels are <tt>NULL</tt> if the CPU does not support them. Each width has a single
+ * instance, bound when the library is loaded by crcFoldBind(); before that, everything is
+ * 0 and the lookup tables are used.
+ *
+ * @tparam Register     Unsigned type of the CRC register.
+ * @tparam Constants    Folding constants of the width.
+ */
+template<typename Register, typename Constants>
+struct CRCFoldKernels {
+    /** Folding kernel: processes a multiple of 16 bytes from a CRC register. */
+    typedef Register ( *Kernel )( const Constants *, Register, const uint8_t *, size_t );
+
+    /** Lookup tables kernel of the width. */
+    typedef Register ( *Tables )( Register, const uint8_t *, size_t );
+
+    /** Folding of 64 bytes per iteration with PCLMULQDQ. */
+    Kernel              fold;
+
+    /** Folding of 256 bytes per iteration with AVX-512 VPCLMULQDQ. */
+    Kernel              foldWide;
+
+    size_t              foldMin;        ///< Minimum number of bytes for <tt>fold</tt>
+    size_t              foldWideMin;    ///< Minimum number of bytes for <tt>foldWide</tt>
+
+    /** Lookup tables the kernels are calibrated against. */
+    Tables              tables;
+
+    /** Constants the kernels are calibrated with; all polynomials fold at the same speed. */
+    const Constants     *reference;
+
+    const char          *name;          ///< Calibration name, e.g. <tt>"crc32-fold"</tt>
+    const char          *wideName;      ///< Calibration name with <tt>foldWide</tt>
+} ;
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * Selects the folding kernels supported by the CPU (see CPU::getFeatures()). The minimum
+ * buffer size of each kernel is a default until it is calibrated.
+ *
+ * @param name      Calibration name of the width.
+ * @param wideName  Calibration name of the width with the VPCLMULQDQ kernel.
+ * @param fold      PCLMULQDQ kernel.
+ * @param foldWide  AVX-512 VPCLMULQDQ kernel.
+ * @param tables    Lookup tables kernel.
+ * @param reference Constants used by the calibration.
+ */
+template<typename Register, typename Constants>
+CRCFoldKernels<Register, Constants> crcFoldBind( const char *name, const char *wideName,
+                                                 typename CRCFoldKernels<Register, Constants>::Kernel fold,
+                                                 typename CRCFoldKernels<Register, Constants>::Kernel foldWide,
+                                                 typename CRCFoldKernels<Register, Constants>::Tables tables,
+                                                 const Constants *reference ) {
+    CRCFoldKernels<Register, Constants> kernels = { NULL, NULL, CRC_FOLD_MIN, CRC_FOLD_WIDE_MIN, tables, reference, name, wideName };
+
+    if( CPU::has( HASH_CPU_PCLMUL | HASH_CPU_SSE41 ) ) {
+        kernels.fold = fold;
+    }
+
+    if( CPU::has( HASH_CPU_PCLMUL | HASH_CPU_SSE41 | HASH_CPU_AVX512 | HASH_CPU_VPCLMUL ) ) {
+        kernels.foldWide = foldWide;
+    }
+
+    return kernels;
+}
+
+/**
+ * @internal
+ *
+ * Runs a kernel for cpuCalibrate(): the lookup tables (0), the PCLMULQDQ folding (1) or
+ * the VPCLMULQDQ folding (2). The context is the CRCFoldKernels of the width.
+ */
+template<typename Register, typename Constants>
+bool crcFoldBenchmark( const void *context, unsigned kernel, const uint8_t *buffer, size_t size ) {
+    static volatile Register sink;
+    const CRCFoldKernels<Register, Constants> *kernels = (const CRCFoldKernels<Register, Constants> *) context;
+
+    if( kernel == 0 ) {
+        sink = kernels->tables( sink, buffer, size );
+    }
+    else if( kernel == 1 && size >= CRC_FOLD_MIN ) {
+        sink = kernels->fold( kernels->reference, sink, buffer, size & ~( (size_t) 15 ) );
+    }
+    else if( kernel == 2 && size >= CRC_FOLD_WIDE_BLOCK ) {
+        sink = kernels->foldWide( kernels->reference, sink, buffer, size & ~( (size_t) 15 ) );
+    }
+    else {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Measures the minimum buffer sizes of the folding kernels with cpuCalibrate(), the first
+ * time a buffer is large enough to be folded. Calibrating on first use rather than when
+ * the library is loaded keeps the measure out of the start up of the processes that never
+ * compute a CRC. Must be called before reading <tt>foldMin</tt> and <tt>foldWideMin</tt>.
+ *
+ * @param kernels   Folding kernels of the width; there is one per template instance.
+ */
+template<typename Register, typename Constants>
+void crcFoldCalibrate( CRCFoldKernels<Register, Constants> &kernels ) {
+    static std::once_flag once;
+
+    std::call_once( once, [ &kernels ]( ) {
+        bool wide = kernels.foldWide != NULL;
+        size_t thresholds[ 2 ];
+
+        if( cpuCalibrate( wide ? kernels.wideName : kernels.name, wide ? 3 : 2, crcFoldBenchmark<Register, Constants>, &kernels, thresholds ) ) {
+            kernels.foldMin = std::max( thresholds[ 0 ], (size_t) CRC_FOLD_MIN );
+            if( wide ) {
+                kernels.foldWideMin = std::max( thresholds[ 1 ], (size_t) CRC_FOLD_WIDE_BLOCK );
+            }
+        }
+    } );
+}
+
+/**
+ * @internal
+ *
+ * Processes the bulk of a buffer with the best available carry-less multiplication
+ * folding.
+ *
+ * @param kernels       Folding kernels of the width.
+ * @param constants     Folding constants of the CRC.
+ * @param crc           Current CRC register. Updated with the processed bytes.
+ * @param buffer        Data to process.
+ * @param size          Number of bytes in <tt>buffer</tt>
+ *
+ * @return the number of bytes processed; the remaining bytes must be processed with the
+ *         lookup tables.
+ */
+template<typename Register, typename Constants>
+size_t crcFoldUpdate( CRCFoldKernels<Register, Constants> &kernels, const Constants *constants,
+                      Register *crc, const uint8_t *buffer, size_t size ) {
+    size_t bulk = size & ~( (size_t) 15 );
+
+    // The calibration never lowers the minimum size below CRC_FOLD_MIN
+    if( kernels.fold == NULL || size < CRC_FOLD_MIN ) {
+        return 0;
+    }
+
+    crcFoldCalibrate( kernels );
+
+    if( kernels.foldWide != NULL && size >= kernels.foldWideMin ) {
+        *crc = kernels.foldWide( constants, *crc, buffer, bulk );
+        return bulk;
+    }
+
+    if( size >= kernels.foldMin ) {
+        *crc = kernels.fold( constants, *crc, buffer, bulk );
+        return bulk;
+    }
+
+    return 0;
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the name of the folding kernel used on large buffers.
+ *
+ * @param kernels       Folding kernels of the width.
+ *
+ * @return <tt>"vpclmulqdq"</tt>, <tt>"pclmulqdq"</tt> or <tt>NULL</tt> if the lookup
+ *         tables are always faster or the CPU cannot fold.
+ */
+template<typename Register, typename Constants>
+const char *crcFoldName( CRCFoldKernels<Register, Constants> &kernels ) {
+    if( kernels.fold == NULL ) {
+        return NULL;
+    }
+
+    crcFoldCalibrate( kernels );
+    if( kernels.foldWide != NULL && kernels.foldWideMin != SIZE_MAX ) {
+        return "vpclmulqdq";
+    }
+
+    if( kernels.foldMin != SIZE_MAX ) {
+        return "pclmulqdq";
+    }
+
+    return NULL;
+}
+
+};  // namespace libhash
+
+#endif   // __LH_CRCFOLD_H00__
+
+// EOF: crcfold.h
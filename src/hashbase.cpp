@@ -81,6 +81,30 @@ int HashingBase::getValue( uint8_t *buffer, size_t size ) {
     return max;
 }
 
+const char *HashingBase::getKernel( ) {
+    return "generic";
+}
+
+//=== C API implementation ====================================================
+
+/**
+ * @brief Retrieves the name of the kernel used by a hashing handler.
+ *
+ * @param h Pointer to a valid handler of any algorithm. Cannot be <tt>NULL</tt>.
+ *
+ * @return the kernel name or <tt>NULL</tt> if <tt>h</tt> is not valid.
+ */
+const char* hash_get_kernel( void *h ) {
+    const char *kernel = NULL;
+    HashingBase *hash = (HashingBase *) h;
+
+    if(  hash != NULL ) {
+        kernel = hash->getKernel( );
+    }
+
+    return kernel;
+}
+
 // EOF: hashbase.cpp
 
 
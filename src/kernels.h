@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       kernels.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-12-14
+//
+// Description
+// Internal declarations of the kernel binding, to compare the kernels of every CPU
+// tier in a single process. This header is not installed.
+//=============================================================================
+
+#ifndef __LH_KERNELS_H00__
+#    define __LH_KERNELS_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include "../include/libhash/cpu.h"
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+namespace libhash {
+
+void cpuBind( uint32_t );
+
+void crc32Rebind( );
+void crc64Rebind( );
+void md5Rebind( );
+void sha1Rebind( );
+void sha2Rebind( );
+
+};  // namespace libhash
+
+#endif   // __LH_KERNELS_H00__
+
+// EOF: kernels.h
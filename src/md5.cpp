@@ -39,7 +39,10 @@
 #include <string.h>
 #include "../include/libhash/defs.h"
 #include "../include/libhash/hashbase.h"
+#include "../include/libhash/cpu.h"
 #include "../include/libhash/md5.h"
+#include "multibuffer.h"
+#include "kernels.h"
 
 using namespace libhash;
 
@@ -65,6 +68,26 @@ using namespace libhash;
 #define S43 15
 #define S44 21
 
+// MD5 initial state
+static const uint32_t Md5Init[4] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+// Constants of the 64 steps, used by the multi-buffer kernels
+static const uint32_t KMd5[64] = {
+    0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+    0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+    0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+    0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+    0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+    0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+    0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+    0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391
+};
+
+// Rotations of the 4 steps of each round, used by the multi-buffer kernels
+static const int SMd5[4][4] = {
+    { S11, S12, S13, S14 }, { S21, S22, S23, S24 }, { S31, S32, S33, S34 }, { S41, S42, S43, S44 }
+};
+
 // ============================================================================
 // STRUCTURES & TYPEDEFS
 // ============================================================================
@@ -79,16 +102,15 @@ using namespace libhash;
 
 // F, G, H and I are basic MD5 functions.
 
-inline uint32_t F( uint32_t x, uint32_t y, uint32_t z ) {
-    return ( x & y ) | ( ~x & z );
-}
+// F, H and I are written so that only their last operation depends on x, the newest
+// value of the state. G is computed by GG.
 
-inline uint32_t G( uint32_t x, uint32_t y, uint32_t z ) {
-    return ( x & z ) | ( y & ~z );
+inline uint32_t F( uint32_t x, uint32_t y, uint32_t z ) {
+    return z ^ ( x & ( y ^ z ) );
 }
 
 inline uint32_t H( uint32_t x, uint32_t y, uint32_t z ) {
-    return x ^ y ^ z;
+    return x ^ ( y ^ z );
 }
 
 inline uint32_t I( uint32_t x, uint32_t y, uint32_t z ) {
@@ -96,28 +118,40 @@ inline uint32_t I( uint32_t x, uint32_t y, uint32_t z ) {
 }
 
 // FF, GG, HH, and II transformations for rounds 1, 2, 3, and 4.
-// Rotation is separate from addition to prevent recomputation.
-
-inline void FF( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t s, uint32_t ac ) {
-    a += F( b, c, d ) + x + ac;
+// Rotation is separate from addition to prevent recomputation. The message word and the
+// constant are added to a first, off the critical path through b. The rotation s is a
+// template parameter, so each step rotates by an immediate.
+
+template<int s>
+inline void FF( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t ac ) {
+    a += x + ac;
+    a += F( b, c, d );
     a = ROTL( a, s, 32 );
     a += b;
 }
 
-inline void GG( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t s, uint32_t ac ) {
-    a += G( b, c, d ) + x + ac;
+// G( b, c, d ) = ( b & d ) | ( c & ~d ): the 2 terms never have a bit set in common, so
+// they can be added instead of or'ed, and ( c & ~d ) is added before b is known.
+template<int s>
+inline void GG( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t ac ) {
+    a += x + ac + ( c & ~d );
+    a += b & d;
     a = ROTL( a, s, 32 );
     a += b;
 }
 
-inline void HH( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t s, uint32_t ac ) {
-    a += H( b, c, d ) + x + ac;
+template<int s>
+inline void HH( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t ac ) {
+    a += x + ac;
+    a += H( b, c, d );
     a = ROTL( a, s, 32 );
     a += b;
 }
 
-inline void II( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t s, uint32_t ac ) {
-    a += I( b, c, d ) + x + ac;
+template<int s>
+inline void II( uint32_t &a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t ac ) {
+    a += x + ac;
+    a += I( b, c, d );
     a = ROTL( a, s, 32 );
     a += b;
 }
@@ -143,9 +177,13 @@ static void encode( uint8_t *output, uint32_t *input, uint32_t len ) {
  * @internal
  *
  * Decodes input (uint8_t) into output (uint32_t). Assumes len is a multiple of
- * 4. Values are decoded from little-endian format.
+ * 4. Values are decoded from little-endian format: on little-endian hosts, they are
+ * copied as is (input does not need to be aligned).
  */
-static void decode( uint32_t *output, uint8_t *input, uint32_t len ) {
+static inline void decode( uint32_t *output, const uint8_t *input, uint32_t len ) {
+#if defined( __BYTE_ORDER__ ) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    ::memcpy( output, input, len );
+#else
     uint32_t i, j;
 
     for( i = 0, j = 0; j < len; i++, j += 4 ) {
@@ -154,6 +192,7 @@ static void decode( uint32_t *output, uint8_t *input, uint32_t len ) {
                 ( ( (uint32_t) input[ j + 2 ] ) << 16 ) |
                 ( ( (uint32_t) input[ j + 3 ] ) << 24 );
     }
+#endif
 }
 
 // ============================================================================
@@ -185,38 +224,40 @@ void MD5::init( ) {
  * @copydoc HashingBase::update( const void *, size_t )
  */
 void MD5::update( const void *data, size_t size ) {
-    uint32_t i, index, partLen;
+    const uint8_t *buffer = (const uint8_t *) data;
+    size_t index, partLen, count;
 
     // Compute number of bytes mod 64
     index = ( mBitCount[ 0 ] >> 3 ) & 0x3F;
 
     // Update number of bits
-    mBitCount[ 0 ] += ( size << 3 );
-    if( mBitCount[ 0 ] < ( size << 3 ) ) {
+    mBitCount[ 0 ] += (uint32_t) ( size << 3 );
+    if( mBitCount[ 0 ] < (uint32_t) ( size << 3 ) ) {
         mBitCount[ 1 ]++;
     }
 
-    mBitCount[ 1 ] += ( size >> 29 );
+    mBitCount[ 1 ] += (uint32_t) ( (uint64_t) size >> 29 );
 
     partLen = 64 - index;
 
-    // Transform as many times as possible.
+    // Transform as many times as possible, the complete blocks directly from the caller's
+    // buffer.
     if( size >= partLen ) {
-        ::memcpy( mBlock + index, data, partLen );
-        transform( mBlock );
+        ::memcpy( mBlock + index, buffer, partLen );
+        transform( mBlock, 1 );
+        buffer += partLen;
+        size -= partLen;
 
-        for( i = partLen; i + 63 < size; i += 64 ) {
-            transform( ( (uint8_t *) data ) + i );
-        }
+        count = size / 64;
+        transform( buffer, count );
+        buffer += count * 64;
+        size -= count * 64;
 
         index = 0;
     }
-    else {
-        i = 0;
-    }
 
     // Buffer remaining input
-    ::memcpy( mBlock + index, ( (uint8_t *) data ) + i, size - i );
+    ::memcpy( mBlock + index, buffer, size );
 }
 
 /**
@@ -254,100 +295,441 @@ void MD5::finalize( ) {
 /**
  * @brief MD5 basic transformation.
  *
- * Transforms the current state based on the content of the specified block.
+ * Transforms the current state based on the content of the specified blocks.
  *
- * @param block Data block to process.
+ * @param blocks    Data blocks to process, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
  */
-void MD5::transform( uint8_t *block ) {
-    uint32_t a = mState[ 0 ];
-    uint32_t b = mState[ 1 ];
-    uint32_t c = mState[ 2 ];
-    uint32_t d = mState[ 3 ];
+void MD5::transform( const uint8_t *blocks, size_t count ) {
+    uint32_t a, b, c, d;
     uint32_t x[16];
 
-    decode( x, block, 64 );
-
-    // Round 1
-    FF( a, b, c, d, x[ 0 ], S11, 0xd76aa478 );  // 1
-    FF( d, a, b, c, x[ 1 ], S12, 0xe8c7b756 );  // 2
-    FF( c, d, a, b, x[ 2 ], S13, 0x242070db );  // 3
-    FF( b, c, d, a, x[ 3 ], S14, 0xc1bdceee );  // 4
-    FF( a, b, c, d, x[ 4 ], S11, 0xf57c0faf );  // 5
-    FF( d, a, b, c, x[ 5 ], S12, 0x4787c62a );  // 6
-    FF( c, d, a, b, x[ 6 ], S13, 0xa8304613 );  // 7
-    FF( b, c, d, a, x[ 7 ], S14, 0xfd469501 );  // 8
-    FF( a, b, c, d, x[ 8 ], S11, 0x698098d8 );  // 9
-    FF( d, a, b, c, x[ 9 ], S12, 0x8b44f7af );  // 10
-    FF( c, d, a, b, x[ 10 ], S13, 0xffff5bb1 ); // 11
-    FF( b, c, d, a, x[ 11 ], S14, 0x895cd7be ); // 12
-    FF( a, b, c, d, x[ 12 ], S11, 0x6b901122 ); // 13
-    FF( d, a, b, c, x[ 13 ], S12, 0xfd987193 ); // 14
-    FF( c, d, a, b, x[ 14 ], S13, 0xa679438e ); // 15
-    FF( b, c, d, a, x[ 15 ], S14, 0x49b40821 ); // 16
-
-    // Round 2
-    GG( a, b, c, d, x[ 1 ], S21, 0xf61e2562 );  // 17
-    GG( d, a, b, c, x[ 6 ], S22, 0xc040b340 );  // 18
-    GG( c, d, a, b, x[ 11 ], S23, 0x265e5a51 ); // 19
-    GG( b, c, d, a, x[ 0 ], S24, 0xe9b6c7aa );  // 20
-    GG( a, b, c, d, x[ 5 ], S21, 0xd62f105d );  // 21
-    GG( d, a, b, c, x[ 10 ], S22,  0x2441453 ); // 22
-    GG( c, d, a, b, x[ 15 ], S23, 0xd8a1e681 ); // 23
-    GG( b, c, d, a, x[ 4 ], S24, 0xe7d3fbc8 );  // 24
-    GG( a, b, c, d, x[ 9 ], S21, 0x21e1cde6 );  // 25
-    GG( d, a, b, c, x[ 14 ], S22, 0xc33707d6 ); // 26
-    GG( c, d, a, b, x[ 3 ], S23, 0xf4d50d87 );  // 27
-    GG( b, c, d, a, x[ 8 ], S24, 0x455a14ed );  // 28
-    GG( a, b, c, d, x[ 13 ], S21, 0xa9e3e905 ); // 29
-    GG( d, a, b, c, x[ 2 ], S22, 0xfcefa3f8 );  // 30
-    GG( c, d, a, b, x[ 7 ], S23, 0x676f02d9 );  // 31
-    GG( b, c, d, a, x[ 12 ], S24, 0x8d2a4c8a ); // 32
-
-    // Round 3
-    HH( a, b, c, d, x[ 5 ], S31, 0xfffa3942 );  // 33
-    HH( d, a, b, c, x[ 8 ], S32, 0x8771f681 );  // 34
-    HH( c, d, a, b, x[ 11 ], S33, 0x6d9d6122 ); // 35
-    HH( b, c, d, a, x[ 14 ], S34, 0xfde5380c ); // 36
-    HH( a, b, c, d, x[ 1 ], S31, 0xa4beea44 );  // 37
-    HH( d, a, b, c, x[ 4 ], S32, 0x4bdecfa9 );  // 38
-    HH( c, d, a, b, x[ 7 ], S33, 0xf6bb4b60 );  // 39
-    HH( b, c, d, a, x[ 10 ], S34, 0xbebfbc70 ); // 40
-    HH( a, b, c, d, x[ 13 ], S31, 0x289b7ec6 ); // 41
-    HH( d, a, b, c, x[ 0 ], S32, 0xeaa127fa );  // 42
-    HH( c, d, a, b, x[ 3 ], S33, 0xd4ef3085 );  // 43
-    HH( b, c, d, a, x[ 6 ], S34,  0x4881d05 );  // 44
-    HH( a, b, c, d, x[ 9 ], S31, 0xd9d4d039 );  // 45
-    HH( d, a, b, c, x[ 12 ], S32, 0xe6db99e5 ); // 46
-    HH( c, d, a, b, x[ 15 ], S33, 0x1fa27cf8 ); // 47
-    HH( b, c, d, a, x[ 2 ], S34, 0xc4ac5665 );  // 48
-
-    // Round 4
-    II( a, b, c, d, x[ 0 ], S41, 0xf4292244 );  // 49
-    II( d, a, b, c, x[ 7 ], S42, 0x432aff97 );  // 50
-    II( c, d, a, b, x[ 14 ], S43, 0xab9423a7 ); // 51
-    II( b, c, d, a, x[ 5 ], S44, 0xfc93a039 );  // 52
-    II( a, b, c, d, x[ 12 ], S41, 0x655b59c3 ); // 53
-    II( d, a, b, c, x[ 3 ], S42, 0x8f0ccc92 );  // 54
-    II( c, d, a, b, x[ 10 ], S43, 0xffeff47d ); // 55
-    II( b, c, d, a, x[ 1 ], S44, 0x85845dd1 );  // 56
-    II( a, b, c, d, x[ 8 ], S41, 0x6fa87e4f );  // 57
-    II( d, a, b, c, x[ 15 ], S42, 0xfe2ce6e0 ); // 58
-    II( c, d, a, b, x[ 6 ], S43, 0xa3014314 );  // 59
-    II( b, c, d, a, x[ 13 ], S44, 0x4e0811a1 ); // 60
-    II( a, b, c, d, x[ 4 ], S41, 0xf7537e82 );  // 61
-    II( d, a, b, c, x[ 11 ], S42, 0xbd3af235 ); // 62
-    II( c, d, a, b, x[ 2 ], S43, 0x2ad7d2bb );  // 63
-    II( b, c, d, a, x[ 9 ], S44, 0xeb86d391 );  // 64
-
-    mState[ 0 ] += a;
-    mState[ 1 ] += b;
-    mState[ 2 ] += c;
-    mState[ 3 ] += d;
+    for( ; count > 0; count--, blocks += 64 ) {
+        decode( x, blocks, 64 );
+
+        a = mState[ 0 ];
+        b = mState[ 1 ];
+        c = mState[ 2 ];
+        d = mState[ 3 ];
+
+        // Round 1
+        FF<S11>( a, b, c, d, x[ 0 ], 0xd76aa478 );  // 1
+        FF<S12>( d, a, b, c, x[ 1 ], 0xe8c7b756 );  // 2
+        FF<S13>( c, d, a, b, x[ 2 ], 0x242070db );  // 3
+        FF<S14>( b, c, d, a, x[ 3 ], 0xc1bdceee );  // 4
+        FF<S11>( a, b, c, d, x[ 4 ], 0xf57c0faf );  // 5
+        FF<S12>( d, a, b, c, x[ 5 ], 0x4787c62a );  // 6
+        FF<S13>( c, d, a, b, x[ 6 ], 0xa8304613 );  // 7
+        FF<S14>( b, c, d, a, x[ 7 ], 0xfd469501 );  // 8
+        FF<S11>( a, b, c, d, x[ 8 ], 0x698098d8 );  // 9
+        FF<S12>( d, a, b, c, x[ 9 ], 0x8b44f7af );  // 10
+        FF<S13>( c, d, a, b, x[ 10 ], 0xffff5bb1 ); // 11
+        FF<S14>( b, c, d, a, x[ 11 ], 0x895cd7be ); // 12
+        FF<S11>( a, b, c, d, x[ 12 ], 0x6b901122 ); // 13
+        FF<S12>( d, a, b, c, x[ 13 ], 0xfd987193 ); // 14
+        FF<S13>( c, d, a, b, x[ 14 ], 0xa679438e ); // 15
+        FF<S14>( b, c, d, a, x[ 15 ], 0x49b40821 ); // 16
+
+        // Round 2
+        GG<S21>( a, b, c, d, x[ 1 ], 0xf61e2562 );  // 17
+        GG<S22>( d, a, b, c, x[ 6 ], 0xc040b340 );  // 18
+        GG<S23>( c, d, a, b, x[ 11 ], 0x265e5a51 ); // 19
+        GG<S24>( b, c, d, a, x[ 0 ], 0xe9b6c7aa );  // 20
+        GG<S21>( a, b, c, d, x[ 5 ], 0xd62f105d );  // 21
+        GG<S22>( d, a, b, c, x[ 10 ],  0x2441453 ); // 22
+        GG<S23>( c, d, a, b, x[ 15 ], 0xd8a1e681 ); // 23
+        GG<S24>( b, c, d, a, x[ 4 ], 0xe7d3fbc8 );  // 24
+        GG<S21>( a, b, c, d, x[ 9 ], 0x21e1cde6 );  // 25
+        GG<S22>( d, a, b, c, x[ 14 ], 0xc33707d6 ); // 26
+        GG<S23>( c, d, a, b, x[ 3 ], 0xf4d50d87 );  // 27
+        GG<S24>( b, c, d, a, x[ 8 ], 0x455a14ed );  // 28
+        GG<S21>( a, b, c, d, x[ 13 ], 0xa9e3e905 ); // 29
+        GG<S22>( d, a, b, c, x[ 2 ], 0xfcefa3f8 );  // 30
+        GG<S23>( c, d, a, b, x[ 7 ], 0x676f02d9 );  // 31
+        GG<S24>( b, c, d, a, x[ 12 ], 0x8d2a4c8a ); // 32
+
+        // Round 3
+        HH<S31>( a, b, c, d, x[ 5 ], 0xfffa3942 );  // 33
+        HH<S32>( d, a, b, c, x[ 8 ], 0x8771f681 );  // 34
+        HH<S33>( c, d, a, b, x[ 11 ], 0x6d9d6122 ); // 35
+        HH<S34>( b, c, d, a, x[ 14 ], 0xfde5380c ); // 36
+        HH<S31>( a, b, c, d, x[ 1 ], 0xa4beea44 );  // 37
+        HH<S32>( d, a, b, c, x[ 4 ], 0x4bdecfa9 );  // 38
+        HH<S33>( c, d, a, b, x[ 7 ], 0xf6bb4b60 );  // 39
+        HH<S34>( b, c, d, a, x[ 10 ], 0xbebfbc70 ); // 40
+        HH<S31>( a, b, c, d, x[ 13 ], 0x289b7ec6 ); // 41
+        HH<S32>( d, a, b, c, x[ 0 ], 0xeaa127fa );  // 42
+        HH<S33>( c, d, a, b, x[ 3 ], 0xd4ef3085 );  // 43
+        HH<S34>( b, c, d, a, x[ 6 ],  0x4881d05 );  // 44
+        HH<S31>( a, b, c, d, x[ 9 ], 0xd9d4d039 );  // 45
+        HH<S32>( d, a, b, c, x[ 12 ], 0xe6db99e5 ); // 46
+        HH<S33>( c, d, a, b, x[ 15 ], 0x1fa27cf8 ); // 47
+        HH<S34>( b, c, d, a, x[ 2 ], 0xc4ac5665 );  // 48
+
+        // Round 4
+        II<S41>( a, b, c, d, x[ 0 ], 0xf4292244 );  // 49
+        II<S42>( d, a, b, c, x[ 7 ], 0x432aff97 );  // 50
+        II<S43>( c, d, a, b, x[ 14 ], 0xab9423a7 ); // 51
+        II<S44>( b, c, d, a, x[ 5 ], 0xfc93a039 );  // 52
+        II<S41>( a, b, c, d, x[ 12 ], 0x655b59c3 ); // 53
+        II<S42>( d, a, b, c, x[ 3 ], 0x8f0ccc92 );  // 54
+        II<S43>( c, d, a, b, x[ 10 ], 0xffeff47d ); // 55
+        II<S44>( b, c, d, a, x[ 1 ], 0x85845dd1 );  // 56
+        II<S41>( a, b, c, d, x[ 8 ], 0x6fa87e4f );  // 57
+        II<S42>( d, a, b, c, x[ 15 ], 0xfe2ce6e0 ); // 58
+        II<S43>( c, d, a, b, x[ 6 ], 0xa3014314 );  // 59
+        II<S44>( b, c, d, a, x[ 13 ], 0x4e0811a1 ); // 60
+        II<S41>( a, b, c, d, x[ 4 ], 0xf7537e82 );  // 61
+        II<S42>( d, a, b, c, x[ 11 ], 0xbd3af235 ); // 62
+        II<S43>( c, d, a, b, x[ 2 ], 0x2ad7d2bb );  // 63
+        II<S44>( b, c, d, a, x[ 9 ], 0xeb86d391 );  // 64
+
+        mState[ 0 ] += a;
+        mState[ 1 ] += b;
+        mState[ 2 ] += c;
+        mState[ 3 ] += d;
+    }
 
     // Zeroize sensitive information.
     ::memset( &x, 0, sizeof (x ) );
 }
 
+// -------------------------------------------------------------------------
+// Multi-buffer kernels
+
+/**
+ * @internal
+ *
+ * Retrieves the index of the message word used by a step.
+ *
+ * @param i Step (0 to 63).
+ */
+static inline int md5Word( int i ) {
+    return i < 16 ? i : i < 32 ? ( 5 * i + 1 ) & 15 : i < 48 ? ( 3 * i + 5 ) & 15 : ( 7 * i ) & 15;
+}
+
+/**
+ * @internal
+ *
+ * Executes the MD5 transformation on several messages with the scalar instructions, one
+ * message per lane. The steps of the lanes are interleaved: each step of a message
+ * depends on the previous one, so a single message leaves most of the execution ports
+ * idle, while the steps of independent messages run in parallel. This helps the CPUs
+ * without AVX2, or where it is disabled.
+ *
+ * @tparam Lanes    Number of messages. The states of 4 messages do not fit in the 16
+ *                  registers of x86-64, so the library uses 2.
+ *
+ * @param state     Transposed states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+template<int Lanes>
+static void md5Scalar( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[ Lanes ];
+    uint32_t x[16][ Lanes ];
+    uint32_t a[ Lanes ], b[ Lanes ], c[ Lanes ], d[ Lanes ], tmp;
+    const uint8_t *p;
+    int i, l;
+
+    for( l = 0; l < Lanes; l++ ) {
+        lanes[ l ] = blocks[ l ];
+    }
+
+    for( ; count > 0; count-- ) {
+        #pragma GCC unroll 4
+        for( l = 0; l < Lanes; l++ ) {
+            #pragma GCC unroll 16
+            for( i = 0; i < 16; i++ ) {
+                p = lanes[ l ] + i * 4;
+                x[ i ][ l ] = (uint32_t) p[ 0 ] | (uint32_t) p[ 1 ] << 8 | (uint32_t) p[ 2 ] << 16 | (uint32_t) p[ 3 ] << 24;
+            }
+
+            lanes[ l ] += 64;
+            a[ l ] = state[ l ];
+            b[ l ] = state[ Lanes + l ];
+            c[ l ] = state[ 2 * Lanes + l ];
+            d[ l ] = state[ 3 * Lanes + l ];
+        }
+
+        // Steps 1 to 64: a = b + ( ( a + F( b, c, d ) + x + ac ) <<< s ), then rotate a, b, c and d
+        #pragma GCC unroll 64
+        for( i = 0; i < 64; i++ ) {
+            #pragma GCC unroll 4
+            for( l = 0; l < Lanes; l++ ) {
+                if( i < 16 ) {
+                    tmp = d[ l ] ^ ( b[ l ] & ( c[ l ] ^ d[ l ] ) );
+                }
+                else if( i < 32 ) {
+                    tmp = c[ l ] ^ ( d[ l ] & ( b[ l ] ^ c[ l ] ) );
+                }
+                else if( i < 48 ) {
+                    tmp = b[ l ] ^ c[ l ] ^ d[ l ];
+                }
+                else {
+                    tmp = c[ l ] ^ ( b[ l ] | ~d[ l ] );
+                }
+
+                tmp += a[ l ] + x[ md5Word( i ) ][ l ] + KMd5[ i ];
+                a[ l ] = d[ l ];
+                d[ l ] = c[ l ];
+                c[ l ] = b[ l ];
+                b[ l ] += ROTL( tmp, SMd5[ i / 16 ][ i & 3 ], 32 );
+            }
+        }
+
+        #pragma GCC unroll 4
+        for( l = 0; l < Lanes; l++ ) {
+            state[ l ] += a[ l ];
+            state[ Lanes + l ] += b[ l ];
+            state[ 2 * Lanes + l ] += c[ l ];
+            state[ 3 * Lanes + l ] += d[ l ];
+        }
+    }
+}
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Executes the MD5 transformation on 8 messages with AVX2, one message per 32-bits lane.
+ *
+ * @param state     Transposed states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx2" ) ))
+static void md5Avx2x8( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const __m256i ones = _mm256_set1_epi32( -1 );
+    const uint8_t *lanes[8];
+    __m256i x[16];
+    __m256i v[4];
+    __m256i a, b, c, d, f, tmp;
+    int i;
+
+    for( i = 0; i < 8; i++ ) {
+        lanes[ i ] = blocks[ i ];
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        v[ i ] = _mm256_loadu_si256( (const __m256i *) &state[ i * 8 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad8( x, lanes, 0, false );
+        multiBufferLoad8( x + 8, lanes, 32, false );
+
+        for( i = 0; i < 8; i++ ) {
+            lanes[ i ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+
+        // Steps 1 to 64: a = b + ( ( a + F( b, c, d ) + x + ac ) <<< s ), then rotate a, b, c and d
+        #pragma GCC unroll 64
+        for( i = 0; i < 64; i++ ) {
+            if( i < 16 ) {
+                f = _mm256_xor_si256( d, _mm256_and_si256( b, _mm256_xor_si256( c, d ) ) );
+            }
+            else if( i < 32 ) {
+                f = _mm256_xor_si256( c, _mm256_and_si256( d, _mm256_xor_si256( b, c ) ) );
+            }
+            else if( i < 48 ) {
+                f = _mm256_xor_si256( _mm256_xor_si256( b, c ), d );
+            }
+            else {
+                f = _mm256_xor_si256( c, _mm256_or_si256( b, _mm256_xor_si256( d, ones ) ) );
+            }
+
+            tmp = _mm256_add_epi32( _mm256_add_epi32( a, f ), _mm256_add_epi32( x[ md5Word( i ) ], _mm256_set1_epi32( KMd5[ i ] ) ) );
+            tmp = _mm256_or_si256( _mm256_slli_epi32( tmp, SMd5[ i / 16 ][ i & 3 ] ), _mm256_srli_epi32( tmp, 32 - SMd5[ i / 16 ][ i & 3 ] ) );
+            a = d;
+            d = c;
+            c = b;
+            b = _mm256_add_epi32( b, tmp );
+        }
+
+        v[ 0 ] = _mm256_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm256_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm256_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm256_add_epi32( v[ 3 ], d );
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        _mm256_storeu_si256( (__m256i *) &state[ i * 8 ], v[ i ] );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the MD5 transformation on 16 messages with AVX-512, one message per 32-bits
+ * lane. The F, G, H and I functions are single vpternlogd instructions.
+ *
+ * @param state     Transposed states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx512f,avx512bw" ) ))
+static void md5Avx512x16( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[16];
+    __m512i x[16];
+    __m512i v[4];
+    __m512i a, b, c, d, f, tmp;
+    int i;
+
+    for( i = 0; i < 16; i++ ) {
+        lanes[ i ] = blocks[ i ];
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        v[ i ] = _mm512_loadu_si512( (const void *) &state[ i * 16 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad16( x, lanes, false );
+
+        for( i = 0; i < 16; i++ ) {
+            lanes[ i ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+
+        // Steps 1 to 64; 0xca is F( x, y, z ), 0xe4 is G, 0x96 is H and 0x39 is I
+        #pragma GCC unroll 64
+        for( i = 0; i < 64; i++ ) {
+            if( i < 16 ) {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0xca );
+            }
+            else if( i < 32 ) {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0xe4 );
+            }
+            else if( i < 48 ) {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0x96 );
+            }
+            else {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0x39 );
+            }
+
+            tmp = _mm512_add_epi32( _mm512_add_epi32( a, f ), _mm512_add_epi32( x[ md5Word( i ) ], _mm512_set1_epi32( KMd5[ i ] ) ) );
+            tmp = _mm512_rolv_epi32( tmp, _mm512_set1_epi32( SMd5[ i / 16 ][ i & 3 ] ) );
+            a = d;
+            d = c;
+            c = b;
+            b = _mm512_add_epi32( b, tmp );
+        }
+
+        v[ 0 ] = _mm512_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm512_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm512_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm512_add_epi32( v[ 3 ], d );
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        _mm512_storeu_si512( (void *) &state[ i * 16 ], v[ i ] );
+    }
+}
+
+#endif  // __x86_64__
+
+/** MD5 as hashed by the multi-buffer kernels. */
+static const MultiBufferAlgorithm md5Algorithm = { Md5Init, 4, 16, false, 4, 64 };
+
+/**
+ * @internal
+ *
+ * Hashes the messages of a batch one after the other with the MD5 kernel.
+ */
+static void md5Sequential( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    MD5 md5;
+    size_t i;
+
+    for( i = 0; i < count; i++ ) {
+        md5.init( );
+        md5.update( data[ i ], sizes[ i ] );
+        md5.finalize( );
+        md5.getValue( digests + i * 16, 16 );
+    }
+}
+
+/**
+ * MD5 multi-buffer kernels. The scalar kernel interleaves 2 messages where no vector
+ * kernel is supported.
+ */
+static MultiBufferKernels md5Batch = { "md5-batch", &md5Algorithm, md5Sequential, 0 };
+
+/**
+ * @internal
+ *
+ * Selects the MD5 multi-buffer kernels supported by the CPU (see CPU::getFeatures()). The
+ * widest one is used until calibrated.
+ */
+static bool md5BatchBind( ) {
+    multiBufferAdd( md5Batch, md5Scalar<2>, 2, "scalar-2x", true );
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_AVX2 ) ) {
+        multiBufferAdd( md5Batch, md5Avx2x8, 8, "avx2-8x", true );
+    }
+    if( CPU::has( MULTIBUFFER_AVX512 ) ) {
+        multiBufferAdd( md5Batch, md5Avx512x16, 16, "avx512-16x", true );
+    }
+#endif
+
+    return true;
+}
+
+/** Binds the kernels when the library is loaded. */
+static const bool md5Bound = md5BatchBind( );
+
+/**
+ * @internal
+ *
+ * Binds the multi-buffer kernels again after cpuBind() changed the CPU features.
+ */
+void libhash::md5Rebind( ) {
+    md5Batch.count = 0;
+    md5BatchBind( );
+}
+
+/**
+ * @brief Hashes a batch of independent messages.
+ *
+ * The messages are hashed 16 at a time, one per 32-bits lane (multi-buffer), on CPUs with
+ * AVX-512 (except the first ones, whose clock drops with the 512-bits instructions), or 8
+ * at a time with AVX2. A single message cannot be hashed faster than by transform(), but
+ * the lanes hash many of them, such as the parts of multipart uploads, in about the same
+ * time. The messages can have different lengths. Without AVX2, the scalar kernel hashes 2
+ * messages at a time, interleaving their steps.
+ * With <tt>LIBHASH_CALIBRATE</tt>, the kernels are measured the first time and each batch
+ * uses the fastest one for the mean size of its messages (see CPU).
+ *
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests: <tt>count * 16</tt> bytes, the digest of
+ *                  message <tt>i</tt> starting at <tt>digests[ i * 16 ]</tt>.
+ */
+void MD5::batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    multiBufferBatch( md5Batch, data, sizes, count, digests );
+}
+
+/**
+ * @brief Retrieves the name of the kernel used by batch() on large messages.
+ *
+ * @return the multi-buffer kernel name, such as <tt>"avx2-8x"</tt> or
+ *         <tt>"scalar-2x"</tt>.
+ */
+const char *MD5::getBatchKernel( ) {
+    return multiBufferName( md5Batch );
+}
+
 /**
  * @brief Creates a new MD5 handler.
  *
@@ -476,4 +858,27 @@ int hash_md5_destroy( void *h ) {
     return rc;
 }
 
+/**
+ * @brief Hashes a batch of independent messages with MD5.
+ *
+ * See {@link MD5::batch}.
+ *
+ * @param data    Pointers to the messages.
+ * @param sizes   Number of bytes of each message.
+ * @param count   Number of messages.
+ * @param digests Buffer receiving the <tt>count * 16</tt> bytes of digests.
+ *
+ * @return a non-zero value on success or 0 if a pointer is <tt>NULL</tt>.
+ */
+int hash_md5_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    int rc = 0;
+
+    if(  data != NULL && sizes != NULL && digests != NULL ) {
+        rc = 1;
+        MD5::batch( data, sizes, count, digests );
+    }
+
+    return rc;
+}
+
 // EOF: md5.cpp
\ No newline at end of file
@@ -0,0 +1,470 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       multibuffer.cpp
+//
+// Author:     Yanick Poirier
+// Date:       2019-12-07
+//
+// Description
+// Scheduler of the multi-buffer (batch) hashing kernels.
+//=============================================================================
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../include/libhash/defs.h"
+#include "calibrate.h"
+#include "multibuffer.h"
+
+using namespace libhash;
+
+//-----------------------------------------------------------------------------
+// MACROS
+//-----------------------------------------------------------------------------
+
+/** Job index of an idle lane. */
+#define MULTIBUFFER_IDLE        SIZE_MAX
+
+/** Maximum size in bytes of a digest. */
+#define MULTIBUFFER_DIGEST      64
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * @brief Message assigned to a lane of a multi-buffer kernel.
+ */
+struct MultiBufferLane {
+    /** Index of the message in the batch; MULTIBUFFER_IDLE when the lane is idle. */
+    size_t          job;
+
+    /** Message. */
+    const uint8_t   *message;
+
+    /** Number of bytes in <tt>message</tt>. */
+    size_t          size;
+
+    /** Next block to process. */
+    const uint8_t   *data;
+
+    /** Number of contiguous blocks left at <tt>data</tt>. */
+    size_t          blocks;
+
+    /** <tt>true</tt> once the lane processes the padded tail of the message. */
+    bool            padded;
+
+    /** Last bytes of the message with the padding and the length. */
+    uint8_t         tail[ MULTIBUFFER_BLOCK * 2 ];
+} ;
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+/**
+ * @internal
+ *
+ * Moves a lane to the padded tail of its message: the last incomplete block, the padding
+ * bit and the message length in 1 or 2 blocks. The length takes the last eighth of the
+ * block (8 or 16 bytes); a <tt>size_t</tt> only fills its last 8 bytes.
+ *
+ * @param lane      Lane whose complete blocks were processed.
+ * @param algorithm Hashed algorithm.
+ */
+static void multiBufferPad( MultiBufferLane &lane, const MultiBufferAlgorithm &algorithm ) {
+    const size_t block = algorithm.blockSize;
+    size_t rest = lane.size % block;
+    size_t total = rest < block - block / 8 ? block : block * 2;
+    uint64_t bits = (uint64_t) lane.size << 3;
+    int i;
+
+    ::memcpy( lane.tail, lane.message + lane.size - rest, rest );
+    lane.tail[ rest ] = 0x80;
+    ::memset( lane.tail + rest + 1, 0, total - rest - 9 );
+
+    for( i = 0; i < 8; i++ ) {
+        lane.tail[ algorithm.bigEndian ? total - 1 - i : total - 8 + i ] = (uint8_t) ( bits >> ( i * 8 ) );
+    }
+
+    lane.data = lane.tail;
+    lane.blocks = total / block;
+    lane.padded = true;
+}
+
+/**
+ * @internal
+ *
+ * Retrieves a word of a lane in the transposed states.
+ *
+ * @param state     Transposed states.
+ * @param algorithm Hashed algorithm.
+ * @param word      Index of the word.
+ * @param index     Index of the lane.
+ * @param lanes     Number of lanes.
+ *
+ * @return the word.
+ */
+static uint64_t multiBufferGet( const uint32_t *state, const MultiBufferAlgorithm &algorithm,
+                                unsigned word, unsigned index, unsigned lanes ) {
+    size_t unit = word * lanes + index;
+
+    if( algorithm.wordSize == 8 ) {
+        return state[ unit * 2 ] | ( (uint64_t) state[ unit * 2 + 1 ] << 32 );
+    }
+
+    return state[ unit ];
+}
+
+/**
+ * @internal
+ *
+ * Sets a word of a lane in the transposed states.
+ *
+ * @param state     Transposed states.
+ * @param algorithm Hashed algorithm.
+ * @param word      Index of the word.
+ * @param index     Index of the lane.
+ * @param lanes     Number of lanes.
+ * @param value     New value of the word.
+ */
+static void multiBufferSet( uint32_t *state, const MultiBufferAlgorithm &algorithm,
+                            unsigned word, unsigned index, unsigned lanes, uint64_t value ) {
+    size_t unit = word * lanes + index;
+
+    if( algorithm.wordSize == 8 ) {
+        state[ unit * 2 ] = (uint32_t) value;
+        state[ unit * 2 + 1 ] = (uint32_t) ( value >> 32 );
+    }
+    else {
+        state[ unit ] = (uint32_t) value;
+    }
+}
+
+/**
+ * @internal
+ *
+ * Assigns a message to a lane and resets the lane's state.
+ *
+ * @param lane      Lane to assign.
+ * @param algorithm Hashed algorithm.
+ * @param state     Transposed states.
+ * @param index     Index of the lane.
+ * @param lanes     Number of lanes.
+ * @param job       Index of the message in the batch.
+ * @param message   Message.
+ * @param size      Number of bytes in <tt>message</tt>.
+ */
+static void multiBufferStart( MultiBufferLane &lane, const MultiBufferAlgorithm &algorithm, uint32_t *state,
+                              unsigned index, unsigned lanes, size_t job, const uint8_t *message, size_t size ) {
+    unsigned i;
+
+    for( i = 0; i < algorithm.words; i++ ) {
+        if( algorithm.wordSize == 8 ) {
+            multiBufferSet( state, algorithm, i, index, lanes, ( (const uint64_t *) algorithm.init )[ i ] );
+        }
+        else {
+            multiBufferSet( state, algorithm, i, index, lanes, ( (const uint32_t *) algorithm.init )[ i ] );
+        }
+    }
+
+    lane.job = job;
+    lane.message = message;
+    lane.size = size;
+    lane.data = message;
+    lane.blocks = size / algorithm.blockSize;
+    lane.padded = false;
+
+    if( lane.blocks == 0 ) {
+        multiBufferPad( lane, algorithm );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Stores the digest of a lane.
+ *
+ * @param digest    Buffer receiving the digest.
+ * @param algorithm Hashed algorithm.
+ * @param state     Transposed states.
+ * @param index     Index of the lane.
+ * @param lanes     Number of lanes.
+ */
+static void multiBufferStore( uint8_t *digest, const MultiBufferAlgorithm &algorithm, const uint32_t *state,
+                              unsigned index, unsigned lanes ) {
+    const unsigned size = algorithm.wordSize;
+    unsigned i, j;
+
+    // The digest can end in the middle of a word
+    for( i = 0; i < algorithm.digestSize; i++ ) {
+        uint64_t word = multiBufferGet( state, algorithm, i / size, index, lanes );
+
+        j = i % size;
+        digest[ i ] = (uint8_t) ( word >> ( ( algorithm.bigEndian ? size - 1 - j : j ) * 8 ) );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Hashes a batch of messages with a multi-buffer kernel.
+ *
+ * Each lane hashes one message. The kernel runs for as many blocks as all the busy lanes
+ * can read contiguously; then the lanes which reached the end of their message blocks move
+ * to the padded tail, and those done with the tail store their digest and take the next
+ * message. Once no message is left, the idle lanes run on the blocks of a busy lane and
+ * their result is ignored. Their state starts at zero, so a batch smaller than the lanes
+ * never reads uninitialized memory.
+ *
+ * @param kernel    Multi-buffer kernel; its transformation cannot be <tt>NULL</tt>.
+ * @param algorithm Hashed algorithm.
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests, one after the other.
+ */
+void libhash::multiBufferHash( const MultiBufferKernel &kernel, const MultiBufferAlgorithm &algorithm,
+                               const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    const unsigned lanes = kernel.lanes;
+    const size_t digestSize = algorithm.digestSize;
+    uint32_t state[ MULTIBUFFER_STATE ] = { 0 };
+    MultiBufferLane lane[ MULTIBUFFER_LANES ];
+    const uint8_t *blocks[ MULTIBUFFER_LANES ];
+    const uint8_t *busy;
+    size_t next = 0;
+    size_t n;
+    unsigned active = 0;
+    unsigned l;
+
+    for( l = 0; l < lanes; l++ ) {
+        lane[ l ].job = MULTIBUFFER_IDLE;
+        if( next < count ) {
+            multiBufferStart( lane[ l ], algorithm, state, l, lanes, next, (const uint8_t *) data[ next ], sizes[ next ] );
+            next++;
+            active++;
+        }
+    }
+
+    while( active > 0 ) {
+        // Number of blocks all the busy lanes can process
+        n = SIZE_MAX;
+        busy = NULL;
+        for( l = 0; l < lanes; l++ ) {
+            if( lane[ l ].job != MULTIBUFFER_IDLE ) {
+                n = lane[ l ].blocks < n ? lane[ l ].blocks : n;
+                busy = lane[ l ].data;
+            }
+        }
+
+        for( l = 0; l < lanes; l++ ) {
+            blocks[ l ] = lane[ l ].job != MULTIBUFFER_IDLE ? lane[ l ].data : busy;
+        }
+
+        kernel.transform( state, blocks, n );
+
+        for( l = 0; l < lanes; l++ ) {
+            MultiBufferLane &current = lane[ l ];
+
+            if( current.job == MULTIBUFFER_IDLE ) {
+                continue;
+            }
+
+            current.data += n * algorithm.blockSize;
+            current.blocks -= n;
+            if( current.blocks > 0 ) {
+                continue;
+            }
+
+            if( !current.padded ) {
+                multiBufferPad( current, algorithm );
+                continue;
+            }
+
+            multiBufferStore( digests + current.job * digestSize, algorithm, state, l, lanes );
+
+            if( next < count ) {
+                multiBufferStart( current, algorithm, state, l, lanes, next, (const uint8_t *) data[ next ], sizes[ next ] );
+                next++;
+            }
+            else {
+                current.job = MULTIBUFFER_IDLE;
+                active--;
+            }
+        }
+    }
+
+    // Clear sensitive information
+    ::memset( state, 0, sizeof ( state ) );
+    ::memset( lane, 0, sizeof ( lane ) );
+}
+
+/**
+ * @internal
+ *
+ * Runs a kernel for cpuCalibrate() on a batch of MULTIBUFFER_LANES messages sharing the
+ * <tt>size</tt> bytes, so every kernel gets the same work and the widest one fills its
+ * lanes. The context is the MultiBufferKernels of the algorithm.
+ */
+static bool multiBufferBenchmark( const void *context, unsigned kernel, const uint8_t *buffer, size_t size ) {
+    const MultiBufferKernels *kernels = (const MultiBufferKernels *) context;
+    const MultiBufferKernel &current = kernels->kernels[ kernel ];
+    const void *data[ MULTIBUFFER_LANES ];
+    size_t sizes[ MULTIBUFFER_LANES ];
+    uint8_t digests[ MULTIBUFFER_LANES * MULTIBUFFER_DIGEST ];
+    int i;
+
+    for( i = 0; i < MULTIBUFFER_LANES; i++ ) {
+        data[ i ] = buffer;
+        sizes[ i ] = size / MULTIBUFFER_LANES;
+    }
+
+    if( current.transform != NULL ) {
+        multiBufferHash( current, *kernels->algorithm, data, sizes, MULTIBUFFER_LANES, digests );
+    }
+    else {
+        kernels->sequential( data, sizes, MULTIBUFFER_LANES, digests );
+    }
+
+    return true;
+}
+
+/**
+ * @internal
+ *
+ * Measures the minimum mean message size of the kernels with cpuCalibrate(), the first
+ * time a batch could use them. Calibrating on first use keeps the measure out of the
+ * processes that never hash a batch. The messages of the measured batches are 4 bytes to
+ * 4KB, where the multi-buffer kernels compete with a single stream.
+ *
+ * @param kernels   Kernels of the algorithm.
+ */
+static void multiBufferCalibrate( MultiBufferKernels &kernels ) {
+    std::call_once( kernels.calibrated, [ &kernels ]( ) {
+        size_t thresholds[ MULTIBUFFER_KERNELS - 1 ];
+
+        if( cpuCalibrate( kernels.name, kernels.count, multiBufferBenchmark, &kernels, thresholds ) ) {
+            for( unsigned k = 1; k < kernels.count; k++ ) {
+                kernels.thresholds[ k ] = thresholds[ k - 1 ] == SIZE_MAX ? SIZE_MAX : thresholds[ k - 1 ] / MULTIBUFFER_LANES;
+            }
+        }
+    } );
+}
+
+/**
+ * @internal
+ *
+ * Adds a kernel supported by the CPU. The kernels must be added from the narrowest.
+ *
+ * @param kernels   Kernels of the algorithm.
+ * @param transform Transformation.
+ * @param lanes     Number of lanes of <tt>transform</tt>.
+ * @param name      Kernel name reported by the batch API.
+ * @param preferred <tt>true</tt> if the kernel is used on this CPU until calibrated.
+ */
+void libhash::multiBufferAdd( MultiBufferKernels &kernels, MultiBufferTransform transform, unsigned lanes,
+                              const char *name, bool preferred ) {
+    MultiBufferKernel &kernel = kernels.kernels[ kernels.count ];
+
+    kernel.transform = transform;
+    kernel.lanes = lanes;
+    kernel.name = name;
+    kernels.thresholds[ kernels.count ] = preferred ? 0 : SIZE_MAX;
+    kernels.count++;
+}
+
+/**
+ * @internal
+ *
+ * Hashes a batch of messages with the widest kernel whose threshold is not above the mean
+ * size of the messages. A single message is always hashed by the sequential fallback.
+ *
+ * @param kernels   Kernels of the algorithm.
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests, one after the other.
+ */
+void libhash::multiBufferBatch( MultiBufferKernels &kernels, const void *const *data, const size_t *sizes,
+                                size_t count, uint8_t *digests ) {
+    size_t total = 0;
+    size_t i;
+    unsigned k;
+
+    if( count < 2 || kernels.count == 0 ) {
+        kernels.sequential( data, sizes, count, digests );
+        return;
+    }
+
+    multiBufferCalibrate( kernels );
+
+    for( i = 0; i < count; i++ ) {
+        total += sizes[ i ];
+    }
+
+    k = kernels.count - 1;
+    while( k > 0 && kernels.thresholds[ k ] > total / count ) {
+        k--;
+    }
+
+    if( kernels.kernels[ k ].transform != NULL ) {
+        multiBufferHash( kernels.kernels[ k ], *kernels.algorithm, data, sizes, count, digests );
+    }
+    else {
+        kernels.sequential( data, sizes, count, digests );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the name of the kernel used on batches of large messages.
+ *
+ * @param kernels   Kernels of the algorithm.
+ *
+ * @return the kernel name, or <tt>NULL</tt> if the messages are hashed one after the
+ *         other.
+ */
+const char *libhash::multiBufferName( MultiBufferKernels &kernels ) {
+    unsigned k;
+
+    if( kernels.count == 0 ) {
+        return NULL;
+    }
+
+    multiBufferCalibrate( kernels );
+
+    k = kernels.count - 1;
+    while( k > 0 && kernels.thresholds[ k ] == SIZE_MAX ) {
+        k--;
+    }
+
+    return kernels.kernels[ k ].name;
+}
+
+// EOF: multibuffer.cpp
@@ -0,0 +1,304 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+//=============================================================================
+// System:     libHash
+// File:       multibuffer.h
+//
+// Author:     Yanick Poirier
+// Date:       2019-12-07
+//
+// Description
+// Internal declarations shared by the multi-buffer (batch) hashing kernels. This
+// header is not installed.
+//=============================================================================
+
+#ifndef __LH_MULTIBUFFER_H00__
+#    define __LH_MULTIBUFFER_H00__
+
+//-----------------------------------------------------------------------------
+// HEADER FILES
+//-----------------------------------------------------------------------------
+
+#    include <stdint.h>
+#    include <stddef.h>
+#    include <mutex>
+#    include "../include/libhash/cpu.h"
+
+#    if defined( __x86_64__ )
+// The AVX-512 intrinsics of GCC 12 leave their undefined operands "uninitialized"
+#        pragma GCC diagnostic push
+#        pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#        include <immintrin.h>
+#        pragma GCC diagnostic pop
+#    endif
+
+//-----------------------------------------------------------------------------
+// CONSTANTS & MACROS
+//-----------------------------------------------------------------------------
+
+/** Maximum number of lanes of a multi-buffer kernel. */
+#    define MULTIBUFFER_LANES       16
+
+/**
+ * Size in 32-bits units of the transposed state of all the lanes: 16 lanes of 8 32-bits
+ * words, or 8 lanes of 8 64-bits words.
+ */
+#    define MULTIBUFFER_STATE       128
+
+/** Maximum size in bytes of a message block. */
+#    define MULTIBUFFER_BLOCK       128
+
+/** Maximum number of multi-buffer kernels an algorithm chooses from, its fallback included. */
+#    define MULTIBUFFER_KERNELS     3
+
+/**
+ * CPU features required by the AVX-512 multi-buffer kernels. The first AVX-512 CPUs
+ * (Skylake-SP), whose clock drops with the 512-bits instructions, keep using the AVX2
+ * kernels.
+ */
+#    define MULTIBUFFER_AVX512      ( HASH_CPU_AVX512 | HASH_CPU_AVX512_FAST )
+
+//-----------------------------------------------------------------------------
+// STRUCTURES & TYPEDEFS
+//-----------------------------------------------------------------------------
+
+namespace libhash {
+
+/**
+ * @internal
+ *
+ * @brief Multi-buffer transformation.
+ *
+ * Processes <tt>count</tt> blocks on each lane, one message per lane. The state of the
+ * lanes is transposed: word <tt>i</tt> of lane <tt>l</tt> is stored at
+ * <tt>state[ i * lanes + l ]</tt>, so each word of all the lanes fits in one register. The
+ * 64-bits words of SHA-512 take 2 units: <tt>state[ ( i * lanes + l ) * 2 ]</tt> holds the
+ * low half.
+ */
+typedef void ( *MultiBufferTransform )( uint32_t *state, const uint8_t *const *blocks, size_t count );
+
+/**
+ * @internal
+ *
+ * @brief Multi-buffer kernel of an algorithm.
+ */
+struct MultiBufferKernel {
+    /** Transformation; <tt>NULL</tt> if the CPU does not support one. */
+    MultiBufferTransform    transform;
+
+    /** Number of lanes of <tt>transform</tt>. */
+    unsigned                lanes;
+
+    /** Kernel name reported by the batch API. */
+    const char              *name;
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Description of an algorithm hashed by multiBufferHash().
+ *
+ * The algorithm must pad its blocks with a 1 bit and the message length in bits, stored in
+ * the last eighth of the block: MD5, SHA-1 and SHA-224/256 (64 bytes blocks, 32-bits words)
+ * or SHA-384/512 (128 bytes blocks, 64-bits words).
+ */
+struct MultiBufferAlgorithm {
+    /** Initial state: <tt>words</tt> words of <tt>wordSize</tt> bytes. */
+    const void      *init;
+
+    /** Number of words in the state. */
+    unsigned        words;
+
+    /** Number of bytes in the digest, taken from the beginning of the state. */
+    unsigned        digestSize;
+
+    /** <tt>true</tt> if the length and the digest are big-endian. */
+    bool            bigEndian;
+
+    /** Number of bytes in a word: 4 or 8. */
+    unsigned        wordSize;
+
+    /** Number of bytes in a block: 64 or 128. */
+    unsigned        blockSize;
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Hashes the messages of a batch one after the other with the single stream kernel.
+ */
+typedef void ( *MultiBufferSequential )( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests );
+
+/**
+ * @internal
+ *
+ * @brief Multi-buffer kernels supported by the CPU for an algorithm.
+ *
+ * The kernels go from the narrowest to the widest. Kernel 0 is the fallback: without a
+ * transformation, the messages are hashed one after the other by <tt>sequential</tt>. A
+ * batch uses the widest kernel whose threshold is not above the mean size of its messages.
+ * Until multiBufferCalibrate() measures them, the thresholds follow the CPU features: 0
+ * for the kernels preferred on that CPU and <tt>SIZE_MAX</tt> for the others.
+ */
+struct MultiBufferKernels {
+    /** Calibration name, e.g. <tt>"sha256-batch"</tt>. */
+    const char                  *name;
+
+    /** Hashed algorithm. */
+    const MultiBufferAlgorithm  *algorithm;
+
+    /** Hashes the messages one after the other. */
+    MultiBufferSequential       sequential;
+
+    /** Number of kernels. */
+    unsigned                    count;
+
+    /** Kernels, from the narrowest. */
+    MultiBufferKernel           kernels[ MULTIBUFFER_KERNELS ];
+
+    /** Minimum mean message size of each kernel; always 0 for the fallback. */
+    size_t                      thresholds[ MULTIBUFFER_KERNELS ];
+
+    /** Set once the thresholds are calibrated. */
+    std::once_flag              calibrated;
+} ;
+
+//-----------------------------------------------------------------------------
+// PROTOTYPES
+//-----------------------------------------------------------------------------
+
+void multiBufferHash( const MultiBufferKernel &, const MultiBufferAlgorithm &, const void *const *,
+                      const size_t *, size_t, uint8_t * );
+void multiBufferAdd( MultiBufferKernels &, MultiBufferTransform, unsigned, const char *, bool );
+void multiBufferBatch( MultiBufferKernels &, const void *const *, const size_t *, size_t, uint8_t * );
+const char *multiBufferName( MultiBufferKernels & );
+
+//-----------------------------------------------------------------------------
+// IMPLEMENTATION
+//-----------------------------------------------------------------------------
+
+#    if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Loads 32 bytes of each of 8 lanes and transposes them, so <tt>words[ i ]</tt> holds the
+ * word <tt>i</tt> of all the lanes.
+ *
+ * @param words     Message words.
+ * @param blocks    Blocks of the lanes.
+ * @param offset    Offset of the words in the blocks (0 or 32).
+ * @param bigEndian <tt>true</tt> to read big-endian words.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline void multiBufferLoad8( __m256i *words, const uint8_t *const *blocks, size_t offset, bool bigEndian ) {
+    const __m256i swap = _mm256_set_epi64x( 0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                            0x0c0d0e0f08090a0b, 0x0405060700010203 );
+    __m256i r[8], t[8], u[8];
+    int i;
+
+    for( i = 0; i < 8; i++ ) {
+        r[ i ] = _mm256_loadu_si256( (const __m256i *) ( blocks[ i ] + offset ) );
+        if( bigEndian ) {
+            r[ i ] = _mm256_shuffle_epi8( r[ i ], swap );
+        }
+    }
+
+    for( i = 0; i < 8; i += 2 ) {
+        t[ i ] = _mm256_unpacklo_epi32( r[ i ], r[ i + 1 ] );
+        t[ i + 1 ] = _mm256_unpackhi_epi32( r[ i ], r[ i + 1 ] );
+    }
+
+    for( i = 0; i < 8; i += 4 ) {
+        u[ i ] = _mm256_unpacklo_epi64( t[ i ], t[ i + 2 ] );
+        u[ i + 1 ] = _mm256_unpackhi_epi64( t[ i ], t[ i + 2 ] );
+        u[ i + 2 ] = _mm256_unpacklo_epi64( t[ i + 1 ], t[ i + 3 ] );
+        u[ i + 3 ] = _mm256_unpackhi_epi64( t[ i + 1 ], t[ i + 3 ] );
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        words[ i ] = _mm256_permute2x128_si256( u[ i ], u[ i + 4 ], 0x20 );
+        words[ i + 4 ] = _mm256_permute2x128_si256( u[ i ], u[ i + 4 ], 0x31 );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Loads the 64 bytes block of each of 16 lanes and transposes them, so <tt>words[ i ]</tt>
+ * holds the word <tt>i</tt> of all the lanes.
+ *
+ * The 32-bits and 64-bits unpacks transpose the 4x4 words of each 128-bits chunk; the
+ * chunks are then transposed with 2 rounds of shuffles.
+ *
+ * @param words     Message words.
+ * @param blocks    Blocks of the lanes.
+ * @param bigEndian <tt>true</tt> to read big-endian words.
+ */
+__attribute__(( target( "avx512f,avx512bw" ), always_inline ))
+static inline void multiBufferLoad16( __m512i *words, const uint8_t *const *blocks, bool bigEndian ) {
+    const __m512i swap = _mm512_set_epi64( 0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                           0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                           0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                           0x0c0d0e0f08090a0b, 0x0405060700010203 );
+    __m512i r[16], t[16], u[16];
+    __m512i lo0, hi0, lo1, hi1;
+    int i;
+
+    for( i = 0; i < 16; i++ ) {
+        r[ i ] = _mm512_loadu_si512( (const void *) blocks[ i ] );
+        if( bigEndian ) {
+            r[ i ] = _mm512_shuffle_epi8( r[ i ], swap );
+        }
+    }
+
+    for( i = 0; i < 16; i += 2 ) {
+        t[ i ] = _mm512_unpacklo_epi32( r[ i ], r[ i + 1 ] );
+        t[ i + 1 ] = _mm512_unpackhi_epi32( r[ i ], r[ i + 1 ] );
+    }
+
+    // u[ 4 * g + k ] holds the words 4 * c + k of the lanes 4 * g to 4 * g + 3 in chunk c
+    for( i = 0; i < 16; i += 4 ) {
+        u[ i ] = _mm512_unpacklo_epi64( t[ i ], t[ i + 2 ] );
+        u[ i + 1 ] = _mm512_unpackhi_epi64( t[ i ], t[ i + 2 ] );
+        u[ i + 2 ] = _mm512_unpacklo_epi64( t[ i + 1 ], t[ i + 3 ] );
+        u[ i + 3 ] = _mm512_unpackhi_epi64( t[ i + 1 ], t[ i + 3 ] );
+    }
+
+    for( i = 0; i < 4; i++ ) {
+        lo0 = _mm512_shuffle_i32x4( u[ i ], u[ i + 4 ], 0x44 );
+        hi0 = _mm512_shuffle_i32x4( u[ i ], u[ i + 4 ], 0xee );
+        lo1 = _mm512_shuffle_i32x4( u[ i + 8 ], u[ i + 12 ], 0x44 );
+        hi1 = _mm512_shuffle_i32x4( u[ i + 8 ], u[ i + 12 ], 0xee );
+
+        words[ i ] = _mm512_shuffle_i32x4( lo0, lo1, 0x88 );
+        words[ i + 4 ] = _mm512_shuffle_i32x4( lo0, lo1, 0xdd );
+        words[ i + 8 ] = _mm512_shuffle_i32x4( hi0, hi1, 0x88 );
+        words[ i + 12 ] = _mm512_shuffle_i32x4( hi0, hi1, 0xdd );
+    }
+}
+
+#    endif  // __x86_64__
+
+};  // namespace libhash
+
+#endif   // __LH_MULTIBUFFER_H00__
+
+// EOF: multibuffer.h
@@ -36,7 +36,14 @@
 #include <string.h>
 #include "../include/libhash/defs.h"
 #include "../include/libhash/hashbase.h"
+#include "../include/libhash/cpu.h"
 #include "../include/libhash/sha1.h"
+#include "multibuffer.h"
+#include "kernels.h"
+
+#if defined( __x86_64__ )
+#    include <immintrin.h>
+#endif
 
 using namespace libhash;
 
@@ -47,10 +54,26 @@ using namespace libhash;
 // SHA-1 constants
 uint32_t KSha1[]   = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
 
+// SHA-1 initial state
+const uint32_t Sha1Init[5] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
 //-----------------------------------------------------------------------------
 // STRUCTURES & TYPEDEFS
 //-----------------------------------------------------------------------------
 
+/**
+ * @internal
+ *
+ * @brief Multi-block SHA-1 transformation.
+ */
+struct SHA1Kernel {
+    /** Processes a number of 64 bytes blocks. */
+    void ( *transform )( uint32_t *state, const uint8_t *blocks, size_t count );
+
+    /** Name reported by getKernel(). */
+    const char  *name;
+} ;
+
 //-----------------------------------------------------------------------------
 // CLASSES
 //-----------------------------------------------------------------------------
@@ -75,6 +98,446 @@ inline uint32_t MAJ( uint32_t x, uint32_t y, uint32_t z ) {
     return ( x & y ) ^ ( x & z ) ^ ( y & z );
 }
 
+//=== SHA-1 kernels ===========================================================
+
+/**
+ * @internal
+ *
+ * Executes the SHA-1 transformation rounds in C.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+static void sha1Generic( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    uint32_t tmp;
+    uint32_t W[80];
+    uint32_t a, b, c, d, e;  // Working variables
+    int32_t  t;
+
+    for( ; count > 0; count--, blocks += 64 ) {
+        // Prepare the buffer schedule
+        for( t = 0; t < 16; t++ ) {
+            W[ t ] = ( blocks[ t * 4 ] << 24 ) |
+                    ( blocks[ ( t * 4 ) + 1 ] << 16 ) |
+                    ( blocks[ ( t * 4 ) + 2 ] << 8 ) |
+                    blocks[ ( t * 4 ) + 3 ];
+        }
+
+        for( t = 16; t < 80; t++ ) {
+            tmp = W[ t - 3 ] ^ W[ t - 8 ] ^ W[ t - 14 ] ^ W[ t - 16 ];
+            W[ t ] = ROTL( tmp, 1, 32 );
+        }
+
+        // Initialize working variables
+        a = state[ 0 ];
+        b = state[ 1 ];
+        c = state[ 2 ];
+        d = state[ 3 ];
+        e = state[ 4 ];
+
+        // Rounds 0 to 19
+        for( t = 0; t < 20; t++ ) {
+            tmp = ROTL( a, 5, 32 ) + CH( b, c, d ) + e + KSha1[ 0 ] + W[ t ];
+            e = d;
+            d = c;
+            c = ROTL( b, 30, 32 );
+            b = a;
+            a = tmp;
+        }
+
+        // Rounds 20 to 39
+        for( t = 20; t < 40; t++ ) {
+            tmp = ROTL( a, 5, 32 ) + PARITY( b, c, d ) + e + KSha1[ 1 ] + W[ t ];
+            e = d;
+            d = c;
+            c = ROTL( b, 30, 32 );
+            b = a;
+            a = tmp;
+        }
+
+        // Rounds 40 to 59
+        for( t = 40; t < 60; t++ ) {
+            tmp = ROTL( a, 5, 32 ) + MAJ( b, c, d ) + e + KSha1[ 2 ] + W[ t ];
+            e = d;
+            d = c;
+            c = ROTL( b, 30, 32 );
+            b = a;
+            a = tmp;
+        }
+
+        // Rounds 60 to 79
+        for( t = 60; t < 80; t++ ) {
+            tmp = ROTL( a,  5, 32 ) + PARITY( b, c, d ) + e + KSha1[ 3 ] + W[ t ];
+            e = d;
+            d = c;
+            c = ROTL( b, 30, 32 );
+            b = a;
+            a = tmp;
+        }
+
+        // Update the state of the context
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+        state[ 4 ] += e;
+    }
+}
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Executes 4 SHA-1 rounds with the SHA extensions and updates the message schedule.
+ *
+ * The 16 message words of the rounds <tt>4 * G</tt> onward are kept in 4 registers used in
+ * turn. The next words are computed as <tt>W[t] = rol(W[t-3] ^ W[t-8] ^ W[t-14] ^
+ * W[t-16], 1)</tt>: <tt>prev</tt> receives the sha1msg1 part, <tt>after</tt> the
+ * W[t-8] part and <tt>next</tt> is completed with sha1msg2. The E value alternates
+ * between two registers: <tt>e</tt> feeds these rounds and <tt>eNext</tt> receives A for
+ * the next ones.
+ *
+ * @tparam G        Index of the group of 4 rounds (0 to 19).
+ */
+template<int G>
+__attribute__(( target( "sha,sse4.1,ssse3" ), always_inline ))
+static inline void sha1ShaNIRounds( __m128i &abcd, __m128i &e, __m128i &eNext, __m128i msg,
+                                    __m128i &prev, __m128i &next, __m128i &after ) {
+    e = G == 0 ? _mm_add_epi32( e, msg ) : _mm_sha1nexte_epu32( e, msg );
+    eNext = abcd;
+
+    if( G >= 3 && G <= 18 ) {
+        next = _mm_sha1msg2_epu32( next, msg );
+    }
+
+    abcd = _mm_sha1rnds4_epu32( abcd, e, G / 5 );
+
+    if( G >= 1 && G <= 16 ) {
+        prev = _mm_sha1msg1_epu32( prev, msg );
+    }
+
+    if( G >= 2 && G <= 17 ) {
+        after = _mm_xor_si128( after, msg );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-1 transformation rounds with the SHA extensions (SHA-NI).
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+__attribute__(( target( "sha,sse4.1,ssse3" ) ))
+static void sha1ShaNI( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    const __m128i swap = _mm_set_epi64x( 0x0001020304050607, 0x08090a0b0c0d0e0f );
+    __m128i abcd, e0, e1, abcdSave, eSave;
+    __m128i m0, m1, m2, m3;
+
+    abcd = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i *) state ), 0x1b );
+    e0 = _mm_set_epi32( state[ 4 ], 0, 0, 0 );
+
+    for( ; count > 0; count--, blocks += 64 ) {
+        abcdSave = abcd;
+        eSave = e0;
+
+        // Message words in big-endian order, W[0] in the highest lane
+        m0 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 0 ) ), swap );
+        m1 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 16 ) ), swap );
+        m2 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 32 ) ), swap );
+        m3 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 48 ) ), swap );
+
+        sha1ShaNIRounds<0>( abcd, e0, e1, m0, m3, m1, m2 );
+        sha1ShaNIRounds<1>( abcd, e1, e0, m1, m0, m2, m3 );
+        sha1ShaNIRounds<2>( abcd, e0, e1, m2, m1, m3, m0 );
+        sha1ShaNIRounds<3>( abcd, e1, e0, m3, m2, m0, m1 );
+        sha1ShaNIRounds<4>( abcd, e0, e1, m0, m3, m1, m2 );
+        sha1ShaNIRounds<5>( abcd, e1, e0, m1, m0, m2, m3 );
+        sha1ShaNIRounds<6>( abcd, e0, e1, m2, m1, m3, m0 );
+        sha1ShaNIRounds<7>( abcd, e1, e0, m3, m2, m0, m1 );
+        sha1ShaNIRounds<8>( abcd, e0, e1, m0, m3, m1, m2 );
+        sha1ShaNIRounds<9>( abcd, e1, e0, m1, m0, m2, m3 );
+        sha1ShaNIRounds<10>( abcd, e0, e1, m2, m1, m3, m0 );
+        sha1ShaNIRounds<11>( abcd, e1, e0, m3, m2, m0, m1 );
+        sha1ShaNIRounds<12>( abcd, e0, e1, m0, m3, m1, m2 );
+        sha1ShaNIRounds<13>( abcd, e1, e0, m1, m0, m2, m3 );
+        sha1ShaNIRounds<14>( abcd, e0, e1, m2, m1, m3, m0 );
+        sha1ShaNIRounds<15>( abcd, e1, e0, m3, m2, m0, m1 );
+        sha1ShaNIRounds<16>( abcd, e0, e1, m0, m3, m1, m2 );
+        sha1ShaNIRounds<17>( abcd, e1, e0, m1, m0, m2, m3 );
+        sha1ShaNIRounds<18>( abcd, e0, e1, m2, m1, m3, m0 );
+        sha1ShaNIRounds<19>( abcd, e1, e0, m3, m2, m0, m1 );
+
+        // E of the next block is the rotated A saved by the last rounds
+        e0 = _mm_sha1nexte_epu32( e0, eSave );
+        abcd = _mm_add_epi32( abcd, abcdSave );
+    }
+
+    _mm_storeu_si128( (__m128i *) state, _mm_shuffle_epi32( abcd, 0x1b ) );
+    state[ 4 ] = _mm_extract_epi32( e0, 3 );
+}
+
+/**
+ * @internal
+ *
+ * Rotates each 32-bits lane left.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i sha1Avx2Rol( __m256i x, int bits ) {
+    return _mm256_or_si256( _mm256_slli_epi32( x, bits ), _mm256_srli_epi32( x, 32 - bits ) );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-1 transformation rounds on 8 messages with AVX2, one message per
+ * 32-bits lane.
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx2" ) ))
+static void sha1Avx2x8( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[8];
+    __m256i W[16];
+    __m256i v[5];
+    __m256i a, b, c, d, e, f, tmp;
+    int t;
+
+    for( t = 0; t < 8; t++ ) {
+        lanes[ t ] = blocks[ t ];
+    }
+
+    for( t = 0; t < 5; t++ ) {
+        v[ t ] = _mm256_loadu_si256( (const __m256i *) &state[ t * 8 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad8( W, lanes, 0, true );
+        multiBufferLoad8( W + 8, lanes, 32, true );
+
+        for( t = 0; t < 8; t++ ) {
+            lanes[ t ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+
+        // Rounds 0 to 79, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 80
+        for( t = 0; t < 80; t++ ) {
+            if( t >= 16 ) {
+                tmp = _mm256_xor_si256( _mm256_xor_si256( W[ ( t - 3 ) & 15 ], W[ ( t - 8 ) & 15 ] ),
+                                        _mm256_xor_si256( W[ ( t - 14 ) & 15 ], W[ t & 15 ] ) );
+                W[ t & 15 ] = sha1Avx2Rol( tmp, 1 );
+            }
+
+            if( t < 20 ) {
+                f = _mm256_xor_si256( _mm256_and_si256( b, c ), _mm256_andnot_si256( b, d ) );
+            }
+            else if( t >= 40 && t < 60 ) {
+                f = _mm256_xor_si256( _mm256_and_si256( b, c ), _mm256_and_si256( _mm256_xor_si256( b, c ), d ) );
+            }
+            else {
+                f = _mm256_xor_si256( _mm256_xor_si256( b, c ), d );
+            }
+
+            tmp = _mm256_add_epi32( _mm256_add_epi32( sha1Avx2Rol( a, 5 ), f ), e );
+            tmp = _mm256_add_epi32( tmp, _mm256_add_epi32( W[ t & 15 ], _mm256_set1_epi32( KSha1[ t / 20 ] ) ) );
+            e = d;
+            d = c;
+            c = sha1Avx2Rol( b, 30 );
+            b = a;
+            a = tmp;
+        }
+
+        v[ 0 ] = _mm256_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm256_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm256_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm256_add_epi32( v[ 3 ], d );
+        v[ 4 ] = _mm256_add_epi32( v[ 4 ], e );
+    }
+
+    for( t = 0; t < 5; t++ ) {
+        _mm256_storeu_si256( (__m256i *) &state[ t * 8 ], v[ t ] );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-1 transformation rounds on 16 messages with AVX-512, one message per
+ * 32-bits lane. The rotations and the 3 inputs functions are single instructions
+ * (vprold and vpternlogd).
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx512f,avx512bw" ) ))
+static void sha1Avx512x16( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[16];
+    __m512i W[16];
+    __m512i v[5];
+    __m512i a, b, c, d, e, f, tmp;
+    int t;
+
+    for( t = 0; t < 16; t++ ) {
+        lanes[ t ] = blocks[ t ];
+    }
+
+    for( t = 0; t < 5; t++ ) {
+        v[ t ] = _mm512_loadu_si512( (const void *) &state[ t * 16 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad16( W, lanes, true );
+
+        for( t = 0; t < 16; t++ ) {
+            lanes[ t ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+
+        // Rounds 0 to 79, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 80
+        for( t = 0; t < 80; t++ ) {
+            if( t >= 16 ) {
+                tmp = _mm512_ternarylogic_epi32( W[ ( t - 3 ) & 15 ], W[ ( t - 8 ) & 15 ], W[ ( t - 14 ) & 15 ], 0x96 );
+                W[ t & 15 ] = _mm512_rol_epi32( _mm512_xor_si512( tmp, W[ t & 15 ] ), 1 );
+            }
+
+            // 0xca is CH( x, y, z ), 0xe8 is MAJ( x, y, z ) and 0x96 is PARITY( x, y, z )
+            if( t < 20 ) {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0xca );
+            }
+            else if( t >= 40 && t < 60 ) {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0xe8 );
+            }
+            else {
+                f = _mm512_ternarylogic_epi32( b, c, d, 0x96 );
+            }
+
+            tmp = _mm512_add_epi32( _mm512_add_epi32( _mm512_rol_epi32( a, 5 ), f ), e );
+            tmp = _mm512_add_epi32( tmp, _mm512_add_epi32( W[ t & 15 ], _mm512_set1_epi32( KSha1[ t / 20 ] ) ) );
+            e = d;
+            d = c;
+            c = _mm512_rol_epi32( b, 30 );
+            b = a;
+            a = tmp;
+        }
+
+        v[ 0 ] = _mm512_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm512_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm512_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm512_add_epi32( v[ 3 ], d );
+        v[ 4 ] = _mm512_add_epi32( v[ 4 ], e );
+    }
+
+    for( t = 0; t < 5; t++ ) {
+        _mm512_storeu_si512( (void *) &state[ t * 16 ], v[ t ] );
+    }
+}
+
+#endif  // __x86_64__
+
+/**
+ * SHA-1 kernel. It is statically initialized to the C transformation, which is used until
+ * the kernels are bound when the library is loaded.
+ */
+static SHA1Kernel sha1Kernel = { sha1Generic, "generic" };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-1 kernel supported by the CPU (see CPU::getFeatures()).
+ */
+static bool sha1Bind( ) {
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) ) {
+        sha1Kernel.transform = sha1ShaNI;
+        sha1Kernel.name = "sha-ni";
+    }
+#endif
+
+    return true;
+}
+
+/** SHA-1 as hashed by the multi-buffer kernels. */
+static const MultiBufferAlgorithm sha1Algorithm = { Sha1Init, 5, 20, true, 4, 64 };
+
+/**
+ * @internal
+ *
+ * Hashes the messages of a batch one after the other with the SHA-1 kernel.
+ */
+static void sha1Sequential( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    SHA1 sha;
+    size_t i;
+
+    for( i = 0; i < count; i++ ) {
+        sha.init( );
+        sha.update( data[ i ], sizes[ i ] );
+        sha.finalize( );
+        sha.getValue( digests + i * 20, 20 );
+    }
+}
+
+/**
+ * SHA-1 multi-buffer kernels. The fallback hashes the messages of a batch one after
+ * the other with the SHA-1 kernel.
+ */
+static MultiBufferKernels sha1Batch = { "sha1-batch", &sha1Algorithm, sha1Sequential, 0 };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-1 multi-buffer kernels supported by the CPU. Until calibrated, the widest
+ * one is used: the AVX2 lanes are used without AVX-512, even with the SHA extensions.
+ */
+static bool sha1BatchBind( ) {
+    multiBufferAdd( sha1Batch, NULL, 1, NULL, true );
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_AVX2 ) ) {
+        multiBufferAdd( sha1Batch, sha1Avx2x8, 8, "avx2-8x", true );
+    }
+    if( CPU::has( MULTIBUFFER_AVX512 ) ) {
+        multiBufferAdd( sha1Batch, sha1Avx512x16, 16, "avx512-16x", true );
+    }
+#endif
+
+    return true;
+}
+
+/** Binds the kernels when the library is loaded. */
+static const bool sha1Bound = sha1Bind( ) && sha1BatchBind( );
+
+/**
+ * @internal
+ *
+ * Binds the kernels again after cpuBind() changed the CPU features, starting over from the
+ * C transformation.
+ */
+void libhash::sha1Rebind( ) {
+    sha1Kernel.transform = sha1Generic;
+    sha1Kernel.name = "generic";
+    sha1Batch.count = 0;
+    sha1Bind( );
+    sha1BatchBind( );
+}
+
 //=== SHA-1 implementation ====================================================
 
 /**
@@ -96,18 +559,39 @@ void SHA1::init( ) {
  * @copydoc HashingBase::update( const void *, lhUInt32 )
  */
 void SHA1::update( const void *data, size_t size ) {
-    uint32_t i;
+    const uint8_t *buffer = (const uint8_t *) data;
+    size_t count;
 
     // Update number of bits
     mBitCount += size << 3;
 
-    for( i = 0; i < size; i++ ) {
-        mBlock[ mIndex++ ] = ( (uint8_t *) data )[ i ];
-        if( mIndex == 64 ) {
-            transform( );
-            mIndex = 0;
+    // Complete the pending block first
+    if( mIndex > 0 ) {
+        count = size < 64 - mIndex ? size : 64 - mIndex;
+        ::memcpy( mBlock + mIndex, buffer, count );
+        mIndex += count;
+        buffer += count;
+        size -= count;
+
+        if( mIndex < 64 ) {
+            return;
         }
+
+        transform( mBlock, 1 );
+        mIndex = 0;
+    }
+
+    // Process the complete blocks directly from the caller's buffer
+    count = size / 64;
+    if( count > 0 ) {
+        transform( buffer, count );
+        buffer += count * 64;
+        size -= count * 64;
     }
+
+    // Buffer the remaining bytes
+    ::memcpy( mBlock, buffer, size );
+    mIndex = size;
 }
 
 /**
@@ -122,14 +606,14 @@ void SHA1::finalize( ) {
             mIndex++;
             ::memset( mBlock + mIndex, 0, 64 - mIndex );
 
-            transform( );
+            transform( mBlock, 1 );
 
             // Pad only 56 bytes on the second block. The last 8 will be filled later with
             // the message length.
             ::memset( mBlock, 0, 56 );
         }
         else {
-            transform( );
+            transform( mBlock, 1 );
 
             mBlock[ 0 ] = 0x80;
             ::memset( mBlock + 1, 0, 55 );
@@ -153,7 +637,7 @@ void SHA1::finalize( ) {
     mBlock[ 63 ] = (uint8_t) ( mBitCount & 0x00000000000000FF );
 
     // Transform the last message block
-    transform( );
+    transform( mBlock, 1 );
 
     // Copy the digest number in the resulting buffer. The resulting digest is big-endian
     for( int i = 0; i < 5; i++ ) {
@@ -171,83 +655,52 @@ void SHA1::finalize( ) {
 }
 
 /**
- * Executes the SHA-1 transformation rounds.
+ * Executes the SHA-1 transformation rounds, with the fastest kernel supported by the CPU.
+ *
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
  */
-void SHA1::transform( ) {
-    uint32_t tmp;
-    uint32_t W[80];
-    uint32_t a, b, c, d, e;  // Working variables
-    int32_t  t;
-
-    // Prepare the buffer schedule
-    for( t = 0; t < 16; t++ ) {
-        W[ t ] = ( mBlock[ t * 4 ] << 24 ) |
-                ( mBlock[ ( t * 4 ) + 1 ] << 16 ) |
-                ( mBlock[ ( t * 4 ) + 2 ] << 8 ) |
-                mBlock[ ( t * 4 ) + 3 ];
-    }
-
-    for( t = 16; t < 80; t++ ) {
-        tmp = W[ t - 3 ] ^ W[ t - 8 ] ^ W[ t - 14 ] ^ W[ t - 16 ];
-        W[ t ] = ROTL( tmp, 1, 32 );
-    }
-
-    // Initialize working variables
-    a = mState[ 0 ];
-    b = mState[ 1 ];
-    c = mState[ 2 ];
-    d = mState[ 3 ];
-    e = mState[ 4 ];
-
-    // Rounds 0 to 19
-    for( t = 0; t < 20; t++ ) {
-        tmp = ROTL( a, 5, 32 ) + CH( b, c, d ) + e + KSha1[ 0 ] + W[ t ];
-        e = d;
-        d = c;
-        c = ROTL( b, 30, 32 );
-        b = a;
-        a = tmp;
-    }
-
-    // Rounds 20 to 39
-    for( t = 20; t < 40; t++ ) {
-        tmp = ROTL( a, 5, 32 ) + PARITY( b, c, d ) + e + KSha1[ 1 ] + W[ t ];
-        e = d;
-        d = c;
-        c = ROTL( b, 30, 32 );
-        b = a;
-        a = tmp;
-    }
+void SHA1::transform( const uint8_t *blocks, size_t count ) {
+    sha1Kernel.transform( mState, blocks, count );
+}
 
-    // Rounds 40 to 59
-    for( t = 40; t < 60; t++ ) {
-        tmp = ROTL( a, 5, 32 ) + MAJ( b, c, d ) + e + KSha1[ 2 ] + W[ t ];
-        e = d;
-        d = c;
-        c = ROTL( b, 30, 32 );
-        b = a;
-        a = tmp;
-    }
+/**
+ * @copydoc HashingBase::getKernel()
+ */
+const char *SHA1::getKernel( ) {
+    return sha1Kernel.name;
+}
 
-    // Rounds 60 to 79
-    for( t = 60; t < 80; t++ ) {
-        tmp = ROTL( a,  5, 32 ) + PARITY( b, c, d ) + e + KSha1[ 3 ] + W[ t ];
-        e = d;
-        d = c;
-        c = ROTL( b, 30, 32 );
-        b = a;
-        a = tmp;
-    }
+/**
+ * @brief Hashes a batch of independent messages.
+ *
+ * The messages are hashed 16 at a time, one per 32-bits lane (multi-buffer), on CPUs with
+ * AVX-512 (except the first ones, whose clock drops with the 512-bits instructions), or 8
+ * at a time with AVX2. The messages can have different lengths. Otherwise, the messages
+ * are hashed one after the other with the fastest SHA-1 kernel.
+ * With <tt>LIBHASH_CALIBRATE</tt>, the kernels are measured the first time and each batch
+ * uses the fastest one for the mean size of its messages (see CPU).
+ *
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests: <tt>count * 20</tt> bytes, the digest of
+ *                  message <tt>i</tt> starting at <tt>digests[ i * 20 ]</tt>.
+ */
+void SHA1::batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    multiBufferBatch( sha1Batch, data, sizes, count, digests );
+}
 
-    // Update the state of the context
-    mState[ 0 ] += a;
-    mState[ 1 ] += b;
-    mState[ 2 ] += c;
-    mState[ 3 ] += d;
-    mState[ 4 ] += e;
+/**
+ * @brief Retrieves the name of the kernel used by batch() on large messages.
+ *
+ * @return the multi-buffer kernel name, such as <tt>"avx512-16x"</tt>, or the name of the
+ *         SHA-1 kernel if the messages are hashed one after the other.
+ */
+const char *SHA1::getBatchKernel( ) {
+    const char *name = multiBufferName( sha1Batch );
 
-    // Reset the current block index
-    mIndex = 0;
+    return name != NULL ? name : sha1Kernel.name;
 }
 
 /**
@@ -374,5 +827,21 @@ int hash_sha1_destroy( void *h ) {
     return rc;
 }
 
+/**
+ * Hashes a batch of independent messages with SHA-1. See {@link SHA1::batch}.
+ *
+ * @return a non-zero value on success of 0 if a pointer is <tt>NULL</tt>.
+ */
+int hash_sha1_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    int rc = 0;
+
+    if(  data != NULL && sizes != NULL && digests != NULL ) {
+        rc = 1;
+        SHA1::batch( data, sizes, count, digests );
+    }
+
+    return rc;
+}
+
 // EOF: sha1.cpp
 
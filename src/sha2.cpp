@@ -32,11 +32,19 @@
 // HEADER FILES
 //-----------------------------------------------------------------------------
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include "../include/libhash/defs.h"
 #include "../include/libhash/hashbase.h"
+#include "../include/libhash/cpu.h"
 #include "../include/libhash/sha2.h"
+#include "multibuffer.h"
+#include "kernels.h"
+
+#if defined( __x86_64__ )
+#    include <immintrin.h>
+#endif
 
 using namespace libhash;
 
@@ -59,7 +67,7 @@ using namespace libhash;
 #define Sha512sigma1( x )    ( ROTR( (x), 19, 64 ) ^ ROTR( (x), 61, 64 ) ^ ( (x) >> 6 ))
 
 // SHA2-256 constants
-const uint32_t KSha256[64] = {
+static constexpr uint32_t KSha256[64] = {
     0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
     0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
     0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
@@ -70,8 +78,18 @@ const uint32_t KSha256[64] = {
     0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
 };
 
+// SHA2-224 initial state
+static constexpr uint32_t Sha224Init[8] = {
+    0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+};
+
+// SHA2-256 initial state
+static constexpr uint32_t Sha256Init[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
 // SHA2-512 constants
-const uint64_t KSha512[80] = {
+static constexpr uint64_t KSha512[80] = {
     0x428a2f98d728ae22, 0x7137449123ef65cd, 0xb5c0fbcfec4d3b2f, 0xe9b5dba58189dbbc,
     0x3956c25bf348b538, 0x59f111f1b605d019, 0x923f82a4af194f9b, 0xab1c5ed5da6d8118,
     0xd807aa98a3030242, 0x12835b0145706fbe, 0x243185be4ee4b28c, 0x550c7dc3d5ffb4e2,
@@ -94,10 +112,104 @@ const uint64_t KSha512[80] = {
     0x4cc5d4becb3e42b6, 0x597f299cfc657e2a, 0x5fcb6fab3ad6faec, 0x6c44198c4a475817
 };
 
+// SHA2-384 initial state
+static constexpr uint64_t Sha384Init[8] = {
+    0xcbbb9d5dc1059ed8, 0x629a292a367cd507, 0x9159015a3070dd17, 0x152fecd8f70e5939,
+    0x67332667ffc00b31, 0x8eb44a8768581511, 0xdb0c2e0d64f98fa7, 0x47b5481dbefa4fa4
+};
+
+// SHA2-512 initial state
+static constexpr uint64_t Sha512Init[8] = {
+    0x6a09e667f3bcc908, 0xbb67ae8584caa73b, 0x3c6ef372fe94f82b, 0xa54ff53a5f1d36f1,
+    0x510e527fade682d1, 0x9b05688c2b3e6c1f, 0x1f83d9abfb41bd6b, 0x5be0cd19137e2179
+};
+
 //-----------------------------------------------------------------------------
 // STRUCTURES & TYPEDEFS
 //-----------------------------------------------------------------------------
 
+/**
+ * @internal
+ *
+ * @brief Multi-block SHA-256 transformation.
+ */
+struct SHA256Kernel {
+    /** Processes a number of 64 bytes blocks. */
+    void ( *transform )( uint32_t *state, const uint8_t *blocks, size_t count );
+
+    /** Name reported by getKernel(). */
+    const char  *name;
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Multi-block SHA-512 transformation.
+ */
+struct SHA512Kernel {
+    /** Processes a number of 128 bytes blocks. */
+    void ( *transform )( uint64_t *state, const uint8_t *blocks, size_t count );
+
+    /** Name reported by getKernel(). */
+    const char  *name;
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Functions and constants of SHA-2 for a word size.
+ */
+template<typename Word>
+struct Sha2Traits;
+
+/**
+ * @internal
+ *
+ * @brief Functions and constants of SHA-224 and SHA-256.
+ */
+template<>
+struct Sha2Traits<uint32_t> {
+    /** Number of rounds. */
+    static constexpr int Rounds = 64;
+
+    static inline uint32_t SIGMA0( uint32_t x ) { return Sha256SIGMA0( x ); }
+    static inline uint32_t SIGMA1( uint32_t x ) { return Sha256SIGMA1( x ); }
+    static inline uint32_t sigma0( uint32_t x ) { return Sha256sigma0( x ); }
+    static inline uint32_t sigma1( uint32_t x ) { return Sha256sigma1( x ); }
+
+    /** Round constant <tt>t</tt>. */
+    static inline uint32_t K( int t ) { return KSha256[ t ]; }
+
+    /** Reads a big-endian word. */
+    static inline uint32_t load( const uint8_t *p ) {
+        return (uint32_t) p[ 0 ] << 24 | (uint32_t) p[ 1 ] << 16 | (uint32_t) p[ 2 ] << 8 | p[ 3 ];
+    }
+} ;
+
+/**
+ * @internal
+ *
+ * @brief Functions and constants of SHA-384, SHA-512 and SHA-512/t.
+ */
+template<>
+struct Sha2Traits<uint64_t> {
+    /** Number of rounds. */
+    static constexpr int Rounds = 80;
+
+    static inline uint64_t SIGMA0( uint64_t x ) { return Sha512SIGMA0( x ); }
+    static inline uint64_t SIGMA1( uint64_t x ) { return Sha512SIGMA1( x ); }
+    static inline uint64_t sigma0( uint64_t x ) { return Sha512sigma0( x ); }
+    static inline uint64_t sigma1( uint64_t x ) { return Sha512sigma1( x ); }
+
+    /** Round constant <tt>t</tt>. */
+    static inline uint64_t K( int t ) { return KSha512[ t ]; }
+
+    /** Reads a big-endian word. */
+    static inline uint64_t load( const uint8_t *p ) {
+        return (uint64_t) Sha2Traits<uint32_t>::load( p ) << 32 | Sha2Traits<uint32_t>::load( p + 4 );
+    }
+} ;
+
 //-----------------------------------------------------------------------------
 // CLASSES
 //-----------------------------------------------------------------------------
@@ -110,50 +222,1328 @@ const uint64_t KSha512[80] = {
 // IMPLEMENTATION
 //-----------------------------------------------------------------------------
 
+//=== SHA-2 generic kernels ===================================================
+
+/**
+ * @internal
+ *
+ * Executes the SHA-2 transformation rounds in C.
+ *
+ * The rounds are unrolled and the message schedule is computed in place in a 16 words
+ * window as the rounds need it, so the working variables and the schedule stay in
+ * registers.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of blocks of 16 words.
+ */
+template<typename Word>
+static void sha2Generic( Word *state, const uint8_t *blocks, size_t count ) {
+    typedef Sha2Traits<Word> Traits;
+    Word W[16];
+    Word tmp1, tmp2;
+    Word a, b, c, d, e, f, g, h;  // Working variables
+    int t;
+
+    for( ; count > 0; count--, blocks += sizeof ( W ) ) {
+        // Initialize working variables
+        a = state[ 0 ];
+        b = state[ 1 ];
+        c = state[ 2 ];
+        d = state[ 3 ];
+        e = state[ 4 ];
+        f = state[ 5 ];
+        g = state[ 6 ];
+        h = state[ 7 ];
+
+        #pragma GCC unroll 80
+        for( t = 0; t < Traits::Rounds; t++ ) {
+            if( t < 16 ) {
+                W[ t ] = Traits::load( blocks + t * sizeof ( Word ) );
+            }
+            else {
+                W[ t & 15 ] += Traits::sigma1( W[ ( t - 2 ) & 15 ] ) + W[ ( t - 7 ) & 15 ] + Traits::sigma0( W[ ( t - 15 ) & 15 ] );
+            }
+
+            tmp1 = h + Traits::SIGMA1( e ) + CH( e, f, g ) + Traits::K( t ) + W[ t & 15 ];
+            tmp2 = Traits::SIGMA0( a ) + MAJ( a, b, c );
+            h = g;
+            g = f;
+            f = e;
+            e = d + tmp1;
+            d = c;
+            c = b;
+            b = a;
+            a = tmp1 + tmp2;
+        }
+
+        // Update the context current state
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+        state[ 4 ] += e;
+        state[ 5 ] += f;
+        state[ 6 ] += g;
+        state[ 7 ] += h;
+    }
+}
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Executes the SHA-2 rounds of a block whose message schedule, with the round constants
+ * added, was computed by the vector units. The rounds are unrolled so the working
+ * variables stay in registers; compiled for BMI2, the rotations are rorx.
+ *
+ * @param state     Digest state.
+ * @param wk        Message schedule plus constants, by groups of 4 words.
+ * @param stride    Distance between 2 groups of 4 words (4, or 8 if the schedules of 2
+ *                  blocks are interleaved).
+ */
+template<typename Word>
+__attribute__(( always_inline ))
+static inline void sha2ScheduledRounds( Word *state, const Word *wk, int stride ) {
+    typedef Sha2Traits<Word> Traits;
+    Word tmp1, tmp2;
+    Word a, b, c, d, e, f, g, h;  // Working variables
+    int t;
+
+    a = state[ 0 ];
+    b = state[ 1 ];
+    c = state[ 2 ];
+    d = state[ 3 ];
+    e = state[ 4 ];
+    f = state[ 5 ];
+    g = state[ 6 ];
+    h = state[ 7 ];
+
+    #pragma GCC unroll 80
+    for( t = 0; t < Traits::Rounds; t++ ) {
+        tmp1 = h + Traits::SIGMA1( e ) + CH( e, f, g ) + wk[ ( t / 4 ) * stride + ( t & 3 ) ];
+        tmp2 = Traits::SIGMA0( a ) + MAJ( a, b, c );
+        h = g;
+        g = f;
+        f = e;
+        e = d + tmp1;
+        d = c;
+        c = b;
+        b = a;
+        a = tmp1 + tmp2;
+    }
+
+    state[ 0 ] += a;
+    state[ 1 ] += b;
+    state[ 2 ] += c;
+    state[ 3 ] += d;
+    state[ 4 ] += e;
+    state[ 5 ] += f;
+    state[ 6 ] += g;
+    state[ 7 ] += h;
+}
+
+#endif  // __x86_64__
+
+//=== SHA-256 kernels =========================================================
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Rotates each 32-bits word right.
+ */
+__attribute__(( target( "ssse3" ), always_inline ))
+static inline __m128i sha256Ror( __m128i x, int bits ) {
+    return _mm_or_si128( _mm_srli_epi32( x, bits ), _mm_slli_epi32( x, 32 - bits ) );
+}
+
+/**
+ * @internal
+ *
+ * Computes the next 4 words of the message schedule from the previous 16 words.
+ *
+ * Only the first 2 new words depend on the previous words through sigma1; the last 2
+ * depend on the first 2. sigma1( 0 ) is 0, so each half is computed on a vector whose
+ * other half is zero and simply added.
+ *
+ * @param x0        Words t - 16 to t - 13.
+ * @param x1        Words t - 12 to t - 9.
+ * @param x2        Words t - 8 to t - 5.
+ * @param x3        Words t - 4 to t - 1.
+ *
+ * @return the words t to t + 3.
+ */
+__attribute__(( target( "ssse3" ), always_inline ))
+static inline __m128i sha256Schedule( __m128i x0, __m128i x1, __m128i x2, __m128i x3 ) {
+    __m128i w15 = _mm_alignr_epi8( x1, x0, 4 );
+    __m128i w7 = _mm_alignr_epi8( x3, x2, 4 );
+    __m128i w2, w;
+
+    w = _mm_add_epi32( _mm_add_epi32( x0, w7 ),
+                       _mm_xor_si128( _mm_xor_si128( sha256Ror( w15, 7 ), sha256Ror( w15, 18 ) ), _mm_srli_epi32( w15, 3 ) ) );
+
+    w2 = _mm_srli_si128( x3, 8 );
+    w = _mm_add_epi32( w, _mm_xor_si128( _mm_xor_si128( sha256Ror( w2, 17 ), sha256Ror( w2, 19 ) ), _mm_srli_epi32( w2, 10 ) ) );
+
+    w2 = _mm_slli_si128( w, 8 );
+    return _mm_add_epi32( w, _mm_xor_si128( _mm_xor_si128( sha256Ror( w2, 17 ), sha256Ror( w2, 19 ) ), _mm_srli_epi32( w2, 10 ) ) );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation of one block, with the message schedule computed 4
+ * words at a time in the vector units while the rounds run on the scalar units.
+ *
+ * @param state     Digest state.
+ * @param block     Message block, not necessarily aligned.
+ */
+__attribute__(( target( "ssse3" ), always_inline ))
+static inline void sha256VectorBlock( uint32_t *state, const uint8_t *block ) {
+    const __m128i swap = _mm_set_epi64x( 0x0c0d0e0f08090a0b, 0x0405060700010203 );
+    uint32_t wk[64] __attribute__(( aligned( 16 ) ));
+    __m128i x[4], w;
+    int i;
+
+    for( i = 0; i < 4; i++ ) {
+        x[ i ] = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( block + i * 16 ) ), swap );
+        _mm_store_si128( (__m128i *) &wk[ i * 4 ], _mm_add_epi32( x[ i ], _mm_loadu_si128( (const __m128i *) &KSha256[ i * 4 ] ) ) );
+    }
+
+    #pragma GCC unroll 12
+    for( i = 16; i < 64; i += 4 ) {
+        w = sha256Schedule( x[ 0 ], x[ 1 ], x[ 2 ], x[ 3 ] );
+        x[ 0 ] = x[ 1 ];
+        x[ 1 ] = x[ 2 ];
+        x[ 2 ] = x[ 3 ];
+        x[ 3 ] = w;
+        _mm_store_si128( (__m128i *) &wk[ i ], _mm_add_epi32( w, _mm_loadu_si128( (const __m128i *) &KSha256[ i ] ) ) );
+    }
+
+    sha2ScheduledRounds( state, wk, 4 );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds with an SSSE3 message schedule.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+__attribute__(( target( "ssse3" ) ))
+static void sha256Ssse3( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    for( ; count > 0; count--, blocks += 64 ) {
+        sha256VectorBlock( state, blocks );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds with an AVX message schedule. This is the
+ * SSSE3 kernel with the non-destructive 3 operands VEX encoding.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+__attribute__(( target( "avx" ) ))
+static void sha256Avx( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    for( ; count > 0; count--, blocks += 64 ) {
+        sha256VectorBlock( state, blocks );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds with AVX2 and BMI2.
+ *
+ * The message schedules of 2 blocks are computed at once, one per 128-bits lane, since the
+ * AVX2 alignr and byte shifts work within each lane. The rounds use the rorx rotations.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+__attribute__(( target( "avx2,bmi2" ) ))
+static void sha256Avx2( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    const __m256i swap = _mm256_set_epi64x( 0x0c0d0e0f08090a0b, 0x0405060700010203,
+                                            0x0c0d0e0f08090a0b, 0x0405060700010203 );
+    uint32_t wk[128] __attribute__(( aligned( 32 ) ));
+    __m256i x[4], w, w2, w7, w15;
+    int i;
+
+    for( ; count >= 2; count -= 2, blocks += 128 ) {
+        for( i = 0; i < 4; i++ ) {
+            x[ i ] = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( (const __m128i *) ( blocks + i * 16 ) ) ),
+                                              _mm_loadu_si128( (const __m128i *) ( blocks + 64 + i * 16 ) ), 1 );
+            x[ i ] = _mm256_shuffle_epi8( x[ i ], swap );
+            _mm256_store_si256( (__m256i *) &wk[ i * 8 ],
+                                _mm256_add_epi32( x[ i ], _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) &KSha256[ i * 4 ] ) ) ) );
+        }
+
+        // Same as sha256Schedule(), on both lanes
+        #pragma GCC unroll 12
+        for( i = 16; i < 64; i += 4 ) {
+            w15 = _mm256_alignr_epi8( x[ 1 ], x[ 0 ], 4 );
+            w7 = _mm256_alignr_epi8( x[ 3 ], x[ 2 ], 4 );
+            w = _mm256_add_epi32( _mm256_add_epi32( x[ 0 ], w7 ),
+                                  _mm256_xor_si256( _mm256_xor_si256( _mm256_or_si256( _mm256_srli_epi32( w15, 7 ), _mm256_slli_epi32( w15, 25 ) ),
+                                                                      _mm256_or_si256( _mm256_srli_epi32( w15, 18 ), _mm256_slli_epi32( w15, 14 ) ) ),
+                                                    _mm256_srli_epi32( w15, 3 ) ) );
+
+            w2 = _mm256_srli_si256( x[ 3 ], 8 );
+            w = _mm256_add_epi32( w, _mm256_xor_si256( _mm256_xor_si256( _mm256_or_si256( _mm256_srli_epi32( w2, 17 ), _mm256_slli_epi32( w2, 15 ) ),
+                                                                         _mm256_or_si256( _mm256_srli_epi32( w2, 19 ), _mm256_slli_epi32( w2, 13 ) ) ),
+                                                       _mm256_srli_epi32( w2, 10 ) ) );
+
+            w2 = _mm256_slli_si256( w, 8 );
+            w = _mm256_add_epi32( w, _mm256_xor_si256( _mm256_xor_si256( _mm256_or_si256( _mm256_srli_epi32( w2, 17 ), _mm256_slli_epi32( w2, 15 ) ),
+                                                                         _mm256_or_si256( _mm256_srli_epi32( w2, 19 ), _mm256_slli_epi32( w2, 13 ) ) ),
+                                                       _mm256_srli_epi32( w2, 10 ) ) );
+
+            x[ 0 ] = x[ 1 ];
+            x[ 1 ] = x[ 2 ];
+            x[ 2 ] = x[ 3 ];
+            x[ 3 ] = w;
+            _mm256_store_si256( (__m256i *) &wk[ i * 2 ],
+                                _mm256_add_epi32( w, _mm256_broadcastsi128_si256( _mm_loadu_si128( (const __m128i *) &KSha256[ i ] ) ) ) );
+        }
+
+        sha2ScheduledRounds( state, wk, 8 );
+        sha2ScheduledRounds( state, wk + 4, 8 );
+    }
+
+    if( count > 0 ) {
+        sha256VectorBlock( state, blocks );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes 4 SHA-256 rounds with the SHA extensions and updates the message schedule.
+ *
+ * The 16 message words of the rounds <tt>4 * i</tt> onward are kept in 4 registers used
+ * in turn. Once used, <tt>prev</tt> receives the first part of the schedule of the rounds
+ * <tt>4 * i + 12</tt> (sha256msg1) and <tt>next</tt> is completed for the rounds
+ * <tt>4 * i + 4</tt> (sha256msg2).
+ *
+ * @param i         Index of the group of 4 rounds (0 to 15).
+ * @param state0    Working variables A, B, E and F.
+ * @param state1    Working variables C, D, G and H.
+ * @param msg       Message words of the rounds.
+ * @param prev      Message words of the previous rounds.
+ * @param next      Message words of the next rounds.
+ */
+__attribute__(( target( "sha,sse4.1,ssse3" ), always_inline ))
+static inline void sha256ShaNIRounds( int i, __m128i &state0, __m128i &state1, __m128i msg, __m128i &prev, __m128i &next ) {
+    __m128i words = _mm_add_epi32( msg, _mm_loadu_si128( (const __m128i *) &KSha256[ 4 * i ] ) );
+
+    state1 = _mm_sha256rnds2_epu32( state1, state0, words );
+
+    if( i >= 3 && i <= 14 ) {
+        next = _mm_sha256msg2_epu32( _mm_add_epi32( next, _mm_alignr_epi8( msg, prev, 4 ) ), msg );
+    }
+
+    state0 = _mm_sha256rnds2_epu32( state0, state1, _mm_shuffle_epi32( words, 0x0e ) );
+
+    if( i >= 1 && i <= 12 ) {
+        prev = _mm_sha256msg1_epu32( prev, msg );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds with the SHA extensions (SHA-NI).
+ *
+ * The instructions work on the working variables arranged as ABEF and CDGH, so the state
+ * is rearranged once for all the blocks.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+__attribute__(( target( "sha,sse4.1,ssse3" ) ))
+static void sha256ShaNI( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    const __m128i swap = _mm_set_epi64x( 0x0c0d0e0f08090a0b, 0x0405060700010203 );
+    __m128i state0, state1, abef, cdgh, tmp;
+    __m128i m0, m1, m2, m3;
+
+    tmp = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i *) &state[ 0 ] ), 0xb1 );     // CDAB
+    state1 = _mm_shuffle_epi32( _mm_loadu_si128( (const __m128i *) &state[ 4 ] ), 0x1b );  // EFGH
+    state0 = _mm_alignr_epi8( tmp, state1, 8 );                                             // ABEF
+    state1 = _mm_blend_epi16( state1, tmp, 0xf0 );                                          // CDGH
+
+    for( ; count > 0; count--, blocks += 64 ) {
+        abef = state0;
+        cdgh = state1;
+
+        // Message words in big-endian order
+        m0 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 0 ) ), swap );
+        m1 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 16 ) ), swap );
+        m2 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 32 ) ), swap );
+        m3 = _mm_shuffle_epi8( _mm_loadu_si128( (const __m128i *) ( blocks + 48 ) ), swap );
+
+        sha256ShaNIRounds( 0, state0, state1, m0, m3, m1 );
+        sha256ShaNIRounds( 1, state0, state1, m1, m0, m2 );
+        sha256ShaNIRounds( 2, state0, state1, m2, m1, m3 );
+        sha256ShaNIRounds( 3, state0, state1, m3, m2, m0 );
+        sha256ShaNIRounds( 4, state0, state1, m0, m3, m1 );
+        sha256ShaNIRounds( 5, state0, state1, m1, m0, m2 );
+        sha256ShaNIRounds( 6, state0, state1, m2, m1, m3 );
+        sha256ShaNIRounds( 7, state0, state1, m3, m2, m0 );
+        sha256ShaNIRounds( 8, state0, state1, m0, m3, m1 );
+        sha256ShaNIRounds( 9, state0, state1, m1, m0, m2 );
+        sha256ShaNIRounds( 10, state0, state1, m2, m1, m3 );
+        sha256ShaNIRounds( 11, state0, state1, m3, m2, m0 );
+        sha256ShaNIRounds( 12, state0, state1, m0, m3, m1 );
+        sha256ShaNIRounds( 13, state0, state1, m1, m0, m2 );
+        sha256ShaNIRounds( 14, state0, state1, m2, m1, m3 );
+        sha256ShaNIRounds( 15, state0, state1, m3, m2, m0 );
+
+        state0 = _mm_add_epi32( state0, abef );
+        state1 = _mm_add_epi32( state1, cdgh );
+    }
+
+    tmp = _mm_shuffle_epi32( state0, 0x1b );                                                // FEBA
+    state1 = _mm_shuffle_epi32( state1, 0xb1 );                                             // DCHG
+    _mm_storeu_si128( (__m128i *) &state[ 0 ], _mm_blend_epi16( tmp, state1, 0xf0 ) );      // DCBA
+    _mm_storeu_si128( (__m128i *) &state[ 4 ], _mm_alignr_epi8( state1, tmp, 8 ) );         // HGFE
+}
+
+/**
+ * @internal
+ *
+ * Rotates each 32-bits lane right.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i sha256Avx2Ror( __m256i x, int bits ) {
+    return _mm256_or_si256( _mm256_srli_epi32( x, bits ), _mm256_slli_epi32( x, 32 - bits ) );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds on 8 messages with AVX2, one message per
+ * 32-bits lane.
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx2" ) ))
+static void sha256Avx2x8( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[8];
+    __m256i W[16];
+    __m256i v[8];
+    __m256i a, b, c, d, e, f, g, h, tmp1, tmp2;
+    int t;
+
+    for( t = 0; t < 8; t++ ) {
+        lanes[ t ] = blocks[ t ];
+        v[ t ] = _mm256_loadu_si256( (const __m256i *) &state[ t * 8 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad8( W, lanes, 0, true );
+        multiBufferLoad8( W + 8, lanes, 32, true );
+
+        for( t = 0; t < 8; t++ ) {
+            lanes[ t ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+        f = v[ 5 ];
+        g = v[ 6 ];
+        h = v[ 7 ];
+
+        // Rounds 0 to 63, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 64
+        for( t = 0; t < 64; t++ ) {
+            if( t >= 16 ) {
+                __m256i w2 = W[ ( t - 2 ) & 15 ];
+                __m256i w15 = W[ ( t - 15 ) & 15 ];
+                __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( sha256Avx2Ror( w15, 7 ), sha256Avx2Ror( w15, 18 ) ), _mm256_srli_epi32( w15, 3 ) );
+                __m256i s1 = _mm256_xor_si256( _mm256_xor_si256( sha256Avx2Ror( w2, 17 ), sha256Avx2Ror( w2, 19 ) ), _mm256_srli_epi32( w2, 10 ) );
+
+                W[ t & 15 ] = _mm256_add_epi32( _mm256_add_epi32( W[ t & 15 ], s0 ), _mm256_add_epi32( W[ ( t - 7 ) & 15 ], s1 ) );
+            }
+
+            tmp1 = _mm256_add_epi32( h, _mm256_xor_si256( _mm256_xor_si256( sha256Avx2Ror( e, 6 ), sha256Avx2Ror( e, 11 ) ), sha256Avx2Ror( e, 25 ) ) );
+            tmp1 = _mm256_add_epi32( tmp1, _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) ) );
+            tmp1 = _mm256_add_epi32( tmp1, _mm256_add_epi32( W[ t & 15 ], _mm256_set1_epi32( KSha256[ t ] ) ) );
+            tmp2 = _mm256_xor_si256( _mm256_xor_si256( sha256Avx2Ror( a, 2 ), sha256Avx2Ror( a, 13 ) ), sha256Avx2Ror( a, 22 ) );
+            tmp2 = _mm256_add_epi32( tmp2, _mm256_xor_si256( _mm256_and_si256( a, b ), _mm256_and_si256( _mm256_xor_si256( a, b ), c ) ) );
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi32( d, tmp1 );
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi32( tmp1, tmp2 );
+        }
+
+        v[ 0 ] = _mm256_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm256_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm256_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm256_add_epi32( v[ 3 ], d );
+        v[ 4 ] = _mm256_add_epi32( v[ 4 ], e );
+        v[ 5 ] = _mm256_add_epi32( v[ 5 ], f );
+        v[ 6 ] = _mm256_add_epi32( v[ 6 ], g );
+        v[ 7 ] = _mm256_add_epi32( v[ 7 ], h );
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        _mm256_storeu_si256( (__m256i *) &state[ t * 8 ], v[ t ] );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds on 16 messages with AVX-512, one message per
+ * 32-bits lane. The rotations and the 3 inputs functions are single instructions
+ * (vprord and vpternlogd).
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx512f,avx512bw" ) ))
+static void sha256Avx512x16( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[16];
+    __m512i W[16];
+    __m512i v[8];
+    __m512i a, b, c, d, e, f, g, h, tmp1, tmp2;
+    int t;
+
+    for( t = 0; t < 16; t++ ) {
+        lanes[ t ] = blocks[ t ];
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        v[ t ] = _mm512_loadu_si512( (const void *) &state[ t * 16 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        multiBufferLoad16( W, lanes, true );
+
+        for( t = 0; t < 16; t++ ) {
+            lanes[ t ] += 64;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+        f = v[ 5 ];
+        g = v[ 6 ];
+        h = v[ 7 ];
+
+        // Rounds 0 to 63, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 64
+        for( t = 0; t < 64; t++ ) {
+            if( t >= 16 ) {
+                __m512i w2 = W[ ( t - 2 ) & 15 ];
+                __m512i w15 = W[ ( t - 15 ) & 15 ];
+                __m512i s0 = _mm512_ternarylogic_epi32( _mm512_ror_epi32( w15, 7 ), _mm512_ror_epi32( w15, 18 ), _mm512_srli_epi32( w15, 3 ), 0x96 );
+                __m512i s1 = _mm512_ternarylogic_epi32( _mm512_ror_epi32( w2, 17 ), _mm512_ror_epi32( w2, 19 ), _mm512_srli_epi32( w2, 10 ), 0x96 );
+
+                W[ t & 15 ] = _mm512_add_epi32( _mm512_add_epi32( W[ t & 15 ], s0 ), _mm512_add_epi32( W[ ( t - 7 ) & 15 ], s1 ) );
+            }
+
+            // 0x96 is x ^ y ^ z, 0xca is CH( x, y, z ) and 0xe8 is MAJ( x, y, z )
+            tmp1 = _mm512_add_epi32( h, _mm512_ternarylogic_epi32( _mm512_ror_epi32( e, 6 ), _mm512_ror_epi32( e, 11 ), _mm512_ror_epi32( e, 25 ), 0x96 ) );
+            tmp1 = _mm512_add_epi32( tmp1, _mm512_ternarylogic_epi32( e, f, g, 0xca ) );
+            tmp1 = _mm512_add_epi32( tmp1, _mm512_add_epi32( W[ t & 15 ], _mm512_set1_epi32( KSha256[ t ] ) ) );
+            tmp2 = _mm512_ternarylogic_epi32( _mm512_ror_epi32( a, 2 ), _mm512_ror_epi32( a, 13 ), _mm512_ror_epi32( a, 22 ), 0x96 );
+            tmp2 = _mm512_add_epi32( tmp2, _mm512_ternarylogic_epi32( a, b, c, 0xe8 ) );
+            h = g;
+            g = f;
+            f = e;
+            e = _mm512_add_epi32( d, tmp1 );
+            d = c;
+            c = b;
+            b = a;
+            a = _mm512_add_epi32( tmp1, tmp2 );
+        }
+
+        v[ 0 ] = _mm512_add_epi32( v[ 0 ], a );
+        v[ 1 ] = _mm512_add_epi32( v[ 1 ], b );
+        v[ 2 ] = _mm512_add_epi32( v[ 2 ], c );
+        v[ 3 ] = _mm512_add_epi32( v[ 3 ], d );
+        v[ 4 ] = _mm512_add_epi32( v[ 4 ], e );
+        v[ 5 ] = _mm512_add_epi32( v[ 5 ], f );
+        v[ 6 ] = _mm512_add_epi32( v[ 6 ], g );
+        v[ 7 ] = _mm512_add_epi32( v[ 7 ], h );
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        _mm512_storeu_si512( (void *) &state[ t * 16 ], v[ t ] );
+    }
+}
+
+#endif  // __x86_64__
+
+/**
+ * SHA-256 kernel. It is statically initialized to the C transformation, which is used
+ * until the kernels are bound when the library is loaded.
+ */
+static SHA256Kernel sha256Kernel = { sha2Generic<uint32_t>, "generic" };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-256 kernel supported by the CPU (see CPU::getFeatures()).
+ */
+static bool sha256Bind( ) {
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) ) {
+        sha256Kernel.transform = sha256ShaNI;
+        sha256Kernel.name = "sha-ni";
+    }
+    else if( CPU::has( HASH_CPU_AVX2 | HASH_CPU_BMI2 ) ) {
+        sha256Kernel.transform = sha256Avx2;
+        sha256Kernel.name = "avx2";
+    }
+    else if( CPU::has( HASH_CPU_AVX ) ) {
+        sha256Kernel.transform = sha256Avx;
+        sha256Kernel.name = "avx";
+    }
+    else if( CPU::has( HASH_CPU_SSSE3 ) ) {
+        sha256Kernel.transform = sha256Ssse3;
+        sha256Kernel.name = "ssse3";
+    }
+#endif
+
+    return true;
+}
+
+/** SHA-256 as hashed by the multi-buffer kernels. */
+static const MultiBufferAlgorithm sha256Algorithm = { Sha256Init, 8, 32, true, 4, 64 };
+
+/**
+ * @internal
+ *
+ * Hashes the messages of a batch one after the other with the SHA-256 kernel.
+ */
+static void sha256Sequential( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    SHA2_256 sha;
+    size_t i;
+
+    for( i = 0; i < count; i++ ) {
+        sha.init( );
+        sha.update( data[ i ], sizes[ i ] );
+        sha.finalize( );
+        sha.getValue( digests + i * 32, 32 );
+    }
+}
+
+/**
+ * SHA-256 multi-buffer kernels. The fallback hashes the messages of a batch one after
+ * the other with the SHA-256 kernel.
+ */
+static MultiBufferKernels sha256Batch = { "sha256-batch", &sha256Algorithm, sha256Sequential, 0 };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-256 multi-buffer kernels supported by the CPU. Until calibrated, the 16
+ * AVX-512 lanes are used since they beat a SHA-NI stream, but a single SHA-NI stream is
+ * faster than the 8 AVX2 lanes, so they are only used without the SHA extensions.
+ */
+static bool sha256BatchBind( ) {
+    multiBufferAdd( sha256Batch, NULL, 1, NULL, true );
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_AVX2 ) ) {
+        multiBufferAdd( sha256Batch, sha256Avx2x8, 8, "avx2-8x", !CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) );
+    }
+    if( CPU::has( MULTIBUFFER_AVX512 ) ) {
+        multiBufferAdd( sha256Batch, sha256Avx512x16, 16, "avx512-16x", true );
+    }
+#endif
+
+    return true;
+}
+
+/** Binds the kernels when the library is loaded. */
+static const bool sha256Bound = sha256Bind( ) && sha256BatchBind( );
+
+//=== SHA-512 kernels =========================================================
+
+#if defined( __x86_64__ )
+
+/**
+ * @internal
+ *
+ * Rotates each 64-bits lane right.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i sha512Avx2Ror( __m256i x, int bits ) {
+    return _mm256_or_si256( _mm256_srli_epi64( x, bits ), _mm256_slli_epi64( x, 64 - bits ) );
+}
+
+/**
+ * @internal
+ *
+ * Computes the SHA-512 sigma1 function of each 64-bits lane.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i sha512Avx2Sigma1( __m256i x ) {
+    return _mm256_xor_si256( _mm256_xor_si256( sha512Avx2Ror( x, 19 ), sha512Avx2Ror( x, 61 ) ), _mm256_srli_epi64( x, 6 ) );
+}
+
+/**
+ * @internal
+ *
+ * Computes the next 4 words of the SHA-512 message schedule from the previous 16 words.
+ * As for SHA-256 (see sha256Schedule()), the last 2 words depend on the first 2 through
+ * sigma1, so sigma1 is applied twice on a vector whose other half is zero.
+ *
+ * @param x0        Words t - 16 to t - 13.
+ * @param x1        Words t - 12 to t - 9.
+ * @param x2        Words t - 8 to t - 5.
+ * @param x3        Words t - 4 to t - 1.
+ *
+ * @return the words t to t + 3.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline __m256i sha512Avx2Schedule( __m256i x0, __m256i x1, __m256i x2, __m256i x3 ) {
+    __m256i w15 = _mm256_permute4x64_epi64( _mm256_blend_epi32( x0, x1, 0x03 ), 0x39 );
+    __m256i w7 = _mm256_permute4x64_epi64( _mm256_blend_epi32( x2, x3, 0x03 ), 0x39 );
+    __m256i w;
+
+    w = _mm256_add_epi64( _mm256_add_epi64( x0, w7 ),
+                          _mm256_xor_si256( _mm256_xor_si256( sha512Avx2Ror( w15, 1 ), sha512Avx2Ror( w15, 8 ) ), _mm256_srli_epi64( w15, 7 ) ) );
+    w = _mm256_add_epi64( w, sha512Avx2Sigma1( _mm256_permute2x128_si256( x3, x3, 0x81 ) ) );
+    return _mm256_add_epi64( w, sha512Avx2Sigma1( _mm256_permute2x128_si256( w, w, 0x08 ) ) );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-512 transformation rounds with AVX2 and BMI2. The message schedule is
+ * computed 4 words at a time in the vector units while the unrolled rounds run on the
+ * scalar units with the rorx rotations.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 128 bytes blocks.
+ */
+__attribute__(( target( "avx2,bmi2" ) ))
+static void sha512Avx2( uint64_t *state, const uint8_t *blocks, size_t count ) {
+    const __m256i swap = _mm256_set_epi64x( 0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                            0x08090a0b0c0d0e0f, 0x0001020304050607 );
+    uint64_t wk[80] __attribute__(( aligned( 32 ) ));
+    __m256i x[4], w;
+    int t;
+
+    for( ; count > 0; count--, blocks += 128 ) {
+        for( t = 0; t < 4; t++ ) {
+            x[ t ] = _mm256_shuffle_epi8( _mm256_loadu_si256( (const __m256i *) ( blocks + t * 32 ) ), swap );
+            _mm256_store_si256( (__m256i *) &wk[ t * 4 ], _mm256_add_epi64( x[ t ], _mm256_loadu_si256( (const __m256i *) &KSha512[ t * 4 ] ) ) );
+        }
+
+        #pragma GCC unroll 16
+        for( t = 16; t < 80; t += 4 ) {
+            w = sha512Avx2Schedule( x[ 0 ], x[ 1 ], x[ 2 ], x[ 3 ] );
+            x[ 0 ] = x[ 1 ];
+            x[ 1 ] = x[ 2 ];
+            x[ 2 ] = x[ 3 ];
+            x[ 3 ] = w;
+            _mm256_store_si256( (__m256i *) &wk[ t ], _mm256_add_epi64( w, _mm256_loadu_si256( (const __m256i *) &KSha512[ t ] ) ) );
+        }
+
+        sha2ScheduledRounds( state, wk, 4 );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Loads 32 bytes of each of 4 lanes and transposes them, so <tt>words[ i ]</tt> holds the
+ * big-endian 64-bits word <tt>i</tt> of all the lanes.
+ *
+ * @param words     Message words.
+ * @param blocks    Blocks of the lanes.
+ * @param offset    Offset of the words in the blocks.
+ */
+__attribute__(( target( "avx2" ), always_inline ))
+static inline void sha512Load4( __m256i *words, const uint8_t *const *blocks, size_t offset ) {
+    const __m256i swap = _mm256_set_epi64x( 0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                            0x08090a0b0c0d0e0f, 0x0001020304050607 );
+    __m256i r[4], t[4];
+    int i;
+
+    for( i = 0; i < 4; i++ ) {
+        r[ i ] = _mm256_shuffle_epi8( _mm256_loadu_si256( (const __m256i *) ( blocks[ i ] + offset ) ), swap );
+    }
+
+    t[ 0 ] = _mm256_unpacklo_epi64( r[ 0 ], r[ 1 ] );
+    t[ 1 ] = _mm256_unpackhi_epi64( r[ 0 ], r[ 1 ] );
+    t[ 2 ] = _mm256_unpacklo_epi64( r[ 2 ], r[ 3 ] );
+    t[ 3 ] = _mm256_unpackhi_epi64( r[ 2 ], r[ 3 ] );
+
+    words[ 0 ] = _mm256_permute2x128_si256( t[ 0 ], t[ 2 ], 0x20 );
+    words[ 1 ] = _mm256_permute2x128_si256( t[ 1 ], t[ 3 ], 0x20 );
+    words[ 2 ] = _mm256_permute2x128_si256( t[ 0 ], t[ 2 ], 0x31 );
+    words[ 3 ] = _mm256_permute2x128_si256( t[ 1 ], t[ 3 ], 0x31 );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-512 transformation rounds on 4 messages with AVX2, one message per
+ * 64-bits lane.
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 128 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx2" ) ))
+static void sha512Avx2x4( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[4];
+    __m256i W[16];
+    __m256i v[8];
+    __m256i a, b, c, d, e, f, g, h, tmp1, tmp2;
+    int t;
+
+    for( t = 0; t < 4; t++ ) {
+        lanes[ t ] = blocks[ t ];
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        v[ t ] = _mm256_loadu_si256( (const __m256i *) &state[ t * 8 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        for( t = 0; t < 4; t++ ) {
+            sha512Load4( W + t * 4, lanes, t * 32 );
+        }
+
+        for( t = 0; t < 4; t++ ) {
+            lanes[ t ] += 128;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+        f = v[ 5 ];
+        g = v[ 6 ];
+        h = v[ 7 ];
+
+        // Rounds 0 to 79, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 80
+        for( t = 0; t < 80; t++ ) {
+            if( t >= 16 ) {
+                __m256i w2 = W[ ( t - 2 ) & 15 ];
+                __m256i w15 = W[ ( t - 15 ) & 15 ];
+                __m256i s0 = _mm256_xor_si256( _mm256_xor_si256( sha512Avx2Ror( w15, 1 ), sha512Avx2Ror( w15, 8 ) ), _mm256_srli_epi64( w15, 7 ) );
+
+                W[ t & 15 ] = _mm256_add_epi64( _mm256_add_epi64( W[ t & 15 ], s0 ), _mm256_add_epi64( W[ ( t - 7 ) & 15 ], sha512Avx2Sigma1( w2 ) ) );
+            }
+
+            tmp1 = _mm256_add_epi64( h, _mm256_xor_si256( _mm256_xor_si256( sha512Avx2Ror( e, 14 ), sha512Avx2Ror( e, 18 ) ), sha512Avx2Ror( e, 41 ) ) );
+            tmp1 = _mm256_add_epi64( tmp1, _mm256_xor_si256( _mm256_and_si256( e, f ), _mm256_andnot_si256( e, g ) ) );
+            tmp1 = _mm256_add_epi64( tmp1, _mm256_add_epi64( W[ t & 15 ], _mm256_set1_epi64x( KSha512[ t ] ) ) );
+            tmp2 = _mm256_xor_si256( _mm256_xor_si256( sha512Avx2Ror( a, 28 ), sha512Avx2Ror( a, 34 ) ), sha512Avx2Ror( a, 39 ) );
+            tmp2 = _mm256_add_epi64( tmp2, _mm256_xor_si256( _mm256_and_si256( a, b ), _mm256_and_si256( _mm256_xor_si256( a, b ), c ) ) );
+            h = g;
+            g = f;
+            f = e;
+            e = _mm256_add_epi64( d, tmp1 );
+            d = c;
+            c = b;
+            b = a;
+            a = _mm256_add_epi64( tmp1, tmp2 );
+        }
+
+        v[ 0 ] = _mm256_add_epi64( v[ 0 ], a );
+        v[ 1 ] = _mm256_add_epi64( v[ 1 ], b );
+        v[ 2 ] = _mm256_add_epi64( v[ 2 ], c );
+        v[ 3 ] = _mm256_add_epi64( v[ 3 ], d );
+        v[ 4 ] = _mm256_add_epi64( v[ 4 ], e );
+        v[ 5 ] = _mm256_add_epi64( v[ 5 ], f );
+        v[ 6 ] = _mm256_add_epi64( v[ 6 ], g );
+        v[ 7 ] = _mm256_add_epi64( v[ 7 ], h );
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        _mm256_storeu_si256( (__m256i *) &state[ t * 8 ], v[ t ] );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Loads 64 bytes of each of 8 lanes and transposes them, so <tt>words[ i ]</tt> holds the
+ * big-endian 64-bits word <tt>i</tt> of all the lanes.
+ *
+ * The 64-bits unpacks transpose the 2x2 words of each 128-bits chunk; the chunks are then
+ * transposed with 2 rounds of shuffles, as in multiBufferLoad16().
+ *
+ * @param words     Message words.
+ * @param blocks    Blocks of the lanes.
+ * @param offset    Offset of the words in the blocks (0 or 64).
+ */
+__attribute__(( target( "avx512f,avx512bw" ), always_inline ))
+static inline void sha512Load8( __m512i *words, const uint8_t *const *blocks, size_t offset ) {
+    const __m512i swap = _mm512_set_epi64( 0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                           0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                           0x08090a0b0c0d0e0f, 0x0001020304050607,
+                                           0x08090a0b0c0d0e0f, 0x0001020304050607 );
+    __m512i r[8], t[8];
+    __m512i lo0, hi0, lo1, hi1;
+    int i;
+
+    for( i = 0; i < 8; i++ ) {
+        r[ i ] = _mm512_shuffle_epi8( _mm512_loadu_si512( (const void *) ( blocks[ i ] + offset ) ), swap );
+    }
+
+    // t[ 2 * g + k ] holds the words 2 * c + k of the lanes 2 * g and 2 * g + 1 in chunk c
+    for( i = 0; i < 8; i += 2 ) {
+        t[ i ] = _mm512_unpacklo_epi64( r[ i ], r[ i + 1 ] );
+        t[ i + 1 ] = _mm512_unpackhi_epi64( r[ i ], r[ i + 1 ] );
+    }
+
+    for( i = 0; i < 2; i++ ) {
+        lo0 = _mm512_shuffle_i64x2( t[ i ], t[ i + 2 ], 0x44 );
+        hi0 = _mm512_shuffle_i64x2( t[ i ], t[ i + 2 ], 0xee );
+        lo1 = _mm512_shuffle_i64x2( t[ i + 4 ], t[ i + 6 ], 0x44 );
+        hi1 = _mm512_shuffle_i64x2( t[ i + 4 ], t[ i + 6 ], 0xee );
+
+        words[ i ] = _mm512_shuffle_i64x2( lo0, lo1, 0x88 );
+        words[ i + 2 ] = _mm512_shuffle_i64x2( lo0, lo1, 0xdd );
+        words[ i + 4 ] = _mm512_shuffle_i64x2( hi0, hi1, 0x88 );
+        words[ i + 6 ] = _mm512_shuffle_i64x2( hi0, hi1, 0xdd );
+    }
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-512 transformation rounds on 8 messages with AVX-512, one message per
+ * 64-bits lane, with the vprorq rotations and the vpternlogq 3 inputs functions.
+ *
+ * @param state     Transposed digest states (see MultiBufferTransform).
+ * @param blocks    Message blocks of each lane, not necessarily aligned.
+ * @param count     Number of 128 bytes blocks to process on each lane.
+ */
+__attribute__(( target( "avx512f,avx512bw" ) ))
+static void sha512Avx512x8( uint32_t *state, const uint8_t *const *blocks, size_t count ) {
+    const uint8_t *lanes[8];
+    __m512i W[16];
+    __m512i v[8];
+    __m512i a, b, c, d, e, f, g, h, tmp1, tmp2;
+    int t;
+
+    for( t = 0; t < 8; t++ ) {
+        lanes[ t ] = blocks[ t ];
+        v[ t ] = _mm512_loadu_si512( (const void *) &state[ t * 16 ] );
+    }
+
+    for( ; count > 0; count-- ) {
+        sha512Load8( W, lanes, 0 );
+        sha512Load8( W + 8, lanes, 64 );
+
+        for( t = 0; t < 8; t++ ) {
+            lanes[ t ] += 128;
+        }
+
+        a = v[ 0 ];
+        b = v[ 1 ];
+        c = v[ 2 ];
+        d = v[ 3 ];
+        e = v[ 4 ];
+        f = v[ 5 ];
+        g = v[ 6 ];
+        h = v[ 7 ];
+
+        // Rounds 0 to 79, the schedule is computed in place in a 16 words window
+        #pragma GCC unroll 80
+        for( t = 0; t < 80; t++ ) {
+            if( t >= 16 ) {
+                __m512i w2 = W[ ( t - 2 ) & 15 ];
+                __m512i w15 = W[ ( t - 15 ) & 15 ];
+                __m512i s0 = _mm512_ternarylogic_epi64( _mm512_ror_epi64( w15, 1 ), _mm512_ror_epi64( w15, 8 ), _mm512_srli_epi64( w15, 7 ), 0x96 );
+                __m512i s1 = _mm512_ternarylogic_epi64( _mm512_ror_epi64( w2, 19 ), _mm512_ror_epi64( w2, 61 ), _mm512_srli_epi64( w2, 6 ), 0x96 );
+
+                W[ t & 15 ] = _mm512_add_epi64( _mm512_add_epi64( W[ t & 15 ], s0 ), _mm512_add_epi64( W[ ( t - 7 ) & 15 ], s1 ) );
+            }
+
+            // 0x96 is x ^ y ^ z, 0xca is CH( x, y, z ) and 0xe8 is MAJ( x, y, z )
+            tmp1 = _mm512_add_epi64( h, _mm512_ternarylogic_epi64( _mm512_ror_epi64( e, 14 ), _mm512_ror_epi64( e, 18 ), _mm512_ror_epi64( e, 41 ), 0x96 ) );
+            tmp1 = _mm512_add_epi64( tmp1, _mm512_ternarylogic_epi64( e, f, g, 0xca ) );
+            tmp1 = _mm512_add_epi64( tmp1, _mm512_add_epi64( W[ t & 15 ], _mm512_set1_epi64( KSha512[ t ] ) ) );
+            tmp2 = _mm512_ternarylogic_epi64( _mm512_ror_epi64( a, 28 ), _mm512_ror_epi64( a, 34 ), _mm512_ror_epi64( a, 39 ), 0x96 );
+            tmp2 = _mm512_add_epi64( tmp2, _mm512_ternarylogic_epi64( a, b, c, 0xe8 ) );
+            h = g;
+            g = f;
+            f = e;
+            e = _mm512_add_epi64( d, tmp1 );
+            d = c;
+            c = b;
+            b = a;
+            a = _mm512_add_epi64( tmp1, tmp2 );
+        }
+
+        v[ 0 ] = _mm512_add_epi64( v[ 0 ], a );
+        v[ 1 ] = _mm512_add_epi64( v[ 1 ], b );
+        v[ 2 ] = _mm512_add_epi64( v[ 2 ], c );
+        v[ 3 ] = _mm512_add_epi64( v[ 3 ], d );
+        v[ 4 ] = _mm512_add_epi64( v[ 4 ], e );
+        v[ 5 ] = _mm512_add_epi64( v[ 5 ], f );
+        v[ 6 ] = _mm512_add_epi64( v[ 6 ], g );
+        v[ 7 ] = _mm512_add_epi64( v[ 7 ], h );
+    }
+
+    for( t = 0; t < 8; t++ ) {
+        _mm512_storeu_si512( (void *) &state[ t * 16 ], v[ t ] );
+    }
+}
+
+#endif  // __x86_64__
+
+/**
+ * SHA-512 kernel, shared by SHA-384. It is statically initialized to the C transformation,
+ * which is used until the kernels are bound when the library is loaded.
+ */
+static SHA512Kernel sha512Kernel = { sha2Generic<uint64_t>, "generic" };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-512 kernel supported by the CPU (see CPU::getFeatures()).
+ */
+static bool sha512Bind( ) {
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_AVX2 | HASH_CPU_BMI2 ) ) {
+        sha512Kernel.transform = sha512Avx2;
+        sha512Kernel.name = "avx2";
+    }
+#endif
+
+    return true;
+}
+
+/** SHA-512 as hashed by the multi-buffer kernels. */
+static const MultiBufferAlgorithm sha512Algorithm = { Sha512Init, 8, 64, true, 8, 128 };
+
+/**
+ * @internal
+ *
+ * Hashes the messages of a batch one after the other with the SHA-512 kernel.
+ */
+static void sha512Sequential( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    SHA2_512 sha;
+    size_t i;
+
+    for( i = 0; i < count; i++ ) {
+        sha.init( );
+        sha.update( data[ i ], sizes[ i ] );
+        sha.finalize( );
+        sha.getValue( digests + i * 64, 64 );
+    }
+}
+
+/**
+ * SHA-512 multi-buffer kernels. The fallback hashes the messages of a batch one after
+ * the other with the SHA-512 kernel.
+ */
+static MultiBufferKernels sha512Batch = { "sha512-batch", &sha512Algorithm, sha512Sequential, 0 };
+
+/**
+ * @internal
+ *
+ * Selects the SHA-512 multi-buffer kernels supported by the CPU: 8 lanes with AVX-512 or 4
+ * lanes with AVX2. The widest one is used until calibrated.
+ */
+static bool sha512BatchBind( ) {
+    multiBufferAdd( sha512Batch, NULL, 1, NULL, true );
+#if defined( __x86_64__ )
+    if( CPU::has( HASH_CPU_AVX2 ) ) {
+        multiBufferAdd( sha512Batch, sha512Avx2x4, 4, "avx2-4x", true );
+    }
+    if( CPU::has( MULTIBUFFER_AVX512 ) ) {
+        multiBufferAdd( sha512Batch, sha512Avx512x8, 8, "avx512-8x", true );
+    }
+#endif
+
+    return true;
+}
+
+/** Binds the kernels when the library is loaded. */
+static const bool sha512Bound = sha512Bind( ) && sha512BatchBind( );
+
+/**
+ * @internal
+ *
+ * Binds the SHA-256 and SHA-512 kernels again after cpuBind() changed the CPU features,
+ * starting over from the C transformations.
+ */
+void libhash::sha2Rebind( ) {
+    sha256Kernel.transform = sha2Generic<uint32_t>;
+    sha256Kernel.name = "generic";
+    sha256Batch.count = 0;
+    sha256Bind( );
+    sha256BatchBind( );
+
+    sha512Kernel.transform = sha2Generic<uint64_t>;
+    sha512Kernel.name = "generic";
+    sha512Batch.count = 0;
+    sha512Bind( );
+    sha512BatchBind( );
+}
+
+/**
+ * @internal
+ *
+ * Generates the initial state of SHA-512/t as defined in FIPS 180-4, section 5.3.6: the
+ * SHA-512 hash of the string <tt>"SHA-512/t"</tt>, computed from the SHA-512 initial
+ * state with each word xored with <tt>0xa5a5a5a5a5a5a5a5</tt>.
+ *
+ * @param iv        Buffer receiving the 8 words of the initial state.
+ * @param bits      Number of bits in the digest (<tt>t</tt>), lower than 512 and not 384.
+ *
+ * @return <tt>iv</tt>.
+ */
+static const uint64_t *sha512TGenerate( uint64_t *iv, unsigned bits ) {
+    uint8_t block[128];
+    int size;
+    int i;
+
+    // The name fits in a single block with the padding and the message length
+    ::memset( block, 0, sizeof ( block ) );
+    size = ::snprintf( (char *) block, 16, "SHA-512/%u", bits );
+    block[ size ] = 0x80;
+    block[ 126 ] = (uint8_t) ( ( size << 3 ) >> 8 );
+    block[ 127 ] = (uint8_t) ( size << 3 );
+
+    for( i = 0; i < 8; i++ ) {
+        iv[ i ] = Sha512Init[ i ] ^ 0xa5a5a5a5a5a5a5a5L;
+    }
+
+    sha512Kernel.transform( iv, block, 1 );
+    return iv;
+}
+
+//=== SHA-2 core implementation ===============================================
+
+/**
+ * @internal
+ *
+ * Executes the SHA-256 transformation rounds with the fastest kernel supported by the CPU.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 64 bytes blocks.
+ */
+static inline void sha2Transform( uint32_t *state, const uint8_t *blocks, size_t count ) {
+    sha256Kernel.transform( state, blocks, count );
+}
+
+/**
+ * @internal
+ *
+ * Executes the SHA-512 transformation rounds with the fastest kernel supported by the CPU.
+ *
+ * @param state     Digest state.
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of 128 bytes blocks.
+ */
+static inline void sha2Transform( uint64_t *state, const uint8_t *blocks, size_t count ) {
+    sha512Kernel.transform( state, blocks, count );
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the name of the SHA-256 kernel.
+ */
+static inline const char *sha2KernelName( const uint32_t * ) {
+    return sha256Kernel.name;
+}
+
+/**
+ * @internal
+ *
+ * Retrieves the name of the SHA-512 kernel.
+ */
+static inline const char *sha2KernelName( const uint64_t * ) {
+    return sha512Kernel.name;
+}
+
+/**
+ * Transformation rounds, with the fastest kernel supported by the CPU.
+ *
+ * @param blocks    Message blocks, not necessarily aligned.
+ * @param count     Number of blocks.
+ */
+template<typename Word>
+void Sha2Core<Word>::transform( const uint8_t *blocks, size_t count ) {
+    sha2Transform( mState, blocks, count );
+}
+
+/**
+ * @copydoc HashingBase::getKernel()
+ */
+template<typename Word>
+const char *Sha2Core<Word>::getKernel( ) {
+    return sha2KernelName( mState );
+}
+
+/**
+ * Starts a new message.
+ *
+ * @param initial   Initial state of the algorithm.
+ */
+template<typename Word>
+void Sha2Core<Word>::start( const Word *initial ) {
+    ::memcpy( mState, initial, sizeof ( mState ) );
+    mBitCount[ 0 ] = 0;
+    mBitCount[ 1 ] = 0;
+    mIndex = 0;
+}
+
+/**
+ * @copydoc HashingBase::update( const void *, size_t )
+ */
+template<typename Word>
+void Sha2Core<Word>::update( const void *data, size_t size ) {
+    const uint8_t *buffer = (const uint8_t *) data;
+    const size_t block = sizeof ( mBlock );
+    size_t count;
+
+    // Update number of bits, with the carry in the high 64 bits
+    mBitCount[ 1 ] += (uint64_t) size << 3;
+    mBitCount[ 0 ] += ( (uint64_t) size >> 61 ) + ( mBitCount[ 1 ] < ( (uint64_t) size << 3 ) ? 1 : 0 );
+
+    // Complete the pending block first
+    if( mIndex > 0 ) {
+        count = size < block - mIndex ? size : block - mIndex;
+        ::memcpy( mBlock + mIndex, buffer, count );
+        mIndex += count;
+        buffer += count;
+        size -= count;
+
+        if( mIndex < block ) {
+            return;
+        }
+
+        transform( mBlock, 1 );
+        mIndex = 0;
+    }
+
+    // Process the complete blocks directly from the caller's buffer
+    count = size / block;
+    if( count > 0 ) {
+        transform( buffer, count );
+        buffer += count * block;
+        size -= count * block;
+    }
+
+    // Buffer the remaining bytes
+    ::memcpy( mBlock, buffer, size );
+    mIndex = size;
+}
+
+/**
+ * Pads the last block with a 1 bit, zeros and the message length in bits, stored in the
+ * last 2 words, and processes it.
+ */
+template<typename Word>
+void Sha2Core<Word>::pad( ) {
+    const size_t block = sizeof ( mBlock );
+    const size_t length = block - 2 * sizeof ( Word );
+    int i;
+
+    // update() processes the full blocks, so there is always room for the 1 bit
+    mBlock[ mIndex ] = (uint8_t) 0x80;
+    mIndex++;
+
+    if( mIndex > length ) {
+        // Not enough room to hold the message length. So we pad the block, process it
+        // and continue padding on a second block.
+        ::memset( mBlock + mIndex, 0, block - mIndex );
+        transform( mBlock, 1 );
+        mIndex = 0;
+    }
+
+    ::memset( mBlock + mIndex, 0, length - mIndex );
+
+    // Store the message length, big-endian. SHA-224/256 only keep the low 64 bits.
+    for( i = 0; i < 8; i++ ) {
+        mBlock[ block - 1 - i ] = (uint8_t) ( mBitCount[ 1 ] >> ( i * 8 ) );
+        if( sizeof ( Word ) == 8 ) {
+            mBlock[ block - 9 - i ] = (uint8_t) ( mBitCount[ 0 ] >> ( i * 8 ) );
+        }
+    }
+
+    // Transform the last message block
+    transform( mBlock, 1 );
+}
+
+/**
+ * @copydoc HashingBase::finalize()
+ */
+template<typename Word>
+void Sha2Core<Word>::finalize( ) {
+    size_t i;
+
+    // Pad the last message block
+    pad( );
+
+    // Copy the first getHashSize() bits of the state in the resulting buffer. The resulting digest
+    // is big-endian; it ends in the middle of a word for SHA-512/224.
+    for( i = 0; i < getHashSize( ) / 8; i++ ) {
+        mHash[ i ] = (uint8_t) ( mState[ i / sizeof ( Word ) ] >> ( ( sizeof ( Word ) - 1 - i % sizeof ( Word ) ) * 8 ) );
+    }
+
+    // Clear sensitive information
+    clear( );
+}
+
+/**
+ * Clears internal data after finalization.
+ */
+template<typename Word>
+void Sha2Core<Word>::clear( ) {
+    ::memset( mState, 0, sizeof ( mState ) );
+    ::memset( mBlock, 0, sizeof ( mBlock ) );
+    ::memset( mBitCount, 0, sizeof ( mBitCount ) );
+    mIndex = 0;
+}
+
+template class libhash::Sha2Core<uint32_t>;
+template class libhash::Sha2Core<uint64_t>;
+
 //=== SHA-224 implementation ==================================================
 
 /**
  * @copydoc HashingBase::init()
  */
 void SHA2_224::init( ) {
-    // Initial context state
-    mState[ 0 ] = 0xc1059ed8;
-    mState[ 1 ] = 0x367cd507;
-    mState[ 2 ] = 0x3070dd17;
-    mState[ 3 ] = 0xf70e5939;
-    mState[ 4 ] = 0xffc00b31;
-    mState[ 5 ] = 0x68581511;
-    mState[ 6 ] = 0x64f98fa7;
-    mState[ 7 ] = 0xbefa4fa4;
-
-    mBitCount = 0;
-    mIndex = 0;
-}
-
-/**
- * @copydoc HashingBase::finalize()
- */
-void SHA2_224::finalize( ) {
-    int32_t i;
-
-    // Pad the last message block
-    pad( );
-
-    // Copy the digest number in the resulting buffer. The resulting
-    // hash is big-endian
-    for( i = 0; i < 7; i++ ) {
-        mHash[ ( i * 4 ) ] = (uint8_t) ( ( mState[ i ] & 0xff000000 ) >> 24 );
-        mHash[ ( i * 4 ) + 1 ] = (uint8_t) ( ( mState[ i ] & 0x00ff0000 ) >> 16 );
-        mHash[ ( i * 4 ) + 2 ] = (uint8_t) ( ( mState[ i ] & 0x0000ff00 ) >> 8 );
-        mHash[ ( i * 4 ) + 3 ] = (uint8_t)  ( mState[ i ] & 0x000000ff );
-    }
-
-    // Clear sensitive information
-    clear( );
+    start( Sha224Init );
 }
 
 void* hash_sha2_224_create( ) {
-    return new SHA2_256( );
+    return new SHA2_224( );
 }
 
 int hash_sha2_224_init( void *h ) {
@@ -221,172 +1611,40 @@ int hash_sha2_224_destroy( void *h ) {
  * @copydoc HashingBase::init()
  */
 void SHA2_256::init( ) {
-    // Initial context state
-    mState[ 0 ] = 0x6a09e667;
-    mState[ 1 ] = 0xbb67ae85;
-    mState[ 2 ] = 0x3c6ef372;
-    mState[ 3 ] = 0xa54ff53a;
-    mState[ 4 ] = 0x510e527f;
-    mState[ 5 ] = 0x9b05688c;
-    mState[ 6 ] = 0x1f83d9ab;
-    mState[ 7 ] = 0x5be0cd19;
-
-    mBitCount = 0;
-    mIndex = 0;
-}
-
-/**
- * @copydoc HashingBase::update( const void *, size_t )
- */
-void SHA2_256::update( const void *data, size_t size ) {
-    size_t i;
-
-    // Update number of bits
-    mBitCount += size << 3;
-
-    for( i = 0; i < size; i++ ) {
-        mBlock[mIndex++] = ( (uint8_t *) data )[i];
-        if( mIndex == 64 ) {
-            transform( );
-            mIndex = 0;
-        }
-    }
-}
-
-void SHA2_256::pad( ) {
-    // Make sure the message is a multiple 512-bits
-    if( mIndex > 55 ) {
-        if( mIndex < 64 ) {
-            // Not enough room to hold the padding bit and mesage length. So
-            // we pad the block, process it and continue padding on a
-            // second block.
-            mBlock[ mIndex ] = (uint8_t) 0x80;
-            mIndex++;
-            ::memset( mBlock + mIndex, 0, 64 - mIndex );
-
-            transform( );
-
-            // Pad only 56 bytes on the second block. The last 8 will be
-            // filled later with the message length.
-            ::memset( mBlock, 0, 56 );
-        }
-        else {
-            transform( );
-
-            mBlock[ 0 ] = 0x80;
-            ::memset( mBlock + 1, 0, 55 );
-        }
-    }
-    else {
-        // There is enough room for the padding bit and the message length
-        mBlock[ mIndex ] = (uint8_t) 0x80;
-        mIndex++;
-        ::memset( mBlock + mIndex, 0, 56 - mIndex );
-    }
-
-    // Store the message length the in last 64 bits (8 bytes)
-    mBlock[ 56 ] = (uint8_t) ( ( mBitCount & 0xFF00000000000000 ) >> 56 );
-    mBlock[ 57 ] = (uint8_t) ( ( mBitCount & 0x00FF000000000000 ) >> 48 );
-    mBlock[ 58 ] = (uint8_t) ( ( mBitCount & 0x0000FF0000000000 ) >> 40 );
-    mBlock[ 59 ] = (uint8_t) ( ( mBitCount & 0x000000FF00000000 ) >> 32 );
-    mBlock[ 60 ] = (uint8_t) ( ( mBitCount & 0x00000000FF000000 ) >> 24 );
-    mBlock[ 61 ] = (uint8_t) ( ( mBitCount & 0x0000000000FF0000 ) >> 16 );
-    mBlock[ 62 ] = (uint8_t) ( ( mBitCount & 0x000000000000FF00 ) >> 8 );
-    mBlock[ 63 ] = (uint8_t)  ( mBitCount & 0x00000000000000FF );
-
-    // Transform the last message block
-    transform( );
-}
-
-/**
- * @copydoc HashingBase::finalize()
- */
-void SHA2_256::finalize( ) {
-    int32_t i;
-
-    // Pad the last message block
-    pad( );
-
-    // Copy the digest number in the resulting buffer. The resulting
-    // hash is big-endian
-    for( i = 0; i < 8; i++ ) {
-        mHash[ ( i * 4 ) ] = (uint8_t) ( ( mState[ i ] & 0xFF000000 ) >> 24 );
-        mHash[ ( i * 4 ) + 1 ] = (uint8_t) ( ( mState[ i ] & 0x00FF0000 ) >> 16 );
-        mHash[ ( i * 4 ) + 2 ] = (uint8_t) ( ( mState[ i ] & 0x0000FF00 ) >> 8 );
-        mHash[ ( i * 4 ) + 3 ] = (uint8_t)  ( mState[ i ] & 0x000000FF );
-    }
-
-    // Clear sensitive information
-    clear( );
+    start( Sha256Init );
 }
 
 /**
- * Clears internal data after finalization.
+ * @brief Hashes a batch of independent messages.
+ *
+ * The messages are hashed 16 at a time, one per 32-bits lane (multi-buffer), on CPUs with
+ * AVX-512 (except the first ones, whose clock drops with the 512-bits instructions), or 8
+ * at a time on CPUs with AVX2 and without the SHA extensions. The messages can have
+ * different lengths. Otherwise, the messages are hashed one after the other with the
+ * fastest SHA-256 kernel.
+ * With <tt>LIBHASH_CALIBRATE</tt>, the kernels are measured the first time and each batch
+ * uses the fastest one for the mean size of its messages (see CPU).
+ *
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests: <tt>count * 32</tt> bytes, the digest of
+ *                  message <tt>i</tt> starting at <tt>digests[ i * 32 ]</tt>.
  */
-void SHA2_256::clear( ) {
-    ::memset( mState, 0, sizeof ( mState ) );
-    ::memset( mBlock, 0, sizeof ( mBlock ) );
-    mIndex = 0;
-    mBitCount = 0;
+void SHA2_256::batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    multiBufferBatch( sha256Batch, data, sizes, count, digests );
 }
 
 /**
- * Transformation rounds.
+ * @brief Retrieves the name of the kernel used by batch() on large messages.
+ *
+ * @return the multi-buffer kernel name, such as <tt>"avx2-8x"</tt>, or the name of the
+ *         SHA-256 kernel if the messages are hashed one after the other.
  */
-void SHA2_256::transform( ) {
-    uint32_t tmp1, tmp2;
-    uint32_t W[64];
-    uint32_t a, b, c, d, e, f, g, h;  // Working variables
-    int32_t  t;
-
-    // Prepare the buffer schedule
-    for( t = 0; t < 16; t++ ) {
-        W[ t ] = mBlock[ t * 4    ] << 24 |
-                mBlock[ t * 4 + 1 ] << 16 |
-                mBlock[ t * 4 + 2 ] <<  8 |
-                mBlock[ t * 4 + 3 ];
-    }
-
-    for( t = 16; t < 64; t++ ) {
-        W[ t ] = Sha256sigma1( W[ t - 2 ] ) + W[ t - 7 ] + Sha256sigma0( W[ t - 15 ] ) + W[ t - 16 ];
-    }
-
-    // Initialize working variables
-    a = mState[ 0 ];
-    b = mState[ 1 ];
-    c = mState[ 2 ];
-    d = mState[ 3 ];
-    e = mState[ 4 ];
-    f = mState[ 5 ];
-    g = mState[ 6 ];
-    h = mState[ 7 ];
-
-    // Rounds 0 to 63
-    for( t = 0; t < 64; t++ ) {
-        tmp1 = h + Sha256SIGMA1( e ) + CH( e, f, g ) + KSha256[ t ] + W[ t ];
-        tmp2 = Sha256SIGMA0( a ) + MAJ( a, b, c );
-        h = g;
-        g = f;
-        f = e;
-        e = d + tmp1;
-        d = c;
-        c = b;
-        b = a;
-        a = tmp1 + tmp2;
-    }
+const char *SHA2_256::getBatchKernel( ) {
+    const char *name = multiBufferName( sha256Batch );
 
-    // Update the context current state
-    mState[ 0 ] += a;
-    mState[ 1 ] += b;
-    mState[ 2 ] += c;
-    mState[ 3 ] += d;
-    mState[ 4 ] += e;
-    mState[ 5 ] += f;
-    mState[ 6 ] += g;
-    mState[ 7 ] += h;
-
-    // Reset the current block index
-    mIndex = 0;
+    return name != NULL ? name : sha256Kernel.name;
 }
 
 void* hash_sha2_256_create( ) {
@@ -452,50 +1710,24 @@ int hash_sha2_256_destroy( void *h ) {
     return rc;
 }
 
-//=== SHA-384 implementation ==================================================
+int hash_sha2_256_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    int rc = 0;
 
-/**
- * @copydoc HashingBase::init()
- */
-void SHA2_384::init( ) {
-    // Initial context state
-    mState[ 0 ] = 0xcbbb9d5dc1059ed8L;
-    mState[ 1 ] = 0x629a292a367cd507L;
-    mState[ 2 ] = 0x9159015a3070dd17L;
-    mState[ 3 ] = 0x152fecd8f70e5939L;
-    mState[ 4 ] = 0x67332667ffc00b31L;
-    mState[ 5 ] = 0x8eb44a8768581511L;
-    mState[ 6 ] = 0xdb0c2e0d64f98fa7L;
-    mState[ 7 ] = 0x47b5481dbefa4fa4L;
+    if(  data != NULL && sizes != NULL && digests != NULL ) {
+        rc = 1;
+        SHA2_256::batch( data, sizes, count, digests );
+    }
 
-    mBitCount[ 0 ] = 0;
-    mBitCount[ 1 ] = 0;
-    mIndex = 0;
+    return rc;
 }
 
+//=== SHA-384 implementation ==================================================
+
 /**
- * @copydoc HashingBase::finalize()
+ * @copydoc HashingBase::init()
  */
-void SHA2_384::finalize( ) {
-    int32_t i;
-
-    // Pad the last message block
-    pad( );
-
-    // Copy the digest number in the resulting buffer. The resulting digest is big-endian.
-    for( i = 0; i < 6; i++ ) {
-        mHash[ ( i * 8 ) ] = (uint8_t) ( ( mState[ i ] & 0xff00000000000000L ) >> 56 );
-        mHash[ ( i * 8 ) + 1 ] = (uint8_t) ( ( mState[ i ] & 0x00ff000000000000L ) >> 48 );
-        mHash[ ( i * 8 ) + 2 ] = (uint8_t) ( ( mState[ i ] & 0x0000ff0000000000L ) >> 40 );
-        mHash[ ( i * 8 ) + 3 ] = (uint8_t) ( ( mState[ i ] & 0x000000ff00000000L ) >> 32 );
-        mHash[ ( i * 8 ) + 4 ] = (uint8_t) ( ( mState[ i ] & 0x00000000ff000000L ) >> 24 );
-        mHash[ ( i * 8 ) + 5 ] = (uint8_t) ( ( mState[ i ] & 0x0000000000ff0000L ) >> 16 );
-        mHash[ ( i * 8 ) + 6 ] = (uint8_t) ( ( mState[ i ] & 0x000000000000ff00L ) >> 8 );
-        mHash[ ( i * 8 ) + 7 ] = (uint8_t) ( ( mState[ i ] & 0x00000000000000ffL ) );
-    }
-
-    // Clear sensitive information
-    clear( );
+void SHA2_384::init( ) {
+    start( Sha384Init );
 }
 
 void* hash_sha2_384_create( ) {
@@ -567,199 +1799,209 @@ int hash_sha2_384_destroy( void *h ) {
  * @copydoc HashingBase::init()
  */
 void SHA2_512::init( ) {
-    // Initial context state
-    mState[ 0 ] = 0x6a09e667f3bcc908L;
-    mState[ 1 ] = 0xbb67ae8584caa73bL;
-    mState[ 2 ] = 0x3c6ef372fe94f82bL;
-    mState[ 3 ] = 0xa54ff53a5f1d36f1L;
-    mState[ 4 ] = 0x510e527fade682d1L;
-    mState[ 5 ] = 0x9b05688c2b3e6c1fL;
-    mState[ 6 ] = 0x1f83d9abfb41bd6bL;
-    mState[ 7 ] = 0x5be0cd19137e2179L;
+    start( Sha512Init );
+}
 
-    mBitCount[ 0 ] = 0;
-    mBitCount[ 1 ] = 0;
-    mIndex = 0;
+/**
+ * @brief Hashes a batch of independent messages.
+ *
+ * The messages are hashed 8 at a time, one per 64-bits lane (multi-buffer), on CPUs with
+ * AVX-512 (except the first ones, whose clock drops with the 512-bits instructions), or 4
+ * at a time on CPUs with AVX2. The messages can have different lengths. Otherwise, the
+ * messages are hashed one after the other with the fastest SHA-512 kernel.
+ * With <tt>LIBHASH_CALIBRATE</tt>, the kernels are measured the first time and each batch
+ * uses the fastest one for the mean size of its messages (see CPU).
+ *
+ * @param data      Messages.
+ * @param sizes     Number of bytes of each message.
+ * @param count     Number of messages.
+ * @param digests   Buffer receiving the digests: <tt>count * 64</tt> bytes, the digest of
+ *                  message <tt>i</tt> starting at <tt>digests[ i * 64 ]</tt>.
+ */
+void SHA2_512::batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    multiBufferBatch( sha512Batch, data, sizes, count, digests );
 }
 
-void SHA2_512::update( const void *data, size_t size ) {
-    size_t i;
+/**
+ * @brief Retrieves the name of the kernel used by batch() on large messages.
+ *
+ * @return the multi-buffer kernel name, such as <tt>"avx2-4x"</tt>, or the name of the
+ *         SHA-512 kernel if the messages are hashed one after the other.
+ */
+const char *SHA2_512::getBatchKernel( ) {
+    const char *name = multiBufferName( sha512Batch );
 
-    // Update number of bits
-    mBitCount[ 0 ] += ( ( size & 0xffffffff00000000L ) >> 29 );
-    mBitCount[ 1 ] += ( size & 0x00000000ffffffffL ) << 3;
-    mBitCount[ 1 ] += ( mBitCount[ 0 ] & 0xffffffff00000000L ) >> 32;
-    mBitCount[ 0 ] &= 0x00000000ffffffffL;
-
-    for( i = 0; i < size; i++ ) {
-        mBlock[mIndex++] = ( (uint8_t *) data )[i];
-        if( mIndex == 128 ) {
-            transform( );
-            mIndex = 0;
-        }
+    return name != NULL ? name : sha512Kernel.name;
+}
+
+void* hash_sha2_512_create( ) {
+    return new SHA2_512( );
+}
+
+int hash_sha2_512_init( void *h ) {
+    int rc = 0;
+    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->init( );
+    }
+
+    return rc;
+}
+
+int hash_sha2_512_update( void *h, void *buf, size_t len ) {
+    int rc = 0;
+    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->update( buf, len );
     }
+
+    return rc;
 }
 
-void SHA2_512::pad( ) {
-    // Make sure the message is a multiple 512-bits
-    if( mIndex > 111 ) {
-        if( mIndex < 128 ) {
-            // Not enough room to hold the padding bit and mesage length. So
-            // we pad the block, process it and continue padding on a
-            // second block
-            mBlock[ mIndex ] = (uint8_t) 0x80;
-            mIndex++;
-            ::memset( mBlock + mIndex, 0, 128 - mIndex );
+int hash_sha2_512_finalize( void *h ) {
+    int rc = 0;
+    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->finalize( );
+    }
 
-            transform( );
+    return rc;
+}
 
-            // Pad only 112 bytes on the second block. The last 16 will be
-            // filled later with the message length.
-            ::memset( mBlock, 0, 112 );
-        }
-        else {
-            // Not enough room and the buffer is already full
-            transform( );
+int hash_sha2_512_get_value( void *h, uint8_t *buf, size_t len ) {
+    int rc = 0;
+    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
 
-            mBlock[ 0 ] = 0x80;
-            ::memset( mBlock + 1, 0, 111 );
-        }
+    if(  sha != NULL ) {
+        rc = sha->getValue( buf, len );
     }
-    else {
-        // There is enough room for the padding bit and the message length
-        mBlock[ mIndex ] = (uint8_t) 0x80;
-        mIndex++;
-        ::memset( mBlock + mIndex, 0, 112 - mIndex );
-    }
-
-    // Store the message length the in last 128 bits (16 bytes)
-    mBlock[ 112 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0xff00000000000000L ) >> 56 );
-    mBlock[ 113 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x00ff000000000000L ) >> 48 );
-    mBlock[ 114 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x0000ff0000000000L ) >> 40 );
-    mBlock[ 115 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x000000ff00000000L ) >> 32 );
-    mBlock[ 116 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x00000000ff000000L ) >> 24 );
-    mBlock[ 117 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x0000000000ff0000L ) >> 16 );
-    mBlock[ 118 ] = (uint8_t) ( ( mBitCount[ 0 ] & 0x000000000000ff00L ) >> 8 );
-    mBlock[ 119 ] = (uint8_t)  ( mBitCount[ 0 ] & 0x00000000000000ffL );
-    mBlock[ 120 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0xff00000000000000L ) >> 56 );
-    mBlock[ 121 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x00ff000000000000L ) >> 48 );
-    mBlock[ 122 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x0000ff0000000000L ) >> 40 );
-    mBlock[ 123 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x000000ff00000000L ) >> 32 );
-    mBlock[ 124 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x00000000ff000000L ) >> 24 );
-    mBlock[ 125 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x0000000000ff0000L ) >> 16 );
-    mBlock[ 126 ] = (uint8_t) ( ( mBitCount[ 1 ] & 0x000000000000ff00L ) >> 8 );
-    mBlock[ 127 ] = (uint8_t)  ( mBitCount[ 1 ] & 0x00000000000000ffL );
 
-    // Transform the last message block
-    transform( );
+    return rc;
 }
 
-/**
- * @copydoc HashingBase::finalize()
- */
-void SHA2_512::finalize( ) {
-    int32_t i;
+int hash_sha2_512_destroy( void *h ) {
+    int rc = 0;
+    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
 
-    // Pad the last message block
-    pad( );
+    if(  sha != NULL ) {
+        rc = 1;
+        delete sha;
+    }
 
-    // Copy the digest number in the resulting buffer. The resulting
-    // digest is big-endian.
-    for( i = 0; i < 8; i++ ) {
-        mHash[ ( i * 8 ) ] = (uint8_t) ( ( mState[ i ] & 0xff00000000000000L ) >> 56 );
-        mHash[ ( i * 8 ) + 1 ] = (uint8_t) ( ( mState[ i ] & 0x00ff000000000000L ) >> 48 );
-        mHash[ ( i * 8 ) + 2 ] = (uint8_t) ( ( mState[ i ] & 0x0000ff0000000000L ) >> 40 );
-        mHash[ ( i * 8 ) + 3 ] = (uint8_t) ( ( mState[ i ] & 0x000000ff00000000L ) >> 32 );
-        mHash[ ( i * 8 ) + 4 ] = (uint8_t) ( ( mState[ i ] & 0x00000000ff000000L ) >> 24 );
-        mHash[ ( i * 8 ) + 5 ] = (uint8_t) ( ( mState[ i ] & 0x0000000000ff0000L ) >> 16 );
-        mHash[ ( i * 8 ) + 6 ] = (uint8_t) ( ( mState[ i ] & 0x000000000000ff00L ) >> 8 );
-        mHash[ ( i * 8 ) + 7 ] = (uint8_t)  ( mState[ i ] & 0x00000000000000ffL );
+    return rc;
+}
+
+int hash_sha2_512_batch( const void *const *data, const size_t *sizes, size_t count, uint8_t *digests ) {
+    int rc = 0;
+
+    if(  data != NULL && sizes != NULL && digests != NULL ) {
+        rc = 1;
+        SHA2_512::batch( data, sizes, count, digests );
     }
 
-    // Clear sensitive information
-    clear( );
+    return rc;
 }
 
+//=== SHA-512/224 implementation ==============================================
+
 /**
- * Clears internal data after finalization.
+ * @copydoc HashingBase::init()
  */
-void SHA2_512::clear( ) {
-    ::memset( mBlock, 0, sizeof ( mBlock ) );
-    ::memset( mBitCount, 0, sizeof ( mBitCount ) );
-    ::memset( mState, 0, sizeof ( mState ) );
-    mIndex = 0;
+void SHA2_512_224::init( ) {
+    static uint64_t initial[8];
+    static const uint64_t *state = sha512TGenerate( initial, 224 );
+
+    start( state );
 }
 
-/**
- * Transformation rounds.
- */
-void SHA2_512::transform( ) {
-    uint64_t tmp1, tmp2;
-    uint64_t  W[80];
-    uint64_t  a, b, c, d, e, f, g, h;  /* Working variables */
-    int32_t   i;
+void* hash_sha2_512_224_create( ) {
+    return new SHA2_512_224( );
+}
+
+int hash_sha2_512_224_init( void *h ) {
+    int rc = 0;
+    SHA2_512_224 *sha = dynamic_cast<SHA2_512_224 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->init( );
+    }
+
+    return rc;
+}
+
+int hash_sha2_512_224_update( void *h, void *buf, size_t len ) {
+    int rc = 0;
+    SHA2_512_224 *sha = dynamic_cast<SHA2_512_224 *> ( (HashingBase *) h );
 
-    /* Prepare the buffer schedule */
-    for( i = 0; i < 16; i++ ) {
-        W[ i ] = ( (uint64_t) mBlock[ i * 8    ] << 56 ) |
-                ( (uint64_t) mBlock[ i * 8 + 1 ] << 48 ) |
-                ( (uint64_t) mBlock[ i * 8 + 2 ] << 40 ) |
-                ( (uint64_t) mBlock[ i * 8 + 3 ] << 32 ) |
-                ( (uint64_t) mBlock[ i * 8 + 4 ] << 24 ) |
-                ( (uint64_t) mBlock[ i * 8 + 5 ] << 16 ) |
-                ( (uint64_t) mBlock[ i * 8 + 6 ] <<  8 ) |
-                ( (uint64_t) mBlock[ i * 8 + 7 ] );
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->update( buf, len );
     }
 
-    for( i = 16; i < 80; i++ ) {
-        W[ i ] = Sha512sigma1( W[ i - 2 ] ) + W[ i - 7 ] + Sha512sigma0( W[ i - 15 ] ) + W[ i - 16 ];
+    return rc;
+}
+
+int hash_sha2_512_224_finalize( void *h ) {
+    int rc = 0;
+    SHA2_512_224 *sha = dynamic_cast<SHA2_512_224 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = 1;
+        sha->finalize( );
     }
 
-    // Initialize working variables
-    a = mState[ 0 ];
-    b = mState[ 1 ];
-    c = mState[ 2 ];
-    d = mState[ 3 ];
-    e = mState[ 4 ];
-    f = mState[ 5 ];
-    g = mState[ 6 ];
-    h = mState[ 7 ];
+    return rc;
+}
 
-    // Rounds 0 to 79
-    for( i = 0; i < 80; i++ ) {
-        tmp1 = h + Sha512SIGMA1( e ) + CH( e, f, g ) + KSha512[ i ] + W[ i ];
-        tmp2 = Sha512SIGMA0( a ) + MAJ( a, b, c );
-        h = g;
-        g = f;
-        f = e;
-        e = d + tmp1;
-        d = c;
-        c = b;
-        b = a;
-        a = tmp1 + tmp2;
+int hash_sha2_512_224_get_value( void *h, uint8_t *buf, size_t len ) {
+    int rc = 0;
+    SHA2_512_224 *sha = dynamic_cast<SHA2_512_224 *> ( (HashingBase *) h );
+
+    if(  sha != NULL ) {
+        rc = sha->getValue( buf, len );
     }
 
-    /* Update the context current state */
-    mState[ 0 ] += a;
-    mState[ 1 ] += b;
-    mState[ 2 ] += c;
-    mState[ 3 ] += d;
-    mState[ 4 ] += e;
-    mState[ 5 ] += f;
-    mState[ 6 ] += g;
-    mState[ 7 ] += h;
+    return rc;
+}
+
+int hash_sha2_512_224_destroy( void *h ) {
+    int rc = 0;
+    SHA2_512_224 *sha = dynamic_cast<SHA2_512_224 *> ( (HashingBase *) h );
 
-    // Reset the current block index
-    mIndex = 0;
+    if(  sha != NULL ) {
+        rc = 1;
+        delete sha;
+    }
+
+    return rc;
 }
 
-void* hash_sha2_512_create( ) {
-    return new SHA2_512( );
+//=== SHA-512/256 implementation ==============================================
+
+/**
+ * @copydoc HashingBase::init()
+ */
+void SHA2_512_256::init( ) {
+    static uint64_t initial[8];
+    static const uint64_t *state = sha512TGenerate( initial, 256 );
+
+    start( state );
 }
 
-int hash_sha2_512_init( void *h ) {
+void* hash_sha2_512_256_create( ) {
+    return new SHA2_512_256( );
+}
+
+int hash_sha2_512_256_init( void *h ) {
     int rc = 0;
-    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+    SHA2_512_256 *sha = dynamic_cast<SHA2_512_256 *> ( (HashingBase *) h );
 
     if(  sha != NULL ) {
         rc = 1;
@@ -769,9 +2011,9 @@ int hash_sha2_512_init( void *h ) {
     return rc;
 }
 
-int hash_sha2_512_update( void *h, void *buf, size_t len ) {
+int hash_sha2_512_256_update( void *h, void *buf, size_t len ) {
     int rc = 0;
-    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+    SHA2_512_256 *sha = dynamic_cast<SHA2_512_256 *> ( (HashingBase *) h );
 
     if(  sha != NULL ) {
         rc = 1;
@@ -781,9 +2023,9 @@ int hash_sha2_512_update( void *h, void *buf, size_t len ) {
     return rc;
 }
 
-int hash_sha2_512_finalize( void *h ) {
+int hash_sha2_512_256_finalize( void *h ) {
     int rc = 0;
-    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+    SHA2_512_256 *sha = dynamic_cast<SHA2_512_256 *> ( (HashingBase *) h );
 
     if(  sha != NULL ) {
         rc = 1;
@@ -793,9 +2035,9 @@ int hash_sha2_512_finalize( void *h ) {
     return rc;
 }
 
-int hash_sha2_512_get_value( void *h, uint8_t *buf, size_t len ) {
+int hash_sha2_512_256_get_value( void *h, uint8_t *buf, size_t len ) {
     int rc = 0;
-    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+    SHA2_512_256 *sha = dynamic_cast<SHA2_512_256 *> ( (HashingBase *) h );
 
     if(  sha != NULL ) {
         rc = sha->getValue( buf, len );
@@ -804,9 +2046,9 @@ int hash_sha2_512_get_value( void *h, uint8_t *buf, size_t len ) {
     return rc;
 }
 
-int hash_sha2_512_destroy( void *h ) {
+int hash_sha2_512_256_destroy( void *h ) {
     int rc = 0;
-    SHA2_512 *sha = dynamic_cast<SHA2_512 *> ( (HashingBase *) h );
+    SHA2_512_256 *sha = dynamic_cast<SHA2_512_256 *> ( (HashingBase *) h );
 
     if(  sha != NULL ) {
         rc = 1;
@@ -0,0 +1,335 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+/*
+ * File:   CPUTests.cpp
+ * Author: Yanick Poirier <ypoirier at hotmail.com>
+ *
+ * Created on 2019-11-23, 14:05:10
+ */
+
+#include <libhash/libhash.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "../src/calibrate.h"
+#include "../src/kernels.h"
+#include "libHashTestCases.h"
+
+using namespace libhash;
+
+/**
+ * Fake kernels: 0 reads every byte, 1 does nothing but refuses buffers below 1KB and 2
+ * refuses every buffer.
+ */
+static bool cpuBenchmark( const void *, unsigned kernel, const uint8_t *buffer, size_t size ) {
+    static volatile uint8_t sink;
+
+    if( kernel == 0 ) {
+        for( size_t i = 0; i < size; i++ ) {
+            sink ^= buffer[ i ];
+        }
+    }
+
+    return kernel == 0 || ( kernel == 1 && size >= 1024 );
+}
+
+/**
+ * Fake kernels where kernel 0 always wins.
+ */
+static bool cpuBenchmarkSlow( const void *, unsigned kernel, const uint8_t *, size_t ) {
+    return kernel == 0;
+}
+
+/**
+ * Hashes buffers around the block sizes and the kernel thresholds with every algorithm
+ * that has hardware kernels, and returns all the digests one after the other.
+ */
+static std::vector<uint8_t> cpuTranscript( ) {
+    static const size_t lengths[] = { 0, 1, 15, 16, 17, 55, 56, 63, 64, 65, 111, 112, 127, 128, 255, 256, 257,
+                                      1023, 1024, 1025, 4109, 65543 };
+    static const BatchFunction batches[] = { MD5::batch, SHA1::batch, SHA2_256::batch, SHA2_512::batch };
+    const size_t count = sizeof ( lengths ) / sizeof ( lengths[ 0 ] );
+    CRC16_CCITT crc16ccitt;
+    CRC16_XModem crc16xmodem;
+    CRC16_X25 crc16x25;
+    CRC32 crc32;
+    CRC32_BZip2 crc32bzip2;
+    CRC32C crc32c;
+    CRC64_ECMA182 crc64ecma;
+    CRC64_XZ crc64xz;
+    CRC64_NVMe crc64nvme;
+    MD5 md5;
+    SHA1 sha1;
+    SHA2_224 sha224;
+    SHA2_256 sha256;
+    SHA2_384 sha384;
+    SHA2_512 sha512;
+    HashingBase *hashes[] = { &crc16ccitt, &crc16xmodem, &crc16x25, &crc32, &crc32bzip2, &crc32c, &crc64ecma, &crc64xz,
+                              &crc64nvme, &md5, &sha1, &sha224, &sha256, &sha384, &sha512 };
+    std::vector<uint8_t> buffer( lengths[ count - 1 ] + count );
+    std::vector<uint8_t> transcript;
+    const void *data[ count ];
+    size_t sizes[ count ];
+    uint8_t digests[ count * 64 ];
+
+    for( size_t i = 0; i < buffer.size( ); i++ ) {
+        buffer[ i ] = (uint8_t) ( i * 167 + 13 );
+    }
+
+    for( size_t i = 0; i < count; i++ ) {
+        data[ i ] = buffer.data( ) + i;
+        sizes[ i ] = lengths[ i ];
+    }
+
+    for( HashingBase *hash : hashes ) {
+        for( size_t i = 0; i < count; i++ ) {
+            hash->init( );
+            hash->update( data[ i ], sizes[ i ] );
+            hash->finalize( );
+            hash->getValue( digests, hash->getHashSize( ) / 8 );
+            transcript.insert( transcript.end( ), digests, digests + hash->getHashSize( ) / 8 );
+        }
+    }
+
+    // Room for the largest digests, those of SHA-512
+    for( BatchFunction batch : batches ) {
+        ::memset( digests, 0, sizeof ( digests ) );
+        batch( data, sizes, count, digests );
+        transcript.insert( transcript.end( ), digests, digests + sizeof ( digests ) );
+    }
+
+    return transcript;
+}
+
+void libHashTestCases::testCPUFeatures( ) {
+    uint32_t detected = CPU::getDetected( );
+    uint32_t features = CPU::getFeatures( );
+
+    CPPUNIT_ASSERT_MESSAGE( "Enabled features not detected", ( features & ~detected ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "C API features", hash_cpu_get_features( ) == features );
+    CPPUNIT_ASSERT_MESSAGE( "C API detected", hash_cpu_get_detected( ) == detected );
+
+    if( detected & HASH_CPU_AVX2 ) {
+        CPPUNIT_ASSERT_MESSAGE( "AVX2 without AVX", detected & HASH_CPU_AVX );
+    }
+
+    if( detected & HASH_CPU_VPCLMUL ) {
+        CPPUNIT_ASSERT_MESSAGE( "VPCLMUL without AVX-512", detected & HASH_CPU_AVX512 );
+    }
+}
+
+void libHashTestCases::testCPURestrict( ) {
+    uint32_t all = HASH_CPU_TIER_AVX512;
+
+    CPPUNIT_ASSERT_MESSAGE( "No override", CPU::restrict( all, NULL ) == all );
+    CPPUNIT_ASSERT_MESSAGE( "Empty override", CPU::restrict( all, "" ) == all );
+    CPPUNIT_ASSERT_MESSAGE( "generic", CPU::restrict( all, "generic" ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "sse4", CPU::restrict( all, "sse4" ) == HASH_CPU_TIER_SSE4 );
+    CPPUNIT_ASSERT_MESSAGE( "avx2", CPU::restrict( all, "avx2" ) == HASH_CPU_TIER_AVX2 );
+    CPPUNIT_ASSERT_MESSAGE( "avx512", CPU::restrict( all, "avx512" ) == all );
+    CPPUNIT_ASSERT_MESSAGE( "-avx512", CPU::restrict( all, "-avx512" ) == HASH_CPU_TIER_AVX2 );
+    CPPUNIT_ASSERT_MESSAGE( "avx2,-sha", CPU::restrict( all, "avx2,-sha" ) == ( HASH_CPU_TIER_AVX2 & ~HASH_CPU_SHA ) );
+    CPPUNIT_ASSERT_MESSAGE( "-avx", CPU::restrict( all, "-avx" ) == ( HASH_CPU_TIER_SSE4 | HASH_CPU_BMI2 ) );
+    CPPUNIT_ASSERT_MESSAGE( "-avx2", CPU::restrict( all, "-avx2" ) == ( HASH_CPU_TIER_SSE4 | HASH_CPU_AVX | HASH_CPU_BMI2 ) );
+    CPPUNIT_ASSERT_MESSAGE( "-vpclmul", CPU::restrict( all, "-vpclmul" ) == ( all & ~HASH_CPU_VPCLMUL ) );
+    CPPUNIT_ASSERT_MESSAGE( "-avx512fast", CPU::restrict( all, "-avx512fast" ) == ( all & ~HASH_CPU_AVX512_FAST ) );
+    CPPUNIT_ASSERT_MESSAGE( "Unknown names", CPU::restrict( all, "foo,-bar,," ) == all );
+    CPPUNIT_ASSERT_MESSAGE( "Never enables", CPU::restrict( HASH_CPU_SSE42, "avx512" ) == HASH_CPU_SSE42 );
+}
+
+void libHashTestCases::testCPUKernel( ) {
+    CRC32C crc32c;
+    CRC32 crc32;
+    CRC16_X25 crc16;
+    CRC64_XZ crc64;
+    Crc<32, 0x814141ab, 0x00000000, 0x00000000, false, false> crc32q;
+    SHA2_256 sha256;
+    SHA2_224 sha224;
+    SHA2_512 sha512;
+    SHA2_384 sha384;
+    SHA1 sha1;
+
+    CPPUNIT_ASSERT_MESSAGE( "CRC-32Q kernel", strcmp( crc32q.getKernel( ), "slicing-by-16" ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-256 kernel", hash_get_kernel( &sha256 ) != NULL );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-224 kernel", strcmp( sha224.getKernel( ), sha256.getKernel( ) ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-384 kernel", strcmp( sha384.getKernel( ), sha512.getKernel( ) ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "C API kernel", strcmp( hash_get_kernel( (HashingBase *) &crc32 ), crc32.getKernel( ) ) == 0 );
+
+#if defined( __x86_64__ )
+    CPPUNIT_ASSERT_MESSAGE( "CRC-32C kernel", strcmp( crc32c.getKernel( ), CPU::has( HASH_CPU_SSE42 ) ? "sse4.2" : "slicing-by-16" ) == 0 );
+    if( CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 SHA-NI kernel", strcmp( sha256.getKernel( ), "sha-ni" ) == 0 );
+    }
+    else if( CPU::has( HASH_CPU_AVX2 | HASH_CPU_BMI2 ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 AVX2 kernel", strcmp( sha256.getKernel( ), "avx2" ) == 0 );
+    }
+    else if( CPU::has( HASH_CPU_AVX ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 AVX kernel", strcmp( sha256.getKernel( ), "avx" ) == 0 );
+    }
+    else {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 SSSE3 kernel", strcmp( sha256.getKernel( ), CPU::has( HASH_CPU_SSSE3 ) ? "ssse3" : "generic" ) == 0 );
+    }
+    CPPUNIT_ASSERT_MESSAGE( "SHA-1 SHA-NI kernel", strcmp( sha1.getKernel( ), CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) ? "sha-ni" : "generic" ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-512 kernel", strcmp( sha512.getKernel( ), CPU::has( HASH_CPU_AVX2 | HASH_CPU_BMI2 ) ? "avx2" : "generic" ) == 0 );
+
+    if( CPU::has( HASH_CPU_AVX512 | HASH_CPU_AVX512_FAST ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 batch kernel", strcmp( SHA2_256::getBatchKernel( ), "avx512-16x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch kernel", strcmp( SHA1::getBatchKernel( ), "avx512-16x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "MD5 batch kernel", strcmp( MD5::getBatchKernel( ), "avx512-16x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-512 batch kernel", strcmp( SHA2_512::getBatchKernel( ), "avx512-8x" ) == 0 );
+    }
+    else if( CPU::has( HASH_CPU_AVX2 ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 batch kernel", strcmp( SHA2_256::getBatchKernel( ), CPU::has( HASH_CPU_SHA | HASH_CPU_SSE41 | HASH_CPU_SSSE3 ) ? sha256.getKernel( ) : "avx2-8x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch kernel", strcmp( SHA1::getBatchKernel( ), "avx2-8x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "MD5 batch kernel", strcmp( MD5::getBatchKernel( ), "avx2-8x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-512 batch kernel", strcmp( SHA2_512::getBatchKernel( ), "avx2-4x" ) == 0 );
+    }
+    else {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-256 batch kernel", strcmp( SHA2_256::getBatchKernel( ), sha256.getKernel( ) ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch kernel", strcmp( SHA1::getBatchKernel( ), sha1.getKernel( ) ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "MD5 batch kernel", strcmp( MD5::getBatchKernel( ), "scalar-2x" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "SHA-512 batch kernel", strcmp( SHA2_512::getBatchKernel( ), sha512.getKernel( ) ) == 0 );
+    }
+
+    if( CPU::has( HASH_CPU_PCLMUL | HASH_CPU_SSE41 | HASH_CPU_AVX512 | HASH_CPU_VPCLMUL ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "CRC-32 kernel", strcmp( crc32.getKernel( ), "vpclmulqdq" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "CRC-16 kernel", strcmp( crc16.getKernel( ), "vpclmulqdq" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "CRC-64 kernel", strcmp( crc64.getKernel( ), "vpclmulqdq" ) == 0 );
+    }
+    else if( CPU::has( HASH_CPU_PCLMUL | HASH_CPU_SSE41 ) ) {
+        CPPUNIT_ASSERT_MESSAGE( "CRC-32 kernel", strcmp( crc32.getKernel( ), "pclmulqdq" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "CRC-16 kernel", strcmp( crc16.getKernel( ), "pclmulqdq" ) == 0 );
+        CPPUNIT_ASSERT_MESSAGE( "CRC-64 kernel", strcmp( crc64.getKernel( ), "pclmulqdq" ) == 0 );
+    }
+#endif
+}
+
+void libHashTestCases::testCPUCalibrate( ) {
+    size_t thresholds[ 2 ] = { 1, 2 };
+
+    unsetenv( HASH_CALIBRATE_ENV );
+    CPPUNIT_ASSERT_MESSAGE( "Calibration disabled", !cpuCalibrate( "test", 3, cpuBenchmark, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Thresholds unchanged", thresholds[ 0 ] == 1 && thresholds[ 1 ] == 2 );
+
+    setenv( HASH_CALIBRATE_ENV, "1", 1 );
+    CPPUNIT_ASSERT_MESSAGE( "Calibration enabled", cpuCalibrate( "test", 3, cpuBenchmark, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Kernel 1 threshold", thresholds[ 0 ] == 1024 );
+    CPPUNIT_ASSERT_MESSAGE( "Kernel 2 threshold", thresholds[ 1 ] == SIZE_MAX );
+
+    // The decision is kept for the process
+    CPPUNIT_ASSERT_MESSAGE( "Calibration kept", cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Kept threshold", thresholds[ 0 ] == 1024 && thresholds[ 1 ] == SIZE_MAX );
+
+    CPPUNIT_ASSERT_MESSAGE( "Other calibration", cpuCalibrate( "test-slow", 2, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Never wins", thresholds[ 0 ] == SIZE_MAX );
+
+    // Cache files: an empty file is ignored, then the decision is written to it
+    char path[] = "/tmp/libhashXXXXXX";
+    char other[] = "/tmp/libhashXXXXXX";
+    int fd = mkstemp( path );
+    int otherFd = mkstemp( other );
+    char line[ 64 ];
+    FILE *file;
+
+    CPPUNIT_ASSERT_MESSAGE( "Temporary files", fd >= 0 && otherFd >= 0 );
+    close( fd );
+    close( otherFd );
+
+    setenv( HASH_CALIBRATE_ENV, path, 1 );
+    CPPUNIT_ASSERT_MESSAGE( "File calibration", cpuCalibrate( "test", 3, cpuBenchmark, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "File threshold", thresholds[ 0 ] == 1024 && thresholds[ 1 ] == SIZE_MAX );
+
+    file = fopen( path, "r" );
+    CPPUNIT_ASSERT_MESSAGE( "File written", file != NULL );
+    CPPUNIT_ASSERT_MESSAGE( "File header", fgets( line, sizeof ( line ), file ) != NULL &&
+                            strncmp( line, "libhash-calibration ", 20 ) == 0 &&
+                            strtoul( line + 20, NULL, 16 ) == CPU::getFeatures( ) );
+    fclose( file );
+
+    // Switching files reloads the decisions: the cached one wins over a new measure
+    setenv( HASH_CALIBRATE_ENV, other, 1 );
+    CPPUNIT_ASSERT_MESSAGE( "Other file", cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Other file threshold", thresholds[ 0 ] == SIZE_MAX && thresholds[ 1 ] == SIZE_MAX );
+
+    setenv( HASH_CALIBRATE_ENV, path, 1 );
+    CPPUNIT_ASSERT_MESSAGE( "File reloaded", cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Reloaded threshold", thresholds[ 0 ] == 1024 && thresholds[ 1 ] == SIZE_MAX );
+
+    // A file written with other CPU features is stale and measured again
+    file = fopen( path, "w" );
+    fprintf( file, "libhash-calibration %x\ntest 1024 %llu\n", CPU::getFeatures( ) ^ HASH_CPU_SSE42, (unsigned long long) SIZE_MAX );
+    fclose( file );
+
+    setenv( HASH_CALIBRATE_ENV, other, 1 );
+    cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds );
+    setenv( HASH_CALIBRATE_ENV, path, 1 );
+    CPPUNIT_ASSERT_MESSAGE( "Stale features", cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Stale features threshold", thresholds[ 0 ] == SIZE_MAX );
+
+    // So is a file with another magic
+    file = fopen( path, "w" );
+    fprintf( file, "libhash-calibrated %x\ntest 1024 %llu\n", CPU::getFeatures( ), (unsigned long long) SIZE_MAX );
+    fclose( file );
+
+    setenv( HASH_CALIBRATE_ENV, other, 1 );
+    cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds );
+    setenv( HASH_CALIBRATE_ENV, path, 1 );
+    CPPUNIT_ASSERT_MESSAGE( "Stale magic", cpuCalibrate( "test", 3, cpuBenchmarkSlow, NULL, thresholds ) );
+    CPPUNIT_ASSERT_MESSAGE( "Stale magic threshold", thresholds[ 0 ] == SIZE_MAX );
+
+    unsetenv( HASH_CALIBRATE_ENV );
+    unlink( path );
+    unlink( other );
+}
+
+void libHashTestCases::testCPUTiers( ) {
+    // Each tier selects other kernels, from the first SSE4 ones to all of them
+    static const char *const tiers[] = { "sse4", "-sha,-avx", "-sha,-avx2", "avx2,-sha", "avx2", "-bmi2", "-sha", "-pclmul",
+                                         "-avx512fast", "-vpclmul", "" };
+    uint32_t features = CPU::getFeatures( );
+    std::vector<uint8_t> reference;
+    CRC32C crc32c;
+    SHA1 sha1;
+
+    cpuBind( 0 );
+    CPPUNIT_ASSERT_MESSAGE( "Generic CRC-32C kernel", strcmp( crc32c.getKernel( ), "slicing-by-16" ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "Generic SHA-1 kernel", strcmp( sha1.getKernel( ), "generic" ) == 0 );
+    CPPUNIT_ASSERT_MESSAGE( "Generic MD5 batch kernel", strcmp( MD5::getBatchKernel( ), "scalar-2x" ) == 0 );
+    reference = cpuTranscript( );
+
+    for( const char *tier : tiers ) {
+        bool same;
+
+        cpuBind( CPU::restrict( features, tier ) );
+        same = cpuTranscript( ) == reference;
+
+        // Bind the kernels back before failing, for the other tests
+        if( !same ) {
+            cpuBind( features );
+        }
+        CPPUNIT_ASSERT_MESSAGE( std::string( "Kernels of the tier \"" ) + tier + "\" differ from the generic ones", same );
+    }
+
+    cpuBind( features );
+    CPPUNIT_ASSERT_MESSAGE( "Features restored", CPU::getFeatures( ) == features );
+}
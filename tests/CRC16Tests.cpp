@@ -26,10 +26,128 @@
 
 #include <libhash/libhash.h>
 #include <string.h>
+#include <vector>
 #include "libHashTestCases.h"
 
 using namespace libhash;
 
+/**
+ * Computes the final CRC-16 value of a buffer as an integer.
+ */
+static uint16_t crc16Value( HashingBase &hash, const char *data, uint32_t size ) {
+    uint8_t value[ 2 ];
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( value, sizeof ( value ) );
+
+    return ( (uint16_t) value[ 0 ] << 8 ) | value[ 1 ];
+}
+
+/**
+ * Splits the data at a few points and checks that combining the CRC of both parts gives
+ * the CRC of the whole data.
+ */
+static void runCombine16( int testNo, CRC16Base &crc, const char *name, const char *data, uint32_t size, uint8_t expected[] ) {
+    uint16_t whole = ( (uint16_t) expected[ 0 ] << 8 ) | expected[ 1 ];
+    uint32_t splits[] = { 0, 1, size / 3, size / 2, size - 1, size };
+
+    for( int i = 0; i < sizeof ( splits ) / sizeof ( uint32_t ); i++ ) {
+        uint32_t split = splits[ i ] > size ? size : splits[ i ];
+        uint16_t crcA = crc16Value( crc, data, split );
+        uint16_t crcB = crc16Value( crc, data + split, size - split );
+
+        if( crc.combine( crcA, crcB, size - split ) != whole ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Combine test #";
+            msg += std::to_string( testNo );
+            msg += " failed at offset ";
+            msg += std::to_string( split );
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Checks that updateParallel() gives the same CRC as update() for any number of threads,
+ * including when the CRC register does not start from its initial value.
+ */
+static void runParallel16( CRC16Base &crc, const char *name, const uint8_t *data, size_t size ) {
+    HashingBase &hash = crc;
+    uint8_t expected[ 2 ];
+    uint8_t result[ 2 ];
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( expected, sizeof ( expected ) );
+
+    for( unsigned threads = 0; threads <= 8; threads++ ) {
+        hash.init( );
+        hash.update( data, 3 );
+        crc.updateParallel( data + 3, size - 3, threads );
+        hash.finalize( );
+        hash.getValue( result, sizeof ( result ) );
+
+        if( memcmp( result, expected, sizeof ( result ) ) != 0 ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Parallel test failed with ";
+            msg += std::to_string( threads );
+            msg += " threads";
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Checks a CRC instantiated from the generic engine against its catalogued check value
+ * (CRC of "123456789"), then checks that the sliced and the byte-at-a-time paths agree.
+ */
+static void runTemplate16( CRC16Base &crc, const char *name, uint16_t check ) {
+    const char *digits = "123456789";
+    uint8_t data[ 1000 ];
+    uint8_t whole[ 2 ];
+    uint8_t value[ 2 ];
+
+    if( crc16Value( crc, digits, 9 ) != check ) {
+        std::string msg;
+
+        msg += name;
+        msg += " check value failed";
+        CPPUNIT_FAIL( msg );
+    }
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        data[ i ] = (uint8_t) ( i * 7 + 3 );
+    }
+
+    crc.init( );
+    crc.update( data, sizeof ( data ) );
+    crc.finalize( );
+    crc.getValue( whole, sizeof ( whole ) );
+    crc.init( );
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        crc.update( data + i, 1 );
+    }
+
+    crc.finalize( );
+    crc.getValue( value, sizeof ( value ) );
+
+    if( memcmp( value, whole, sizeof ( value ) ) != 0 ) {
+        std::string msg;
+
+        msg += name;
+        msg += " byte-at-a-time test failed";
+        CPPUNIT_FAIL( msg );
+    }
+}
+
 void libHashTestCases::testCRC16_CCITT( ) {
     CRC16_CCITT crc16;
 
@@ -65,3 +183,41 @@ void libHashTestCases::testCRC16_X25( ) {
         runMultiChunk( 11 + i, crc16, "CRC-16-X25", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].crc16x25 );
     }
 }
+
+void libHashTestCases::testCRC16Combine( ) {
+    CRC16_CCITT crc16_ccitt;
+    CRC16_XModem crc16_xmodem;
+    CRC16_X25 crc16_x25;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runCombine16( i + 1, crc16_ccitt, "CRC-16-CCITT", testCases[i].data, testCases[i].size, testCases[i].crc16ccitt );
+        runCombine16( i + 1, crc16_xmodem, "CRC-16-XMODEM", testCases[i].data, testCases[i].size, testCases[i].crc16xmodem );
+        runCombine16( i + 1, crc16_x25, "CRC-16-X25", testCases[i].data, testCases[i].size, testCases[i].crc16x25 );
+    }
+}
+
+void libHashTestCases::testCRC16Parallel( ) {
+    size_t size = 2 * 1024 * 1024 + 13;
+    std::vector<uint8_t> data( size );
+    CRC16_CCITT crc16_ccitt;
+    CRC16_XModem crc16_xmodem;
+    CRC16_X25 crc16_x25;
+
+    for( size_t i = 0; i < size; i++ ) {
+        data[ i ] = (uint8_t) ( ( i * 2654435761u ) >> 13 );
+    }
+
+    runParallel16( crc16_ccitt, "CRC-16-CCITT", data.data( ), size );
+    runParallel16( crc16_xmodem, "CRC-16-XMODEM", data.data( ), size );
+    runParallel16( crc16_x25, "CRC-16-X25", data.data( ), size );
+}
+
+void libHashTestCases::testCRC16Template( ) {
+    Crc<16, 0x8005, 0xffff, 0x0000, true, true> crc0;
+    Crc<16, 0x8005, 0x0000, 0x0000, true, true> crc1;
+    Crc<16, 0x1021, 0x0000, 0x0000, true, true> crc2;
+
+    runTemplate16( crc0, "CRC-16-MODBUS", 0x4b37 );
+    runTemplate16( crc1, "CRC-16-ARC", 0xbb3d );
+    runTemplate16( crc2, "CRC-16-KERMIT", 0x2189 );
+}
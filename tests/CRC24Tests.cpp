@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+/*
+ * File:   CRC24Tests.cpp
+ * Author: Yanick Poirier <ypoirier at hotmail.com>
+ *
+ * Created on 2019-11-10, 10:40:07
+ */
+
+#include <libhash/libhash.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "libHashTestCases.h"
+
+using namespace libhash;
+
+/**
+ * Finalizes a CRC-24 and retrieves its value as an integer.
+ */
+static uint32_t crc24Final( HashingBase &hash ) {
+    uint8_t value[ 3 ];
+
+    hash.finalize( );
+    hash.getValue( value, sizeof ( value ) );
+
+    return ( (uint32_t) value[ 0 ] << 16 ) | ( (uint32_t) value[ 1 ] << 8 ) | value[ 2 ];
+}
+
+/**
+ * Computes the final CRC-24 value of a buffer as an integer.
+ */
+static uint32_t crc24Value( HashingBase &hash, const void *data, size_t size ) {
+    hash.init( );
+    hash.update( data, size );
+
+    return crc24Final( hash );
+}
+
+/**
+ * Checks a CRC instantiated from the generic engine against its catalogued check value
+ * (CRC of "123456789"), then checks that the sliced and the byte-at-a-time paths, combine()
+ * and updateParallel() agree with it.
+ */
+static void runTemplate24( CRC24Base &crc, const char *name, uint32_t check ) {
+    const char *digits = "123456789";
+    size_t size = 1024 * 1024 + 13;
+    std::vector<uint8_t> data( size );
+    size_t splits[] = { 0, 1, 15, 1000, size - 1, size };
+    uint32_t whole;
+    std::string msg( name );
+
+    if( crc24Value( crc, digits, 9 ) != check ) {
+        CPPUNIT_FAIL( msg + " check value failed" );
+    }
+
+    for( size_t i = 0; i < size; i++ ) {
+        data[ i ] = (uint8_t) ( ( i * 2654435761u ) >> 13 );
+    }
+
+    whole = crc24Value( crc, data.data( ), size );
+
+    crc.init( );
+    for( size_t i = 0; i < 1000; i++ ) {
+        crc.update( data.data( ) + i, 1 );
+    }
+
+    crc.update( data.data( ) + 1000, size - 1000 );
+    if( crc24Final( crc ) != whole ) {
+        CPPUNIT_FAIL( msg + " byte-at-a-time test failed" );
+    }
+
+    for( int i = 0; i < sizeof ( splits ) / sizeof ( size_t ); i++ ) {
+        uint32_t crcA = crc24Value( crc, data.data( ), splits[ i ] );
+        uint32_t crcB = crc24Value( crc, data.data( ) + splits[ i ], size - splits[ i ] );
+
+        if( crc.combine( crcA, crcB, size - splits[ i ] ) != whole ) {
+            CPPUNIT_FAIL( msg + " combine test failed at " + std::to_string( splits[ i ] ) );
+        }
+    }
+
+    crc.init( );
+    crc.updateParallel( data.data( ), size, 4 );
+    if( crc24Final( crc ) != whole ) {
+        CPPUNIT_FAIL( msg + " parallel test failed" );
+    }
+}
+
+void libHashTestCases::testCRC24Template( ) {
+    Crc<24, 0x864cfb, 0xb704ce, 0x000000, false, false> crc0;
+    Crc<24, 0x00065b, 0x555555, 0x000000, true, true> crc1;
+    Crc<24, 0x328b63, 0xffffff, 0xffffff, false, false> crc2;
+
+    runTemplate24( crc0, "CRC-24-OPENPGP", 0x21cf02 );
+    runTemplate24( crc1, "CRC-24-BLE", 0xc25a56 );
+    runTemplate24( crc2, "CRC-24-INTERLAKEN", 0xb4f3e6 );
+}
@@ -25,11 +25,180 @@
  */
 
 #include <libhash/libhash.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
+#include <vector>
 #include "libHashTestCases.h"
 
 using namespace libhash;
 
+/**
+ * Computes the final CRC-32 value of a buffer as an integer.
+ */
+static uint32_t crc32Value( HashingBase &hash, const char *data, uint32_t size ) {
+    uint8_t value[ 4 ];
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( value, sizeof ( value ) );
+
+    return ( (uint32_t) value[ 0 ] << 24 ) | ( (uint32_t) value[ 1 ] << 16 ) | ( (uint32_t) value[ 2 ] << 8 ) | value[ 3 ];
+}
+
+/**
+ * Splits the data at a few points and checks that combining the CRC of both parts gives
+ * the CRC of the whole data.
+ */
+static void runCombine32( int testNo, CRC32Base &crc, const char *name, const char *data, uint32_t size, uint8_t expected[] ) {
+    uint32_t whole = ( (uint32_t) expected[ 0 ] << 24 ) | ( (uint32_t) expected[ 1 ] << 16 ) | ( (uint32_t) expected[ 2 ] << 8 ) | expected[ 3 ];
+    uint32_t splits[] = { 0, 1, size / 3, size / 2, size - 1, size };
+
+    for( int i = 0; i < sizeof ( splits ) / sizeof ( uint32_t ); i++ ) {
+        uint32_t split = splits[ i ] > size ? size : splits[ i ];
+        uint32_t crcA = crc32Value( crc, data, split );
+        uint32_t crcB = crc32Value( crc, data + split, size - split );
+
+        if( crc.combine( crcA, crcB, size - split ) != whole ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Combine test #";
+            msg += std::to_string( testNo );
+            msg += " failed at offset ";
+            msg += std::to_string( split );
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Checks that updateParallel() gives the same CRC as update() for any number of threads,
+ * including when the CRC register does not start from its initial value.
+ */
+static void runParallel32( CRC32Base &crc, const char *name, const uint8_t *data, size_t size ) {
+    HashingBase &hash = crc;
+    uint8_t expected[ 4 ];
+    uint8_t result[ 4 ];
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( expected, sizeof ( expected ) );
+
+    for( unsigned threads = 0; threads <= 8; threads++ ) {
+        hash.init( );
+        hash.update( data, 3 );
+        crc.updateParallel( data + 3, size - 3, threads );
+        hash.finalize( );
+        hash.getValue( result, sizeof ( result ) );
+
+        if( memcmp( result, expected, sizeof ( result ) ) != 0 ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Parallel test failed with ";
+            msg += std::to_string( threads );
+            msg += " threads";
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Writes a sparse file with a few data blocks and checks that updateFile() gives the same
+ * CRC as update() on the whole content, holes included.
+ */
+static void runFile32( CRC32Base &crc, const char *name ) {
+    size_t size = 8 * 1024 * 1024 + 7;
+    size_t offsets[] = { 0, 3 * 1024 * 1024 + 100, 5 * 1024 * 1024 };
+    std::vector<uint8_t> data( size, 0 );
+    char path[] = "/tmp/libhashXXXXXX";
+    HashingBase &hash = crc;
+    uint8_t expected[ 4 ];
+    uint8_t result[ 4 ];
+    int fd = mkstemp( path );
+    bool ok = fd >= 0;
+
+    for( int i = 0; i < sizeof ( offsets ) / sizeof ( size_t ); i++ ) {
+        for( size_t j = 0; j < 7000; j++ ) {
+            data[ offsets[ i ] + j ] = (uint8_t) ( ( j * 2654435761u ) >> 13 );
+        }
+
+        ok = ok && pwrite( fd, data.data( ) + offsets[ i ], 7000, offsets[ i ] ) == 7000;
+    }
+
+    ok = ok && ftruncate( fd, size ) == 0;
+
+    hash.init( );
+    hash.update( data.data( ), size );
+    hash.finalize( );
+    hash.getValue( expected, sizeof ( expected ) );
+
+    hash.init( );
+    ok = ok && crc.updateFile( fd );
+    hash.finalize( );
+    hash.getValue( result, sizeof ( result ) );
+
+    if( fd >= 0 ) {
+        close( fd );
+        unlink( path );
+    }
+
+    if( ! ok || memcmp( result, expected, sizeof ( result ) ) != 0 ) {
+        std::string msg;
+
+        msg += name;
+        msg += " File test failed";
+        CPPUNIT_FAIL( msg );
+    }
+}
+
+/**
+ * Checks a CRC instantiated from the generic engine against its catalogued check value
+ * (CRC of "123456789"), then checks that the sliced and the byte-at-a-time paths agree.
+ */
+static void runTemplate32( CRC32Base &crc, const char *name, uint32_t check ) {
+    const char *digits = "123456789";
+    uint8_t data[ 1000 ];
+    uint8_t whole[ 4 ];
+    uint8_t value[ 4 ];
+
+    if( crc32Value( crc, digits, 9 ) != check ) {
+        std::string msg;
+
+        msg += name;
+        msg += " check value failed";
+        CPPUNIT_FAIL( msg );
+    }
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        data[ i ] = (uint8_t) ( i * 7 + 3 );
+    }
+
+    crc.init( );
+    crc.update( data, sizeof ( data ) );
+    crc.finalize( );
+    crc.getValue( whole, sizeof ( whole ) );
+    crc.init( );
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        crc.update( data + i, 1 );
+    }
+
+    crc.finalize( );
+    crc.getValue( value, sizeof ( value ) );
+
+    if( memcmp( value, whole, sizeof ( value ) ) != 0 ) {
+        std::string msg;
+
+        msg += name;
+        msg += " byte-at-a-time test failed";
+        CPPUNIT_FAIL( msg );
+    }
+}
+
 void libHashTestCases::testCRC32( ) {
     CRC32 crc32;
 
@@ -65,3 +234,53 @@ void libHashTestCases::testCRC32C( ) {
         runMultiChunk( 11 + i, crc32, "CRC-32", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].crc32c );
     }
 }
+
+void libHashTestCases::testCRC32Combine( ) {
+    CRC32 crc32;
+    CRC32_BZip2 crc32_bzip2;
+    CRC32C crc32c;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runCombine32( i + 1, crc32, "CRC-32", testCases[i].data, testCases[i].size, testCases[i].crc32 );
+        runCombine32( i + 1, crc32_bzip2, "CRC-32-BZIP2", testCases[i].data, testCases[i].size, testCases[i].crc32bzip2 );
+        runCombine32( i + 1, crc32c, "CRC-32C", testCases[i].data, testCases[i].size, testCases[i].crc32c );
+    }
+}
+
+void libHashTestCases::testCRC32Parallel( ) {
+    size_t size = 8 * 1024 * 1024 + 13;
+    std::vector<uint8_t> data( size );
+    CRC32 crc32;
+    CRC32_BZip2 crc32_bzip2;
+    CRC32C crc32c;
+
+    for( size_t i = 0; i < size; i++ ) {
+        data[ i ] = (uint8_t) ( ( i * 2654435761u ) >> 13 );
+    }
+
+    runParallel32( crc32, "CRC-32", data.data( ), size );
+    runParallel32( crc32_bzip2, "CRC-32-BZIP2", data.data( ), size );
+    runParallel32( crc32c, "CRC-32C", data.data( ), size );
+}
+
+void libHashTestCases::testCRC32File( ) {
+    CRC32 crc32;
+    CRC32_BZip2 crc32_bzip2;
+    CRC32C crc32c;
+
+    runFile32( crc32, "CRC-32" );
+    runFile32( crc32_bzip2, "CRC-32-BZIP2" );
+    runFile32( crc32c, "CRC-32C" );
+}
+
+void libHashTestCases::testCRC32Template( ) {
+    Crc<32, 0x04c11db7, 0xffffffff, 0x00000000, false, false> crc0;
+    Crc<32, 0x04c11db7, 0x00000000, 0xffffffff, false, false> crc1;
+    Crc<32, 0x04c11db7, 0xffffffff, 0x00000000, true, true> crc2;
+    Crc<32, 0x814141ab, 0x00000000, 0x00000000, false, false> crc3;
+
+    runTemplate32( crc0, "CRC-32-MPEG2", 0x0376e6e7 );
+    runTemplate32( crc1, "CRC-32-POSIX", 0x765e7680 );
+    runTemplate32( crc2, "CRC-32-JAMCRC", 0x340bc6d9 );
+    runTemplate32( crc3, "CRC-32Q", 0x3010bf7f );
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2017-19 Yanick Poirier <ypoirier at hotmail.com>.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston,
+ * MA 02110-1301  USA
+ */
+
+/*
+ * File:   CRC64Tests.cpp
+ * Author: Yanick Poirier <ypoirier at hotmail.com>
+ *
+ * Created on 2019-11-16, 10:12:41
+ */
+
+#include <libhash/libhash.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <vector>
+#include "libHashTestCases.h"
+
+using namespace libhash;
+
+/**
+ * Computes the final CRC-64 value of a buffer as an integer.
+ */
+static uint64_t crc64Value( HashingBase &hash, const char *data, uint32_t size ) {
+    uint8_t value[ 8 ];
+    uint64_t crc = 0;
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( value, sizeof ( value ) );
+
+    for( int i = 0; i < 8; i++ ) {
+        crc = ( crc << 8 ) | value[ i ];
+    }
+
+    return crc;
+}
+
+/**
+ * Splits the data at a few points and checks that combining the CRC of both parts gives
+ * the CRC of the whole data.
+ */
+static void runCombine64( int testNo, CRC64Base &crc, const char *name, const char *data, uint32_t size, uint8_t expected[] ) {
+    uint64_t whole = 0;
+    uint32_t splits[] = { 0, 1, size / 3, size / 2, size - 1, size };
+
+    for( int i = 0; i < 8; i++ ) {
+        whole = ( whole << 8 ) | expected[ i ];
+    }
+
+    for( int i = 0; i < sizeof ( splits ) / sizeof ( uint32_t ); i++ ) {
+        uint32_t split = splits[ i ] > size ? size : splits[ i ];
+        uint64_t crcA = crc64Value( crc, data, split );
+        uint64_t crcB = crc64Value( crc, data + split, size - split );
+
+        if( crc.combine( crcA, crcB, size - split ) != whole ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Combine test #";
+            msg += std::to_string( testNo );
+            msg += " failed at offset ";
+            msg += std::to_string( split );
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Checks that updateParallel() gives the same CRC as update() for any number of threads,
+ * including when the CRC register does not start from its initial value.
+ */
+static void runParallel64( CRC64Base &crc, const char *name, const uint8_t *data, size_t size ) {
+    HashingBase &hash = crc;
+    uint8_t expected[ 8 ];
+    uint8_t result[ 8 ];
+
+    hash.init( );
+    hash.update( data, size );
+    hash.finalize( );
+    hash.getValue( expected, sizeof ( expected ) );
+
+    for( unsigned threads = 0; threads <= 8; threads++ ) {
+        hash.init( );
+        hash.update( data, 3 );
+        crc.updateParallel( data + 3, size - 3, threads );
+        hash.finalize( );
+        hash.getValue( result, sizeof ( result ) );
+
+        if( memcmp( result, expected, sizeof ( result ) ) != 0 ) {
+            std::string msg;
+
+            msg += name;
+            msg += " Parallel test failed with ";
+            msg += std::to_string( threads );
+            msg += " threads";
+            CPPUNIT_FAIL( msg );
+        }
+    }
+}
+
+/**
+ * Writes a sparse file with a few data blocks and checks that updateFile() gives the same
+ * CRC as update() on the whole content, holes included.
+ */
+static void runFile64( CRC64Base &crc, const char *name ) {
+    size_t size = 8 * 1024 * 1024 + 7;
+    size_t offsets[] = { 0, 3 * 1024 * 1024 + 100, 5 * 1024 * 1024 };
+    std::vector<uint8_t> data( size, 0 );
+    char path[] = "/tmp/libhashXXXXXX";
+    HashingBase &hash = crc;
+    uint8_t expected[ 8 ];
+    uint8_t result[ 8 ];
+    int fd = mkstemp( path );
+    bool ok = fd >= 0;
+
+    for( int i = 0; i < sizeof ( offsets ) / sizeof ( size_t ); i++ ) {
+        for( size_t j = 0; j < 7000; j++ ) {
+            data[ offsets[ i ] + j ] = (uint8_t) ( ( j * 2654435761u ) >> 13 );
+        }
+
+        ok = ok && pwrite( fd, data.data( ) + offsets[ i ], 7000, offsets[ i ] ) == 7000;
+    }
+
+    ok = ok && ftruncate( fd, size ) == 0;
+
+    hash.init( );
+    hash.update( data.data( ), size );
+    hash.finalize( );
+    hash.getValue( expected, sizeof ( expected ) );
+
+    hash.init( );
+    ok = ok && crc.updateFile( fd );
+    hash.finalize( );
+    hash.getValue( result, sizeof ( result ) );
+
+    if( fd >= 0 ) {
+        close( fd );
+        unlink( path );
+    }
+
+    if( ! ok || memcmp( result, expected, sizeof ( result ) ) != 0 ) {
+        std::string msg;
+
+        msg += name;
+        msg += " File test failed";
+        CPPUNIT_FAIL( msg );
+    }
+}
+
+/**
+ * Checks a CRC instantiated from the generic engine against its catalogued check value
+ * (CRC of "123456789"), then checks that the sliced and the byte-at-a-time paths agree.
+ */
+static void runTemplate64( CRC64Base &crc, const char *name, uint64_t check ) {
+    const char *digits = "123456789";
+    uint8_t data[ 1000 ];
+    uint8_t whole[ 8 ];
+    uint8_t value[ 8 ];
+
+    if( crc64Value( crc, digits, 9 ) != check ) {
+        std::string msg;
+
+        msg += name;
+        msg += " check value failed";
+        CPPUNIT_FAIL( msg );
+    }
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        data[ i ] = (uint8_t) ( i * 7 + 3 );
+    }
+
+    crc.init( );
+    crc.update( data, sizeof ( data ) );
+    crc.finalize( );
+    crc.getValue( whole, sizeof ( whole ) );
+    crc.init( );
+
+    for( int i = 0; i < sizeof ( data ); i++ ) {
+        crc.update( data + i, 1 );
+    }
+
+    crc.finalize( );
+    crc.getValue( value, sizeof ( value ) );
+
+    if( memcmp( value, whole, sizeof ( value ) ) != 0 ) {
+        std::string msg;
+
+        msg += name;
+        msg += " byte-at-a-time test failed";
+        CPPUNIT_FAIL( msg );
+    }
+}
+
+void libHashTestCases::testCRC64_ECMA182( ) {
+    CRC64_ECMA182 crc64;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runSingleChunk( i + 1, crc64, "CRC-64-ECMA", testCases[i].data, testCases[i].size, testCases[i].crc64ecma );
+    }
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runMultiChunk( 11 + i, crc64, "CRC-64-ECMA", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].crc64ecma );
+    }
+}
+
+void libHashTestCases::testCRC64_XZ( ) {
+    CRC64_XZ crc64;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runSingleChunk( i + 1, crc64, "CRC-64-XZ", testCases[i].data, testCases[i].size, testCases[i].crc64xz );
+    }
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runMultiChunk( 11 + i, crc64, "CRC-64-XZ", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].crc64xz );
+    }
+}
+
+void libHashTestCases::testCRC64_NVMe( ) {
+    CRC64_NVMe crc64;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runSingleChunk( i + 1, crc64, "CRC-64-NVME", testCases[i].data, testCases[i].size, testCases[i].crc64nvme );
+    }
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runMultiChunk( 11 + i, crc64, "CRC-64-NVME", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].crc64nvme );
+    }
+}
+
+void libHashTestCases::testCRC64Combine( ) {
+    CRC64_ECMA182 crc64_ecma;
+    CRC64_XZ crc64_xz;
+    CRC64_NVMe crc64_nvme;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runCombine64( i + 1, crc64_ecma, "CRC-64-ECMA", testCases[i].data, testCases[i].size, testCases[i].crc64ecma );
+        runCombine64( i + 1, crc64_xz, "CRC-64-XZ", testCases[i].data, testCases[i].size, testCases[i].crc64xz );
+        runCombine64( i + 1, crc64_nvme, "CRC-64-NVME", testCases[i].data, testCases[i].size, testCases[i].crc64nvme );
+    }
+}
+
+void libHashTestCases::testCRC64Parallel( ) {
+    size_t size = 8 * 1024 * 1024 + 13;
+    std::vector<uint8_t> data( size );
+    CRC64_ECMA182 crc64_ecma;
+    CRC64_XZ crc64_xz;
+    CRC64_NVMe crc64_nvme;
+
+    for( size_t i = 0; i < size; i++ ) {
+        data[ i ] = (uint8_t) ( ( i * 2654435761u ) >> 13 );
+    }
+
+    runParallel64( crc64_ecma, "CRC-64-ECMA", data.data( ), size );
+    runParallel64( crc64_xz, "CRC-64-XZ", data.data( ), size );
+    runParallel64( crc64_nvme, "CRC-64-NVME", data.data( ), size );
+}
+
+void libHashTestCases::testCRC64File( ) {
+    CRC64_ECMA182 crc64_ecma;
+    CRC64_XZ crc64_xz;
+    CRC64_NVMe crc64_nvme;
+
+    runFile64( crc64_ecma, "CRC-64-ECMA" );
+    runFile64( crc64_xz, "CRC-64-XZ" );
+    runFile64( crc64_nvme, "CRC-64-NVME" );
+}
+
+void libHashTestCases::testCRC64Template( ) {
+    Crc<64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, false, false> crc0;
+    Crc<64, 0x000000000000001b, 0xffffffffffffffff, 0xffffffffffffffff, true, true> crc1;
+    Crc<64, 0xad93d23594c935a9, 0x0000000000000000, 0x0000000000000000, true, true> crc2;
+
+    runTemplate64( crc0, "CRC-64-WE", 0x62ec59e3f1a4f00a );
+    runTemplate64( crc1, "CRC-64-GO-ISO", 0xb90956c775a41001 );
+    runTemplate64( crc2, "CRC-64-REDIS", 0xe9c6d914c4b8d9ca );
+}
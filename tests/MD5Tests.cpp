@@ -42,3 +42,24 @@ void libHashTestCases::testMD5( ) {
     }
 }
 
+void libHashTestCases::testMD5Batch( ) {
+    MD5 md5;
+    const void *data[ 5 ];
+    size_t sizes[ 5 ];
+    uint8_t digests[ 5 ][ 16 ];
+
+    runBatch( md5, "MD5", MD5::batch );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        data[ i ] = testCases[ i + 1 ].data;
+        sizes[ i ] = testCases[ i + 1 ].size;
+    }
+
+    ::memset( digests, 0, sizeof ( digests ) );
+    CPPUNIT_ASSERT_MESSAGE( "MD5 batch C API", hash_md5_batch( data, sizes, 5, digests[ 0 ] ) == 1 );
+    CPPUNIT_ASSERT_MESSAGE( "MD5 batch C API NULL", hash_md5_batch( NULL, sizes, 5, digests[ 0 ] ) == 0 );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        CPPUNIT_ASSERT_MESSAGE( "MD5 batch C API", ::memcmp( digests[ i ], testCases[ i + 1 ].md5, 16 ) == 0 );
+    }
+}
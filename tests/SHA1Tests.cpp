@@ -42,3 +42,25 @@ void libHashTestCases::testSHA1( ) {
     }
 }
 
+
+void libHashTestCases::testSHA1Batch( ) {
+    SHA1 sha1;
+    const void *data[ 5 ];
+    size_t sizes[ 5 ];
+    uint8_t digests[ 5 ][ 20 ];
+
+    runBatch( sha1, "SHA-1", SHA1::batch );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        data[ i ] = testCases[ i + 1 ].data;
+        sizes[ i ] = testCases[ i + 1 ].size;
+    }
+
+    ::memset( digests, 0, sizeof ( digests ) );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch C API", hash_sha1_batch( data, sizes, 5, digests[ 0 ] ) == 1 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch C API NULL", hash_sha1_batch( NULL, sizes, 5, digests[ 0 ] ) == 0 );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-1 batch C API", ::memcmp( digests[ i ], testCases[ i + 1 ].sha1, 20 ) == 0 );
+    }
+}
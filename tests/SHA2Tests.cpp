@@ -54,6 +54,28 @@ void libHashTestCases::testSHA2_256( ) {
     }
 }
 
+void libHashTestCases::testSHA2_256Batch( ) {
+    SHA2_256 sha2;
+    const void *data[ 5 ];
+    size_t sizes[ 5 ];
+    uint8_t digests[ 5 ][ 32 ];
+
+    runBatch( sha2, "SHA-2 256-bits", SHA2_256::batch );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        data[ i ] = testCases[ i + 1 ].data;
+        sizes[ i ] = testCases[ i + 1 ].size;
+    }
+
+    ::memset( digests, 0, sizeof ( digests ) );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-2 256-bits batch C API", hash_sha2_256_batch( data, sizes, 5, digests[ 0 ] ) == 1 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-2 256-bits batch C API NULL", hash_sha2_256_batch( NULL, sizes, 5, digests[ 0 ] ) == 0 );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-2 256-bits batch C API", ::memcmp( digests[ i ], testCases[ i + 1 ].sha2_256, 32 ) == 0 );
+    }
+}
+
 void libHashTestCases::testSHA2_384( ) {
     SHA2_384 sha2;
 
@@ -78,3 +100,49 @@ void libHashTestCases::testSHA2_512( ) {
     }
 }
 
+void libHashTestCases::testSHA2_512Batch( ) {
+    SHA2_512 sha2;
+    const void *data[ 5 ];
+    size_t sizes[ 5 ];
+    uint8_t digests[ 5 ][ 64 ];
+
+    runBatch( sha2, "SHA-2 512-bits", SHA2_512::batch );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        data[ i ] = testCases[ i + 1 ].data;
+        sizes[ i ] = testCases[ i + 1 ].size;
+    }
+
+    ::memset( digests, 0, sizeof ( digests ) );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-2 512-bits batch C API", hash_sha2_512_batch( data, sizes, 5, digests[ 0 ] ) == 1 );
+    CPPUNIT_ASSERT_MESSAGE( "SHA-2 512-bits batch C API NULL", hash_sha2_512_batch( NULL, sizes, 5, digests[ 0 ] ) == 0 );
+
+    for( size_t i = 0; i < 5; i++ ) {
+        CPPUNIT_ASSERT_MESSAGE( "SHA-2 512-bits batch C API", ::memcmp( digests[ i ], testCases[ i + 1 ].sha2_512, 64 ) == 0 );
+    }
+}
+
+void libHashTestCases::testSHA2_512_224( ) {
+    SHA2_512_224 sha2;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runSingleChunk( i + 1, sha2, "SHA-2 512/224-bits", testCases[i].data, testCases[i].size, testCases[i].sha2_512_224 );
+    }
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runMultiChunk( 11 + i, sha2, "SHA-2 512/224-bits", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].sha2_512_224 );
+    }
+}
+
+void libHashTestCases::testSHA2_512_256( ) {
+    SHA2_512_256 sha2;
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runSingleChunk( i + 1, sha2, "SHA-2 512/256-bits", testCases[i].data, testCases[i].size, testCases[i].sha2_512_256 );
+    }
+
+    for( int i = 0; i < sizeof ( testCases ) / sizeof ( TestData ); i++ ) {
+        runMultiChunk( 11 + i, sha2, "SHA-2 512/256-bits", testCases[i].data, testCases[i].size, ( testCases[i].size * 0.13 ) + 1, testCases[i].sha2_512_256 );
+    }
+}
+
@@ -26,6 +26,8 @@
 
 #include <libhash/libhash.h>
 #include <string.h>
+#include <algorithm>
+#include <vector>
 #include "libHashTestCases.h"
 
 using namespace libhash;
@@ -48,6 +50,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x00, 0x00, 0x00, 0x00 },
         // CRC-32C
         { 0x00, 0x00, 0x00, 0x00 },
+        // CRC-64-ECMA
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        // CRC-64-XZ
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        // CRC-64-NVME
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
         // MD5
         { 0xd4, 0x1d, 0x8c, 0xd9, 0x8f, 0x00, 0xb2, 0x04,
             0xe9, 0x80, 0x09, 0x98, 0xec, 0xf8, 0x42, 0x7e },
@@ -79,7 +87,17 @@ TestData libHashTestCases::testCases[] = {
             0x47, 0xd0, 0xd1, 0x3c, 0x5d, 0x85, 0xf2, 0xb0,
             0xff, 0x83, 0x18, 0xd2, 0x87, 0x7e, 0xec, 0x2f,
             0x63, 0xb9, 0x31, 0xbd, 0x47, 0x41, 0x7a, 0x81,
-            0xa5, 0x38, 0x32, 0x7a, 0xf9, 0x27, 0xda, 0x3e }
+            0xa5, 0x38, 0x32, 0x7a, 0xf9, 0x27, 0xda, 0x3e },
+        // SHA2-512/224
+        { 0x6e, 0xd0, 0xdd, 0x02, 0x80, 0x6f, 0xa8, 0x9e,
+            0x25, 0xde, 0x06, 0x0c, 0x19, 0xd3, 0xac, 0x86,
+            0xca, 0xbb, 0x87, 0xd6, 0xa0, 0xdd, 0xd0, 0x5c,
+            0x33, 0x3b, 0x84, 0xf4 },
+        // SHA2-512/256
+        { 0xc6, 0x72, 0xb8, 0xd1, 0xef, 0x56, 0xed, 0x28,
+            0xab, 0x87, 0xc3, 0x62, 0x2c, 0x51, 0x14, 0x06,
+            0x9b, 0xdd, 0x3a, 0xd7, 0xb8, 0xf9, 0x73, 0x74,
+            0x98, 0xd0, 0xc0, 0x1e, 0xce, 0xf0, 0x96, 0x7a }
     },
 
     // Test #2
@@ -97,6 +115,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x19, 0x93, 0x9b, 0x6b },
         // CRC-32C
         { 0xc1, 0xd0, 0x43, 0x30 },
+        // CRC-64-ECMA
+        { 0x54, 0x8f, 0x12, 0x01, 0x62, 0x45, 0x1c, 0x62 },
+        // CRC-64-XZ
+        { 0x33, 0x02, 0x84, 0x77, 0x2e, 0x65, 0x2b, 0x05 },
+        // CRC-64-NVME
+        { 0x8c, 0x2f, 0x84, 0x45, 0xb4, 0xcb, 0xfc, 0x3c },
         // MD5
         { 0x0c, 0xc1, 0x75, 0xb9, 0xc0, 0xf1, 0xb6, 0xa8,
             0x31, 0xc3, 0x99, 0xe2, 0x69, 0x77, 0x26, 0x61 },
@@ -128,7 +152,17 @@ TestData libHashTestCases::testCases[] = {
             0x02, 0x86, 0x0c, 0x65, 0x2b, 0xf0, 0x8d, 0x56,
             0x02, 0x52, 0xaa, 0x5e, 0x74, 0x21, 0x05, 0x46,
             0xf3, 0x69, 0xfb, 0xbb, 0xce, 0x8c, 0x12, 0xcf,
-            0xc7, 0x95, 0x7b, 0x26, 0x52, 0xfe, 0x9a, 0x75 }
+            0xc7, 0x95, 0x7b, 0x26, 0x52, 0xfe, 0x9a, 0x75 },
+        // SHA2-512/224
+        { 0xd5, 0xcd, 0xb9, 0xcc, 0xc7, 0x69, 0xa5, 0x12,
+            0x1d, 0x41, 0x75, 0xf2, 0xbf, 0xdd, 0x13, 0xd6,
+            0x31, 0x0e, 0x0d, 0x3d, 0x36, 0x1e, 0xa7, 0x5d,
+            0x82, 0x10, 0x83, 0x27 },
+        // SHA2-512/256
+        { 0x45, 0x5e, 0x51, 0x88, 0x24, 0xbc, 0x06, 0x01,
+            0xf9, 0xfb, 0x85, 0x8f, 0xf5, 0xc3, 0x7d, 0x41,
+            0x7d, 0x67, 0xc2, 0xf8, 0xe0, 0xdf, 0x2b, 0xab,
+            0xe4, 0x80, 0x88, 0x58, 0xae, 0xa8, 0x30, 0xf8 }
     },
 
     // Test #3
@@ -146,6 +180,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x64, 0x8c, 0xbb, 0x73 },
         // CRC-32C
         { 0x36, 0x4b, 0x3f, 0xb7 },
+        // CRC-64-ECMA
+        { 0x66, 0x50, 0x1a, 0x34, 0x9a, 0x0e, 0x08, 0x55 },
+        // CRC-64-XZ
+        { 0x2c, 0xd8, 0x09, 0x4a, 0x1a, 0x27, 0x76, 0x27 },
+        // CRC-64-NVME
+        { 0x05, 0xe5, 0xca, 0xbb, 0x3f, 0xc1, 0xfa, 0xeb },
         // MD5
         { 0x90, 0x01, 0x50, 0x98, 0x3c, 0xd2, 0x4f, 0xb0,
             0xd6, 0x96, 0x3f, 0x7d, 0x28, 0xe1, 0x7f, 0x72 },
@@ -177,7 +217,17 @@ TestData libHashTestCases::testCases[] = {
             0x21, 0x92, 0x99, 0x2a, 0x27, 0x4f, 0xc1, 0xa8,
             0x36, 0xba, 0x3c, 0x23, 0xa3, 0xfe, 0xeb, 0xbd,
             0x45, 0x4d, 0x44, 0x23, 0x64, 0x3c, 0xe8, 0x0e,
-            0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f }
+            0x2a, 0x9a, 0xc9, 0x4f, 0xa5, 0x4c, 0xa4, 0x9f },
+        // SHA2-512/224
+        { 0x46, 0x34, 0x27, 0x0f, 0x70, 0x7b, 0x6a, 0x54,
+            0xda, 0xae, 0x75, 0x30, 0x46, 0x08, 0x42, 0xe2,
+            0x0e, 0x37, 0xed, 0x26, 0x5c, 0xee, 0xe9, 0xa4,
+            0x3e, 0x89, 0x24, 0xaa },
+        // SHA2-512/256
+        { 0x53, 0x04, 0x8e, 0x26, 0x81, 0x94, 0x1e, 0xf9,
+            0x9b, 0x2e, 0x29, 0xb7, 0x6b, 0x4c, 0x7d, 0xab,
+            0xe4, 0xc2, 0xd0, 0xc6, 0x34, 0xfc, 0x6d, 0x46,
+            0xe0, 0xe2, 0xf1, 0x31, 0x07, 0xe7, 0xaf, 0x23 }
     },
 
     // Test #4
@@ -195,6 +245,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x1d, 0x6e, 0x46, 0xc5 },
         // CRC-32C
         { 0x07, 0x13, 0x25, 0xf5 },
+        // CRC-64-ECMA
+        { 0x29, 0xd1, 0x83, 0x01, 0xfe, 0x33, 0xca, 0x5d },
+        // CRC-64-XZ
+        { 0x9f, 0x44, 0x6c, 0x74, 0xe3, 0xdc, 0x7c, 0x4b },
+        // CRC-64-NVME
+        { 0xf0, 0x1a, 0x77, 0x1d, 0xe9, 0x1f, 0x90, 0xd4 },
         // MD5
         { 0x82, 0x15, 0xef, 0x07, 0x96, 0xa2, 0x0b, 0xca,
             0xaa, 0xe1, 0x16, 0xd3, 0x87, 0x6c, 0x66, 0x4a },
@@ -226,7 +282,17 @@ TestData libHashTestCases::testCases[] = {
             0x96, 0xfd, 0x15, 0xc1, 0x3b, 0x1b, 0x07, 0xf9,
             0xaa, 0x1d, 0x3b, 0xea, 0x57, 0x78, 0x9c, 0xa0,
             0x31, 0xad, 0x85, 0xc7, 0xa7, 0x1d, 0xd7, 0x03,
-            0x54, 0xec, 0x63, 0x12, 0x38, 0xca, 0x34, 0x45 }
+            0x54, 0xec, 0x63, 0x12, 0x38, 0xca, 0x34, 0x45 },
+        // SHA2-512/224
+        { 0xe5, 0x30, 0x2d, 0x6d, 0x54, 0xbb, 0x24, 0x22,
+            0x75, 0xd1, 0xe7, 0x62, 0x2d, 0x68, 0xdf, 0x6e,
+            0xb0, 0x2d, 0xed, 0xd1, 0x3f, 0x56, 0x4c, 0x13,
+            0xdb, 0xda, 0x21, 0x74 },
+        // SHA2-512/256
+        { 0xbd, 0xe8, 0xe1, 0xf9, 0xf1, 0x9b, 0xb9, 0xfd,
+            0x34, 0x06, 0xc9, 0x0e, 0xc6, 0xbc, 0x47, 0xbd,
+            0x36, 0xd8, 0xad, 0xa9, 0xf1, 0x18, 0x80, 0xdb,
+            0xc8, 0xa2, 0x2a, 0x70, 0x78, 0xb6, 0xa4, 0x61 }
     },
 
     // Test #5
@@ -244,6 +310,12 @@ TestData libHashTestCases::testCases[] = {
         { 0xb7, 0x05, 0x51, 0x3b },
         // CRC-32C
         { 0x3f, 0x60, 0xa4, 0xb9 },
+        // CRC-64-ECMA
+        { 0x86, 0x75, 0x1d, 0xf1, 0xed, 0xd9, 0xa6, 0x21 },
+        // CRC-64-XZ
+        { 0x94, 0xf9, 0xd9, 0x2d, 0x3e, 0x22, 0xbf, 0xc9 },
+        // CRC-64-NVME
+        { 0x59, 0x96, 0xcf, 0xfb, 0x81, 0x5c, 0x32, 0x91 },
         // MD5
         { 0x03, 0xdd, 0x88, 0x07, 0xa9, 0x31, 0x75, 0xfb,
             0x06, 0x2d, 0xfb, 0x55, 0xdc, 0x7d, 0x35, 0x9c },
@@ -275,7 +347,17 @@ TestData libHashTestCases::testCases[] = {
             0x50, 0x1d, 0x28, 0x9e, 0x49, 0x00, 0xf7, 0xe4,
             0x33, 0x1b, 0x99, 0xde, 0xc4, 0xb5, 0x43, 0x3a,
             0xc7, 0xd3, 0x29, 0xee, 0xb6, 0xdd, 0x26, 0x54,
-            0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09 }
+            0x5e, 0x96, 0xe5, 0x5b, 0x87, 0x4b, 0xe9, 0x09 },
+        // SHA2-512/224
+        { 0x23, 0xfe, 0xc5, 0xbb, 0x94, 0xd6, 0x0b, 0x23,
+            0x30, 0x81, 0x92, 0x64, 0x0b, 0x0c, 0x45, 0x33,
+            0x35, 0xd6, 0x64, 0x73, 0x4f, 0xe4, 0x0e, 0x72,
+            0x68, 0x67, 0x4a, 0xf9 },
+        // SHA2-512/256
+        { 0x39, 0x28, 0xe1, 0x84, 0xfb, 0x86, 0x90, 0xf8,
+            0x40, 0xda, 0x39, 0x88, 0x12, 0x1d, 0x31, 0xbe,
+            0x65, 0xcb, 0x9d, 0x3e, 0xf8, 0x3e, 0xe6, 0x14,
+            0x6f, 0xea, 0xc8, 0x61, 0xe1, 0x9b, 0x56, 0x3a }
     },
 
     // Test #6
@@ -293,6 +375,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x77, 0xbf, 0x93, 0x96 },
         // CRC-32C
         { 0x9e, 0xe6, 0xef, 0x25 },
+        // CRC-64-ECMA
+        { 0x97, 0xa2, 0x56, 0x6b, 0x55, 0x2f, 0xcc, 0x4e },
+        // CRC-64-XZ
+        { 0x26, 0x96, 0x78, 0x75, 0x75, 0x1b, 0x12, 0x2f },
+        // CRC-64-NVME
+        { 0x1a, 0x11, 0x0d, 0x6a, 0x11, 0xfe, 0x63, 0xa8 },
         // MD5
         { 0xc3, 0xfc, 0xd3, 0xd7, 0x61, 0x92, 0xe4, 0x00,
             0x7d, 0xfb, 0x49, 0x6c, 0xca, 0x67, 0xe1, 0x3b },
@@ -324,7 +412,17 @@ TestData libHashTestCases::testCases[] = {
             0x95, 0x5a, 0x1b, 0xf8, 0xec, 0x48, 0x3d, 0x74,
             0x21, 0xfe, 0x3c, 0x16, 0x46, 0x61, 0x3a, 0x59,
             0xed, 0x54, 0x41, 0xfb, 0x0f, 0x32, 0x13, 0x89,
-            0xf7, 0x7f, 0x48, 0xa8, 0x79, 0xc7, 0xb1, 0xf1 }
+            0xf7, 0x7f, 0x48, 0xa8, 0x79, 0xc7, 0xb1, 0xf1 },
+        // SHA2-512/224
+        { 0xff, 0x83, 0x14, 0x8a, 0xa0, 0x7e, 0xc3, 0x06,
+            0x55, 0xc1, 0xb4, 0x0a, 0xff, 0x86, 0x14, 0x1c,
+            0x02, 0x15, 0xfe, 0x2a, 0x54, 0xf7, 0x67, 0xd3,
+            0xf3, 0x87, 0x43, 0xd8 },
+        // SHA2-512/256
+        { 0xfc, 0x31, 0x89, 0x44, 0x3f, 0x9c, 0x26, 0x8f,
+            0x62, 0x6a, 0xea, 0x08, 0xa7, 0x56, 0xab, 0xe7,
+            0xb7, 0x26, 0xb0, 0x5f, 0x70, 0x1c, 0xb0, 0x82,
+            0x22, 0x31, 0x2c, 0xcf, 0xd6, 0x71, 0x0a, 0x26 }
     },
 
     // Test #7
@@ -342,6 +440,12 @@ TestData libHashTestCases::testCases[] = {
         { 0xa0, 0x74, 0x21, 0x88 },
         // CRC-32C
         { 0xa2, 0x45, 0xd5, 0x7d },
+        // CRC-64-ECMA
+        { 0x5c, 0xa1, 0x85, 0x85, 0xb9, 0x2c, 0x58, 0xb9 },
+        // CRC-64-XZ
+        { 0x03, 0x05, 0xbf, 0xe1, 0x16, 0xb7, 0x56, 0x26 },
+        // CRC-64-NVME
+        { 0x8b, 0x8f, 0x30, 0xcf, 0xc6, 0xf1, 0x64, 0x09 },
         // MD5
         { 0xd1, 0x74, 0xab, 0x98, 0xd2, 0x77, 0xd9, 0xf5,
             0xa5, 0x61, 0x1c, 0x2c, 0x9f, 0x41, 0x9d, 0x9f },
@@ -373,7 +477,17 @@ TestData libHashTestCases::testCases[] = {
             0x5c, 0x83, 0x70, 0x58, 0x3e, 0x0a, 0x78, 0xfa,
             0x4a, 0x90, 0x04, 0x1d, 0x71, 0xa4, 0xce, 0xab,
             0x74, 0x23, 0xf1, 0x9c, 0x71, 0xb9, 0xd5, 0xa3,
-            0xe0, 0x12, 0x49, 0xf0, 0xbe, 0xbd, 0x58, 0x94 }
+            0xe0, 0x12, 0x49, 0xf0, 0xbe, 0xbd, 0x58, 0x94 },
+        // SHA2-512/224
+        { 0xa8, 0xb4, 0xb9, 0x17, 0x4b, 0x99, 0xff, 0xc6,
+            0x7d, 0x6f, 0x49, 0xbe, 0x99, 0x81, 0x58, 0x7b,
+            0x96, 0x44, 0x10, 0x51, 0xe1, 0x6e, 0x6d, 0xd0,
+            0x36, 0xb1, 0x40, 0xd3 },
+        // SHA2-512/256
+        { 0xcd, 0xf1, 0xcc, 0x0e, 0xff, 0xe2, 0x6e, 0xcc,
+            0x0c, 0x13, 0x75, 0x8f, 0x7b, 0x4a, 0x48, 0xe0,
+            0x00, 0x61, 0x5d, 0xf2, 0x41, 0x28, 0x41, 0x85,
+            0xc3, 0x9e, 0xb0, 0x5d, 0x35, 0x5b, 0xb9, 0xc8 }
     },
 
     // Test #8
@@ -391,6 +505,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x16, 0x08, 0x79, 0x96 },
         // CRC-32C
         { 0x47, 0x7a, 0x67, 0x81 },
+        // CRC-64-ECMA
+        { 0xbe, 0x4c, 0x46, 0x26, 0x37, 0x74, 0x95, 0x3c },
+        // CRC-64-XZ
+        { 0xae, 0x22, 0x0a, 0x5d, 0x76, 0xb7, 0x3e, 0xbd },
+        // CRC-64-NVME
+        { 0x24, 0x09, 0x8f, 0x68, 0x74, 0xd9, 0x88, 0x32 },
         // MD5
         { 0x57, 0xed, 0xf4, 0xa2, 0x2b, 0xe3, 0xc9, 0x55,
             0xac, 0x49, 0xda, 0x2e, 0x21, 0x07, 0xb6, 0x7a },
@@ -422,7 +542,17 @@ TestData libHashTestCases::testCases[] = {
             0x23, 0x54, 0xe0, 0x93, 0xd7, 0x6f, 0x30, 0x48,
             0xb4, 0x56, 0x76, 0x43, 0x46, 0x90, 0x0c, 0xb1,
             0x30, 0xd2, 0xa4, 0xfd, 0x5d, 0xd1, 0x6a, 0xbb,
-            0x5e, 0x30, 0xbc, 0xb8, 0x50, 0xde, 0xe8, 0x43 }
+            0x5e, 0x30, 0xbc, 0xb8, 0x50, 0xde, 0xe8, 0x43 },
+        // SHA2-512/224
+        { 0xae, 0x98, 0x8f, 0xaa, 0xa4, 0x7e, 0x40, 0x1a,
+            0x45, 0xf7, 0x04, 0xd1, 0x27, 0x2d, 0x99, 0x70,
+            0x24, 0x58, 0xfe, 0xa2, 0xdd, 0xc6, 0x58, 0x28,
+            0x27, 0x55, 0x6d, 0xd2 },
+        // SHA2-512/256
+        { 0x2c, 0x9f, 0xdb, 0xc0, 0xc9, 0x0b, 0xdd, 0x87,
+            0x61, 0x2e, 0xe8, 0x45, 0x54, 0x74, 0xf9, 0x04,
+            0x48, 0x50, 0x24, 0x1d, 0xc1, 0x05, 0xb1, 0xe8,
+            0xb9, 0x4b, 0x8d, 0xdf, 0x5f, 0xac, 0x91, 0x48 }
     },
 
     // Test #9
@@ -440,6 +570,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x97, 0xbe, 0xdc, 0x38 },
         // CRC-32C
         { 0x43, 0x6f, 0xe2, 0x40 },
+        // CRC-64-ECMA
+        { 0x33, 0x77, 0xce, 0xc7, 0xa5, 0x85, 0xe1, 0x1f },
+        // CRC-64-XZ
+        { 0x7a, 0x0d, 0x29, 0x39, 0x81, 0x12, 0xe1, 0xba },
+        // CRC-64-NVME
+        { 0x38, 0xb0, 0xef, 0x50, 0x41, 0x9e, 0x0b, 0x4c },
         // MD5
         { 0x77, 0x07, 0xd6, 0xae, 0x4e, 0x02, 0x7c, 0x70,
             0xee, 0xa2, 0xa9, 0x35, 0xc2, 0x29, 0x6f, 0x21 },
@@ -471,7 +607,17 @@ TestData libHashTestCases::testCases[] = {
             0xde, 0x0f, 0xf2, 0x44, 0x87, 0x7e, 0xa6, 0x0a,
             0x4c, 0xb0, 0x43, 0x2c, 0xe5, 0x77, 0xc3, 0x1b,
             0xeb, 0x00, 0x9c, 0x5c, 0x2c, 0x49, 0xaa, 0x2e,
-            0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b }
+            0x4e, 0xad, 0xb2, 0x17, 0xad, 0x8c, 0xc0, 0x9b },
+        // SHA2-512/224
+        { 0x37, 0xab, 0x33, 0x1d, 0x76, 0xf0, 0xd3, 0x6d,
+            0xe4, 0x22, 0xbd, 0x0e, 0xde, 0xb2, 0x2a, 0x28,
+            0xac, 0xcd, 0x48, 0x7b, 0x7a, 0x84, 0x53, 0xae,
+            0x96, 0x5d, 0xd2, 0x87 },
+        // SHA2-512/256
+        { 0x9a, 0x59, 0xa0, 0x52, 0x93, 0x01, 0x87, 0xa9,
+            0x70, 0x38, 0xca, 0xe6, 0x92, 0xf3, 0x07, 0x08,
+            0xaa, 0x64, 0x91, 0x92, 0x3e, 0xf5, 0x19, 0x43,
+            0x94, 0xdc, 0x68, 0xd5, 0x6c, 0x74, 0xfb, 0x21 }
     },
 
     // Test #10
@@ -489,6 +635,12 @@ TestData libHashTestCases::testCases[] = {
         { 0x26, 0xaa, 0xbf, 0xbf },
         // CRC-32C
         { 0xb7, 0x7a, 0x35, 0x8a },
+        // CRC-64-ECMA
+        { 0xbc, 0x19, 0x09, 0x69, 0x4c, 0x5d, 0xdc, 0x52 },
+        // CRC-64-XZ
+        { 0xd1, 0x4d, 0x2b, 0x19, 0x51, 0xc5, 0xea, 0x64 },
+        // CRC-64-NVME
+        { 0x0d, 0x44, 0x59, 0xee, 0xad, 0xc5, 0xbb, 0xf6 },
         // MD5
         { 0x3d, 0x64, 0xa4, 0x18, 0xc6, 0xe1, 0x6c, 0xbd,
             0xa4, 0x33, 0x69, 0x85, 0x18, 0x30, 0x57, 0xb2 },
@@ -520,7 +672,17 @@ TestData libHashTestCases::testCases[] = {
             0xec, 0x4b, 0xec, 0x4a, 0x31, 0xa1, 0x88, 0x8d,
             0xe8, 0x07, 0xae, 0x83, 0xc1, 0x23, 0xf9, 0x13,
             0x16, 0x3b, 0x19, 0x9b, 0x72, 0x83, 0xc2, 0x9b,
-            0x07, 0xae, 0x17, 0xe5, 0xcb, 0xf2, 0xd6, 0xdc }
+            0x07, 0xae, 0x17, 0xe5, 0xcb, 0xf2, 0xd6, 0xdc },
+        // SHA2-512/224
+        { 0xd6, 0x12, 0x44, 0x47, 0xcf, 0xcd, 0xfa, 0x30,
+            0xcc, 0x6d, 0xb7, 0xab, 0x49, 0x6c, 0xb8, 0x54,
+            0xcc, 0x57, 0xc0, 0xd7, 0xaa, 0xb5, 0x77, 0xcf,
+            0xde, 0x9c, 0xfa, 0xc4 },
+        // SHA2-512/256
+        { 0x7b, 0x72, 0x6a, 0xba, 0xab, 0x37, 0xdc, 0xef,
+            0x92, 0x82, 0x55, 0xbc, 0x88, 0xcf, 0x3e, 0x4b,
+            0xcd, 0xda, 0x33, 0xbe, 0xf6, 0x10, 0x53, 0x84,
+            0x22, 0xeb, 0x17, 0x74, 0x7c, 0x48, 0xdf, 0x14 }
     }
 };
 
@@ -658,3 +820,51 @@ void libHashTestCases::runMultiChunk( int testNo, HashingBase &hash, const char
     //    }
 }
 
+void libHashTestCases::runBatch( HashingBase &hash, const char *name, BatchFunction batch ) {
+    // Around the padding boundaries of the 64 and 128 bytes blocks
+    static const size_t lengths[] = { 0, 1, 55, 56, 57, 63, 64, 65, 111, 112, 113, 119, 120, 127, 128, 129, 255, 256, 1000 };
+    const size_t cases = sizeof ( testCases ) / sizeof ( TestData );
+    const size_t generated = sizeof ( lengths ) / sizeof ( lengths[ 0 ] );
+    const size_t count = cases * 3 + generated * 2;
+    const size_t digestSize = hash.getHashSize( ) / 8;
+    std::vector<uint8_t> buffer( 1000 + count );
+    std::vector<const void *> data( count );
+    std::vector<size_t> sizes( count );
+    std::vector<uint8_t> digests( count * digestSize );
+    std::vector<uint8_t> expected( count * digestSize );
+
+    for( size_t i = 0; i < buffer.size( ); i++ ) {
+        buffer[ i ] = (uint8_t) ( i * 131 + 7 );
+    }
+
+    // More messages than lanes, in an order mixing the lengths
+    for( size_t i = 0; i < cases * 3; i++ ) {
+        data[ i ] = testCases[ ( i * 7 ) % cases ].data;
+        sizes[ i ] = testCases[ ( i * 7 ) % cases ].size;
+    }
+
+    for( size_t i = cases * 3; i < count; i++ ) {
+        data[ i ] = buffer.data( ) + i;
+        sizes[ i ] = lengths[ ( i * 5 ) % generated ];
+    }
+
+    for( size_t i = 0; i < count; i++ ) {
+        hash.init( );
+        hash.update( data[ i ], sizes[ i ] );
+        hash.finalize( );
+        hash.getValue( expected.data( ) + i * digestSize, digestSize );
+    }
+
+    // Fewer messages than lanes, a partial last group and the whole batch
+    for( size_t n : { (size_t) 2, (size_t) 17, count } ) {
+        std::fill( digests.begin( ), digests.end( ), 0 );
+        batch( data.data( ), sizes.data( ), n, digests.data( ) );
+
+        for( size_t i = 0; i < n; i++ ) {
+            std::string msg = std::string( name ) + " batch of " + std::to_string( n ) + ", message #" + std::to_string( i + 1 )
+                    + " (" + std::to_string( sizes[ i ] ) + " bytes)";
+
+            CPPUNIT_ASSERT_MESSAGE( msg, ::memcmp( digests.data( ) + i * digestSize, expected.data( ) + i * digestSize, digestSize ) == 0 );
+        }
+    }
+}
@@ -41,29 +41,64 @@ struct TestData {
     uint8_t crc32[4];
     uint8_t crc32bzip2[4];
     uint8_t crc32c[4];
+    uint8_t crc64ecma[8];
+    uint8_t crc64xz[8];
+    uint8_t crc64nvme[8];
     uint8_t md5[16];
     uint8_t sha1[20];
     uint8_t sha2_224[28];
     uint8_t sha2_256[32];
     uint8_t sha2_384[48];
     uint8_t sha2_512[64];
+    uint8_t sha2_512_224[28];
+    uint8_t sha2_512_256[32];
 } ;
 
+/** Batch hashing function, such as SHA2_256::batch(). */
+typedef void ( *BatchFunction )( const void *const *, const size_t *, size_t, uint8_t * );
+
 class libHashTestCases : public CPPUNIT_NS::TestFixture {
     CPPUNIT_TEST_SUITE( libHashTestCases );
 
+    CPPUNIT_TEST( testCRC8Template );
     CPPUNIT_TEST( testCRC16_CCITT );
     CPPUNIT_TEST( testCRC16_XModem );
     CPPUNIT_TEST( testCRC16_X25 );
+    CPPUNIT_TEST( testCRC16Combine );
+    CPPUNIT_TEST( testCRC16Parallel );
+    CPPUNIT_TEST( testCRC16Template );
+    CPPUNIT_TEST( testCRC24Template );
     CPPUNIT_TEST( testCRC32 );
     CPPUNIT_TEST( testCRC32BZip2 );
     CPPUNIT_TEST( testCRC32C );
+    CPPUNIT_TEST( testCRC32Combine );
+    CPPUNIT_TEST( testCRC32Parallel );
+    CPPUNIT_TEST( testCRC32File );
+    CPPUNIT_TEST( testCRC32Template );
+    CPPUNIT_TEST( testCRC64_ECMA182 );
+    CPPUNIT_TEST( testCRC64_XZ );
+    CPPUNIT_TEST( testCRC64_NVMe );
+    CPPUNIT_TEST( testCRC64Combine );
+    CPPUNIT_TEST( testCRC64Parallel );
+    CPPUNIT_TEST( testCRC64File );
+    CPPUNIT_TEST( testCRC64Template );
+    CPPUNIT_TEST( testCPUFeatures );
+    CPPUNIT_TEST( testCPURestrict );
+    CPPUNIT_TEST( testCPUKernel );
+    CPPUNIT_TEST( testCPUCalibrate );
+    CPPUNIT_TEST( testCPUTiers );
     CPPUNIT_TEST( testMD5 );
+    CPPUNIT_TEST( testMD5Batch );
     CPPUNIT_TEST( testSHA1 );
+    CPPUNIT_TEST( testSHA1Batch );
     CPPUNIT_TEST( testSHA2_224 );
     CPPUNIT_TEST( testSHA2_256 );
+    CPPUNIT_TEST( testSHA2_256Batch );
     CPPUNIT_TEST( testSHA2_384 );
     CPPUNIT_TEST( testSHA2_512 );
+    CPPUNIT_TEST( testSHA2_512Batch );
+    CPPUNIT_TEST( testSHA2_512_224 );
+    CPPUNIT_TEST( testSHA2_512_256 );
 
     CPPUNIT_TEST_SUITE_END( );
 
@@ -76,18 +111,46 @@ public:
 private:
     void runSingleChunk( int testNo, HashingBase &pHash, const char *name, void *data, uint32_t size, uint8_t expected[] );
     void runMultiChunk( int testNo, HashingBase &pHash, const char *name, void *data, uint32_t size, uint32_t chunkSize, uint8_t expected[] );
+    void runBatch( HashingBase &pHash, const char *name, BatchFunction batch );
+    void testCRC8Template( );
     void testCRC16_CCITT( );
     void testCRC16_XModem( );
     void testCRC16_X25( );
+    void testCRC16Combine( );
+    void testCRC16Parallel( );
+    void testCRC16Template( );
+    void testCRC24Template( );
     void testCRC32( );
     void testCRC32BZip2( );
     void testCRC32C( );
+    void testCRC32Combine( );
+    void testCRC32Parallel( );
+    void testCRC32File( );
+    void testCRC32Template( );
+    void testCRC64_ECMA182( );
+    void testCRC64_XZ( );
+    void testCRC64_NVMe( );
+    void testCRC64Combine( );
+    void testCRC64Parallel( );
+    void testCRC64File( );
+    void testCRC64Template( );
+    void testCPUFeatures( );
+    void testCPURestrict( );
+    void testCPUKernel( );
+    void testCPUCalibrate( );
+    void testCPUTiers( );
     void testMD5( );
+    void testMD5Batch( );
     void testSHA1( );
+    void testSHA1Batch( );
     void testSHA2_224( );
     void testSHA2_256( );
+    void testSHA2_256Batch( );
     void testSHA2_384( );
     void testSHA2_512( );
+    void testSHA2_512Batch( );
+    void testSHA2_512_224( );
+    void testSHA2_512_256( );
 
     static TestData testCases[10];
 } ;